@@ -0,0 +1,441 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#define RANDFS_IMPLEMENTATION
+#include "RandFS.h"
+
+// Results are folded into this, so that the compiler cannot remove the calls being measured
+static volatile uint64_t sink = 0ULL;
+
+// Bits of any result, so that every function can be chained into the next call or folded into the sink
+template <typename T>
+static uint64_t Bits(T value)
+{
+	uint64_t bits = 0ULL;
+	std::memcpy(&bits, &value, sizeof(T) < sizeof(bits) ? sizeof(T) : sizeof(bits));
+	return bits;
+}
+
+// Time of one benchmark, in nanoseconds per call
+struct BenchResult
+{
+	std::string name;
+	double throughput = 0.0; // Independent calls, as many in flight as the processor allows
+	double latency = -1.0; // Calls that each take the result of the previous one as input, if the function has an input
+	uint64_t bytesPerCall = 0ULL; // Bytes read by each call, for the functions that hash buffers
+};
+
+static constexpr int Repeat = 5;
+
+// Number of calls for a benchmark that is about 'divisor' times slower per call than a draw, at least one
+static uint64_t ScaledCount(uint64_t count, uint64_t divisor)
+{
+	return count / divisor > 0ULL ? count / divisor : 1ULL;
+}
+
+// Fastest of a few runs of 'count' calls, in nanoseconds per call
+template <typename F>
+static double Measure(uint64_t count, F&& run)
+{
+	double best = -1.0;
+	for (int r = 0; r < Repeat; r++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		run(count);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		const double ns = std::chrono::duration<double, std::nano>(end - start).count() / double(count);
+		if (best < 0.0 || ns < best)
+			best = ns;
+	}
+	return best;
+}
+
+// A function of a counter, such as a hash, measured both on consecutive counters and on its own results
+template <typename F>
+static BenchResult MeasureFunction(const char* name, uint64_t count, F&& f)
+{
+	BenchResult result;
+	result.name = name;
+	result.throughput = Measure(count, [&](uint64_t n)
+	{
+		uint64_t x = 0ULL;
+		for (uint64_t i = 0ULL; i < n; i++)
+			x ^= Bits(f(i));
+		sink = sink ^ x;
+	});
+	result.latency = Measure(count, [&](uint64_t n)
+	{
+		// The counter is mixed in so that the chain cannot get stuck on a value that hashes to itself, such as 0
+		uint64_t x = 0ULL;
+		for (uint64_t i = 0ULL; i < n; i++)
+			x = Bits(f(x + i));
+		sink = sink ^ x;
+	});
+	return result;
+}
+
+// A generator call, which has no input and depends on the previous call through the generator state anyway
+template <typename F>
+static BenchResult MeasureDraw(const char* name, uint64_t count, F&& draw)
+{
+	BenchResult result;
+	result.name = name;
+	result.throughput = Measure(count, [&](uint64_t n)
+	{
+		uint64_t x = 0ULL;
+		for (uint64_t i = 0ULL; i < n; i++)
+			x ^= Bits(draw());
+		sink = sink ^ x;
+	});
+	return result;
+}
+
+// A bulk call, which fills a buffer of FillSize values, timed per value like MeasureDraw
+static constexpr uint32_t FillSize = 1024U;
+template <typename T, typename F>
+static BenchResult MeasureFill(const char* name, uint64_t count, F&& fill)
+{
+	std::vector<T> values(FillSize);
+	BenchResult result;
+	result.name = name;
+	result.throughput = Measure(count, [&](uint64_t n)
+	{
+		uint64_t x = 0ULL;
+		for (uint64_t i = 0ULL; i < n; i += FillSize)
+		{
+			fill(values.data(), FillSize);
+			x ^= Bits(values[i % FillSize]);
+		}
+		sink = sink ^ x;
+	});
+	return result;
+}
+
+#pragma region Build settings
+
+static std::string GetCompilerName()
+{
+	#if defined(__clang__)
+	return std::string("clang ") + __clang_version__;
+	#elif defined(__GNUC__)
+	return std::string("g++ ") + __VERSION__;
+	#elif defined(_MSC_VER)
+	return "msvc " + std::to_string(_MSC_FULL_VER);
+	#else
+	return "unknown";
+	#endif
+}
+
+// Flags that change the generated code, as far as the compiler reveals them through predefined macros
+// Optimization levels above -O1 cannot be told apart, so runs can be labeled with --label instead
+static std::string GetFlagNames()
+{
+	std::string flags;
+	#if defined(__OPTIMIZE__)
+	flags += "-O ";
+	#endif
+	#if defined(__FAST_MATH__)
+	flags += "-ffast-math ";
+	#endif
+	#if defined(__AVX512F__)
+	flags += "avx512f ";
+	#elif defined(__AVX2__)
+	flags += "avx2 ";
+	#elif defined(__SSE4_2__)
+	flags += "sse4.2 ";
+	#endif
+	#if defined(_MSC_VER) && !defined(_DEBUG)
+	flags += "release ";
+	#endif
+
+	if (!flags.empty())
+		flags.pop_back();
+	return flags.empty() ? "none" : flags;
+}
+
+#pragma endregion
+
+static void PrintUsage()
+{
+	std::cout <<
+		"Usage: RandBench [options]\n"
+		"  --count N      Calls of each function per run, the fastest of 5 runs is kept (default: 10000000)\n"
+		"  --label TEXT   Name of the compiler and flags this was built with, such as \"g++ -O3 -march=native\"\n"
+		"                 (default: detected from the predefined macros)\n"
+		"  --csv PATH     Append the results to a CSV file, with one row per function and build, to compare builds\n";
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t count = 10000000ULL;
+	std::string label;
+	const char* csvPath = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		if (!value)
+		{
+			std::cout << "Missing value for " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+
+		if      (std::strcmp(arg, "--count") == 0) count = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(arg, "--label") == 0) label = value;
+		else if (std::strcmp(arg, "--csv") == 0)   csvPath = value;
+		else
+		{
+			std::cout << "Unknown option " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+		i++;
+	}
+
+	if (count == 0ULL)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string compiler = GetCompilerName();
+	const std::string flags = label.empty() ? GetFlagNames() : label;
+	std::cout << "Compiler: " << compiler << "\nFlags: " << flags << "\n" << std::endl;
+
+	std::vector<BenchResult> results;
+
+	// Buffers hashed by the functions that take arrays and strings, with a changing first element so that calls differ
+	std::vector<uint8_t> bytes(1024);
+	std::vector<uint64_t> words(128);
+	std::vector<uint32_t> words32(256);
+	std::string text(1023, 'a');
+	for (size_t i = 0; i < bytes.size(); i++)
+		bytes[i] = uint8_t(Hash::UInt32(uint32_t(i)));
+	for (size_t i = 0; i < words.size(); i++)
+		words[i] = Hash::UInt64(uint64_t(i));
+	for (size_t i = 0; i < words32.size(); i++)
+		words32[i] = Hash::UInt32(uint32_t(i));
+	for (size_t i = 0; i < text.size(); i++)
+		text[i] = char('a' + Hash::UInt32(uint32_t(i)) % 26U);
+	const uint64_t bufferCount = ScaledCount(count, 1000ULL);
+
+	#pragma region Random
+
+	{
+		Random rand(42ULL);
+		results.push_back(MeasureDraw("Random::UInt64", count, [&]() { return rand.UInt64(); }));
+		results.push_back(MeasureDraw("Random::UInt32", count, [&]() { return rand.UInt32(); }));
+		results.push_back(MeasureDraw("Random::DoubleO", count, [&]() { return rand.DoubleO(); }));
+		results.push_back(MeasureDraw("Random::FloatO", count, [&]() { return rand.FloatO(); }));
+		results.push_back(MeasureDraw("Random::FloatBetween", count, [&]() { return rand.FloatBetween(-1.0f, 1.0f); }));
+		results.push_back(MeasureDraw("Random::FloatNormal", count, [&]() { return rand.FloatNormal(); }));
+		results.push_back(MeasureDraw("Random::IntBetween", count, [&]() { return rand.IntBetween(0, 1000); }));
+		results.push_back(MeasureDraw("Random::Bool", count, [&]() { return rand.Bool(); }));
+		results.push_back(MeasureFill<uint64_t>("Random::FillUInt64", count, [&](uint64_t* v, uint32_t n) { rand.FillUInt64(v, n); }));
+		results.push_back(MeasureFill<uint32_t>("Random::FillUInt32", count, [&](uint32_t* v, uint32_t n) { rand.FillUInt32(v, n); }));
+		results.push_back(MeasureFill<float>("Random::FillFloatO", count, [&](float* v, uint32_t n) { rand.FillFloatO(v, n); }));
+		results.push_back(MeasureFill<float>("Random::FillFloatBetween", count, [&](float* v, uint32_t n) { rand.FillFloatBetween(v, n, -1.0f, 1.0f); }));
+		results.push_back(MeasureFill<float>("Random::FillFloatNormal", count, [&](float* v, uint32_t n) { rand.FillFloatNormal(v, n); }));
+		results.push_back(MeasureFill<int32_t>("Random::FillIntBetween", count, [&](int32_t* v, uint32_t n) { rand.FillIntBetween(v, n, 0, 1000); }));
+
+		// Skipping ahead, with a draw to use the result
+		results.push_back(MeasureDraw("Random::Discard(1000) + UInt64", ScaledCount(count, 1000ULL), [&]() { rand.Discard(1000ULL); return rand.UInt64(); }));
+		results.push_back(MeasureDraw("Random::Jump + UInt64", ScaledCount(count, 100000ULL), [&]() { rand.Jump(); return rand.UInt64(); }));
+
+		// Construction is only useful along with a draw, which is included, as it is by the std engines below
+		results.push_back(MeasureFunction("Random(seed) + UInt64", ScaledCount(count, 100ULL), [](uint64_t seed) { Random r(seed); return r.UInt64(); }));
+		results.push_back(MeasureFunction("Random(seed, Lazy) + UInt64", ScaledCount(count, 100ULL), [](uint64_t seed) { Random r(seed, MersenneTwister64::Seeding::Lazy); return r.UInt64(); }));
+	}
+
+	// The other engines, through the same distribution functions
+	{
+		BasicRandom<Xoshiro256> rand(42ULL);
+		results.push_back(MeasureDraw("BasicRandom<Xoshiro256>::UInt64", count, [&]() { return rand.UInt64(); }));
+		results.push_back(MeasureDraw("BasicRandom<Xoshiro256>::FloatNormal", count, [&]() { return rand.FloatNormal(); }));
+		results.push_back(MeasureFill<float>("BasicRandom<Xoshiro256>::FillFloatO", count, [&](float* v, uint32_t n) { rand.FillFloatO(v, n); }));
+		results.push_back(MeasureDraw("BasicRandom<Xoshiro256>::Jump + UInt64", ScaledCount(count, 1000ULL), [&]() { rand.Jump(); return rand.UInt64(); }));
+		results.push_back(MeasureFunction("BasicRandom<Xoshiro256>(seed) + UInt64", ScaledCount(count, 100ULL), [](uint64_t seed) { BasicRandom<Xoshiro256> r(seed); return r.UInt64(); }));
+	}
+
+	{
+		BasicRandom<Pcg64> rand(42ULL);
+		results.push_back(MeasureDraw("BasicRandom<Pcg64>::UInt64", count, [&]() { return rand.UInt64(); }));
+		results.push_back(MeasureDraw("BasicRandom<Pcg64>::FloatNormal", count, [&]() { return rand.FloatNormal(); }));
+		results.push_back(MeasureFill<float>("BasicRandom<Pcg64>::FillFloatO", count, [&](float* v, uint32_t n) { rand.FillFloatO(v, n); }));
+		results.push_back(MeasureDraw("BasicRandom<Pcg64>::Discard(1000) + UInt64", ScaledCount(count, 1000ULL), [&]() { rand.Discard(1000ULL); return rand.UInt64(); }));
+		results.push_back(MeasureFunction("BasicRandom<Pcg64>(seed) + UInt64", ScaledCount(count, 100ULL), [](uint64_t seed) { BasicRandom<Pcg64> r(seed); return r.UInt64(); }));
+	}
+
+	{
+		std::mt19937_64 engine(42ULL);
+		std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+		std::uniform_real_distribution<float> between(-1.0f, 1.0f);
+		std::normal_distribution<float> normal(0.0f, 1.0f);
+		std::uniform_int_distribution<int32_t> integer(0, 999);
+		std::bernoulli_distribution coin(0.5);
+		results.push_back(MeasureDraw("std::mt19937_64", count, [&]() { return engine(); }));
+		results.push_back(MeasureDraw("std::uniform_real_distribution<float>", count, [&]() { return uniform(engine); }));
+		results.push_back(MeasureDraw("std::uniform_real_distribution<float>(-1, 1)", count, [&]() { return between(engine); }));
+		results.push_back(MeasureDraw("std::normal_distribution<float>", count, [&]() { return normal(engine); }));
+		results.push_back(MeasureDraw("std::uniform_int_distribution<int32_t>", count, [&]() { return integer(engine); }));
+		results.push_back(MeasureDraw("std::bernoulli_distribution", count, [&]() { return coin(engine); }));
+		results.push_back(MeasureFunction("std::mt19937_64(seed) + draw", ScaledCount(count, 100ULL), [](uint64_t seed) { std::mt19937_64 e(seed); return e(); }));
+	}
+
+	#pragma endregion
+
+	#pragma region Hash
+
+	results.push_back(MeasureFunction("Hash::UInt64", count, [](uint64_t n) { return Hash::UInt64(n); }));
+	results.push_back(MeasureFunction("Hash::Int64", count, [](uint64_t n) { return Hash::Int64(n); }));
+	results.push_back(MeasureFunction("Hash::PosInt64", count, [](uint64_t n) { return Hash::PosInt64(n); }));
+	results.push_back(MeasureFunction("Hash::UInt32", count, [](uint64_t n) { return Hash::UInt32(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::Int32", count, [](uint64_t n) { return Hash::Int32(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::PosInt32", count, [](uint64_t n) { return Hash::PosInt32(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::DoubleC", count, [](uint64_t n) { return Hash::DoubleC(n); }));
+	results.push_back(MeasureFunction("Hash::DoubleH", count, [](uint64_t n) { return Hash::DoubleH(n); }));
+	results.push_back(MeasureFunction("Hash::DoubleO", count, [](uint64_t n) { return Hash::DoubleO(n); }));
+	results.push_back(MeasureFunction("Hash::FloatC", count, [](uint64_t n) { return Hash::FloatC(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::FloatH", count, [](uint64_t n) { return Hash::FloatH(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::FloatO", count, [](uint64_t n) { return Hash::FloatO(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::UInt8", count, [](uint64_t n) { return Hash::UInt8(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::Bool", count, [](uint64_t n) { return Hash::Bool(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::IntBetween", count, [](uint64_t n) { return Hash::IntBetween(uint32_t(n), 0, 1000); }));
+	results.push_back(MeasureFunction("Hash::FloatBetween", count, [](uint64_t n) { return Hash::FloatBetween(uint32_t(n), -1.0f, 1.0f); }));
+	results.push_back(MeasureFunction("Hash::FloatNormal", count, [](uint64_t n) { return Hash::FloatNormal(uint32_t(n)); }));
+	results.push_back(MeasureFunction("Hash::FloatNormal(mean, stdDev)", count, [](uint64_t n) { return Hash::FloatNormal(uint32_t(n), 2.0f, 0.5f); }));
+
+	// With a seed
+	results.push_back(MeasureFunction("Hash::UInt64(n, seed)", count, [](uint64_t n) { return Hash::UInt64(n, 42ULL); }));
+	results.push_back(MeasureFunction("Hash::UInt32(n, seed)", count, [](uint64_t n) { return Hash::UInt32(uint32_t(n), 42U); }));
+	results.push_back(MeasureFunction("Hash::DoubleO(n, seed)", count, [](uint64_t n) { return Hash::DoubleO(n, 42ULL); }));
+	results.push_back(MeasureFunction("Hash::FloatO(n, seed)", count, [](uint64_t n) { return Hash::FloatO(uint32_t(n), 42U); }));
+	results.push_back(MeasureFunction("Hash::IntBetween(n, seed)", count, [](uint64_t n) { return Hash::IntBetween(uint32_t(n), 42U, 0, 1000); }));
+	results.push_back(MeasureFunction("Hash::FloatNormal(n, seed)", count, [](uint64_t n) { return Hash::FloatNormal(uint32_t(n), 42U); }));
+
+	// Batches of consecutive keys, timed per key like the single calls
+	{
+		uint64_t key = 0ULL;
+		results.push_back(MeasureFill<uint64_t>("Hash::BatchUInt64", count, [&](uint64_t* v, uint32_t n) { Hash::BatchUInt64(key, 1ULL, v, n); key += n; }));
+		results.push_back(MeasureFill<uint32_t>("Hash::BatchUInt32", count, [&](uint32_t* v, uint32_t n) { Hash::BatchUInt32(uint32_t(key), 1U, v, n); key += n; }));
+		results.push_back(MeasureFill<float>("Hash::BatchFloatO", count, [&](float* v, uint32_t n) { Hash::BatchFloatO(uint32_t(key), 1U, v, n); key += n; }));
+		results.push_back(MeasureFill<float>("Hash::BatchFloatNormal", count, [&](float* v, uint32_t n) { Hash::BatchFloatNormal(uint32_t(key), 1U, v, n); key += n; }));
+	}
+
+	// Chains of pairing functions
+	results.push_back(MeasureFunction("Hash::UInt64 (3 values)", count, [](uint64_t n) { return Hash::UInt64(n, 1ULL, 2ULL); }));
+	results.push_back(MeasureFunction("Hash::UInt64 (4 values)", count, [](uint64_t n) { return Hash::UInt64(n, 1ULL, 2ULL, 3ULL); }));
+	results.push_back(MeasureFunction("Hash::UInt64 (8 values)", count, [](uint64_t n) { return Hash::UInt64(n, 1ULL, 2ULL, 3ULL, 4ULL, 5ULL, 6ULL, 7ULL); }));
+	results.push_back(MeasureFunction("Hash::UInt64 (12 values)", count,
+		[](uint64_t n) { return Hash::UInt64(n, 1ULL, 2ULL, 3ULL, 4ULL, 5ULL, 6ULL, 7ULL, 8ULL, 9ULL, 10ULL, 11ULL); }));
+	results.push_back(MeasureFunction("Hash::UInt32 (4 values)", count, [](uint64_t n) { return Hash::UInt32(uint32_t(n), 1U, 2U, 3U); }));
+	results.push_back(MeasureFunction("Hash::Type64(double)", count, [](uint64_t n) { return Hash::Type64(double(n)); }));
+	results.push_back(MeasureFunction("Hash::Type32(float)", count, [](uint64_t n) { return Hash::Type32(float(n)); }));
+
+	// Buffers, with the first element taken from the counter
+	BenchResult array64 = MeasureFunction("Hash::Array64 (1 KB of uint8_t)", bufferCount,
+		[&](uint64_t n) { bytes[0] = uint8_t(n); return Hash::Array64(bytes.data(), uint32_t(bytes.size())); });
+	array64.bytesPerCall = bytes.size();
+	results.push_back(array64);
+
+	BenchResult array64Words = MeasureFunction("Hash::Array64 (1 KB of uint64_t)", bufferCount,
+		[&](uint64_t n) { words[0] = n; return Hash::Array64(words.data(), uint32_t(words.size())); });
+	array64Words.bytesPerCall = words.size() * sizeof(uint64_t);
+	results.push_back(array64Words);
+
+	BenchResult array32 = MeasureFunction("Hash::Array32 (1 KB of uint32_t)", bufferCount,
+		[&](uint64_t n) { words32[0] = uint32_t(n); return Hash::Array32(words32.data(), uint32_t(words32.size())); });
+	array32.bytesPerCall = words32.size() * sizeof(uint32_t);
+	results.push_back(array32);
+
+	BenchResult string64 = MeasureFunction("Hash::String64 (1 KB)", bufferCount,
+		[&](uint64_t n) { text[0] = char('a' + n % 26ULL); return Hash::String64(text.c_str()); });
+	string64.bytesPerCall = text.size();
+	results.push_back(string64);
+
+	BenchResult string32 = MeasureFunction("Hash::String32 (1 KB)", bufferCount,
+		[&](uint64_t n) { text[0] = char('a' + n % 26ULL); return Hash::String32(text.c_str()); });
+	string32.bytesPerCall = text.size();
+	results.push_back(string32);
+
+	BenchResult bytes64 = MeasureFunction("Hash::Bytes64 (1 KB)", bufferCount,
+		[&](uint64_t n) { bytes[0] = uint8_t(n); return Hash::Bytes64(bytes.data(), bytes.size()); });
+	bytes64.bytesPerCall = bytes.size();
+	results.push_back(bytes64);
+
+	// The same bytes in pieces of 100, as a source built in parts would be
+	BenchResult stream64 = MeasureFunction("Hash::Stream64 (1 KB in 100 B updates)", bufferCount,
+		[&](uint64_t n)
+		{
+			bytes[0] = uint8_t(n);
+			Hash::Stream64 stream;
+			for (size_t i = 0; i < bytes.size(); i += 100)
+				stream.Update(&bytes[i], bytes.size() - i < 100 ? bytes.size() - i : 100);
+			return stream.Digest();
+		});
+	stream64.bytesPerCall = bytes.size();
+	results.push_back(stream64);
+
+	// The standard library hash of integers is usually the identity, so strings are the only fair comparison
+	BenchResult stdString = MeasureFunction("std::hash<std::string> (1 KB)", bufferCount,
+		[&](uint64_t n) { text[0] = char('a' + n % 26ULL); return std::hash<std::string>()(text); });
+	stdString.bytesPerCall = text.size();
+	results.push_back(stdString);
+
+	#pragma endregion
+
+	std::printf("%-48s %12s %12s %12s %12s\n", "Function", "ns per call", "M per s", "latency ns", "MB per s");
+	for (const BenchResult& r : results)
+	{
+		std::printf("%-48s %12.3f %12.1f ", r.name.c_str(), r.throughput, 1.0e3 / r.throughput);
+		if (r.latency >= 0.0)
+			std::printf("%12.3f ", r.latency);
+		else
+			std::printf("%12s ", "-");
+		if (r.bytesPerCall > 0ULL)
+			std::printf("%12.1f\n", 1.0e3 * double(r.bytesPerCall) / r.throughput);
+		else
+			std::printf("%12s\n", "-");
+	}
+
+	if (csvPath)
+	{
+		std::error_code error;
+		const bool exists = std::filesystem::exists(csvPath, error);
+
+		std::ofstream file(csvPath, std::ios::app);
+		if (!exists)
+			file << "compiler,flags,function,ns_per_call,latency_ns,megabytes_per_second\n";
+		for (const BenchResult& r : results)
+		{
+			file << "\"" << compiler << "\",\"" << flags << "\",\"" << r.name << "\"," << r.throughput << ","
+				<< (r.latency >= 0.0 ? std::to_string(r.latency) : std::string()) << ","
+				<< (r.bytesPerCall > 0ULL ? std::to_string(1.0e3 * double(r.bytesPerCall) / r.throughput) : std::string()) << "\n";
+		}
+
+		if (!file)
+		{
+			std::cout << "Could not write " << csvPath << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
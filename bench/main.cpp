@@ -0,0 +1,391 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "Shader.h"
+#include "RandFS.h"
+
+#pragma region Allocations
+
+// Every allocation of the program goes through these, so that the benchmark can count the allocations of the generator
+static std::atomic<uint64_t> allocationCount = 0ULL;
+static std::atomic<uint64_t> allocatedBytes = 0ULL;
+
+void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1ULL, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(uint64_t(size), std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+#pragma endregion
+
+// Results of generating the whole corpus at one depth
+struct DepthResult
+{
+	int depth = 0;
+	double milliseconds = 0.0; // Fastest of the repeats
+	GenerationProfile profile; // Phases of the fastest repeat
+	uint64_t allocations = 0ULL;
+	uint64_t allocatedBytes = 0ULL;
+	uint64_t nodes = 0ULL; // Nodes of every expression, including the templates that were instantiated
+	uint64_t outputBytes = 0ULL; // Size of every shader source
+	uint64_t outputHash = 0ULL; // Hash of every shader source, which changes if the generator generates anything differently
+};
+
+static void PrintUsage()
+{
+	std::cout <<
+		"Usage: PollockBench [options]\n"
+		"  --seed N       First seed of the corpus (default: 0)\n"
+		"  --seeds N      Number of consecutive seeds in the corpus (default: 100)\n"
+		"  --min-depth N  Smallest maximum depth the seeds are generated with (default: 3)\n"
+		"  --max-depth N  Largest maximum depth the seeds are generated with (default: 14)\n"
+		"  --repeat N     Times the corpus is generated at each depth, keeping the fastest (default: 5)\n"
+		"  --json PATH    Write the results as JSON\n"
+		"  --csv PATH     Write the results as CSV, which can be used as a baseline later\n"
+		"  --baseline PATH  Compare with the CSV of an earlier run, and fail if anything is slower, allocates more or generates\n"
+		"                 different shaders\n"
+		"  --tolerance F  Fraction by which time and allocations may exceed the baseline (default: 0.1)\n";
+}
+
+static std::string ToHex(uint64_t value)
+{
+	char text[32];
+	std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+	return text;
+}
+
+static DepthResult BenchmarkDepth(uint64_t firstSeed, uint64_t seedCount, int depth, int repeat)
+{
+	DepthResult result;
+	result.depth = depth;
+	result.milliseconds = -1.0;
+
+	// The sources of the first repeat are kept and hashed after it is timed, so hashing does not count as generation
+	std::vector<std::string> sources;
+	sources.reserve(size_t(seedCount));
+
+	for (int r = 0; r < repeat; r++)
+	{
+		GenerationProfile profile;
+		uint64_t nodes = 0ULL;
+		uint64_t outputBytes = 0ULL;
+		Expression expression;
+
+		const uint64_t allocationsBefore = allocationCount.load();
+		const uint64_t bytesBefore = allocatedBytes.load();
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (uint64_t s = 0ULL; s < seedCount; s++)
+		{
+			std::string code = GenerateShaderCodeProfiled(firstSeed + s, depth, profile, &expression);
+			nodes += expression.nodes.size();
+			outputBytes += code.size();
+			if (r == 0)
+				sources.push_back(std::move(code));
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+		// Everything but the time is the same on every repeat
+		if (r == 0)
+		{
+			result.allocations = allocationCount.load() - allocationsBefore;
+			result.allocatedBytes = allocatedBytes.load() - bytesBefore;
+			result.nodes = nodes;
+			result.outputBytes = outputBytes;
+
+			uint64_t outputHash = 0ULL;
+			for (const std::string& code : sources)
+				outputHash = Hash::UInt64(outputHash, Hash::Array64(reinterpret_cast<const uint8_t*>(code.data()), uint32_t(code.size())), uint64_t(code.size()));
+			result.outputHash = outputHash;
+			sources.clear();
+		}
+		if (result.milliseconds < 0.0 || ms < result.milliseconds)
+		{
+			result.milliseconds = ms;
+			result.profile = profile;
+		}
+	}
+
+	return result;
+}
+
+#pragma region Output
+
+static constexpr char CsvHeader[] = "depth,first_seed,seeds,milliseconds,mask_ms,expansion_ms,constants_ms,program_ms,source_ms,"
+	"allocations,allocated_bytes,nodes,output_bytes,output_hash";
+
+static bool WriteCsv(const char* path, uint64_t firstSeed, uint64_t seedCount, const std::vector<DepthResult>& results)
+{
+	std::ofstream file(path);
+	file << CsvHeader << "\n";
+	for (const DepthResult& r : results)
+	{
+		file << r.depth << "," << firstSeed << "," << seedCount << "," << r.milliseconds << ","
+			<< 1.0e-6 * r.profile.maskNanoseconds << "," << 1.0e-6 * r.profile.expansionNanoseconds << "," << 1.0e-6 * r.profile.constantNanoseconds << ","
+			<< 1.0e-6 * r.profile.programNanoseconds << "," << 1.0e-6 * r.profile.sourceNanoseconds << ","
+			<< r.allocations << "," << r.allocatedBytes << "," << r.nodes << "," << r.outputBytes << "," << ToHex(r.outputHash) << "\n";
+	}
+	return bool(file);
+}
+
+static bool WriteJson(const char* path, uint64_t firstSeed, uint64_t seedCount, int repeat, const std::vector<DepthResult>& results)
+{
+	std::ofstream file(path);
+	file << "{\n\t\"firstSeed\": " << firstSeed << ",\n\t\"seeds\": " << seedCount << ",\n\t\"repeat\": " << repeat << ",\n\t\"depths\":\n\t[\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const DepthResult& r = results[i];
+		file << "\t\t{\n"
+			<< "\t\t\t\"depth\": " << r.depth << ",\n"
+			<< "\t\t\t\"milliseconds\": " << r.milliseconds << ",\n"
+			<< "\t\t\t\"phases\": { \"mask\": " << 1.0e-6 * r.profile.maskNanoseconds
+			<< ", \"expansion\": " << 1.0e-6 * r.profile.expansionNanoseconds
+			<< ", \"constants\": " << 1.0e-6 * r.profile.constantNanoseconds
+			<< ", \"program\": " << 1.0e-6 * r.profile.programNanoseconds
+			<< ", \"source\": " << 1.0e-6 * r.profile.sourceNanoseconds << " },\n"
+			<< "\t\t\t\"allocations\": " << r.allocations << ",\n"
+			<< "\t\t\t\"allocatedBytes\": " << r.allocatedBytes << ",\n"
+			<< "\t\t\t\"nodes\": " << r.nodes << ",\n"
+			<< "\t\t\t\"outputBytes\": " << r.outputBytes << ",\n"
+			<< "\t\t\t\"outputHash\": \"" << ToHex(r.outputHash) << "\"\n"
+			<< "\t\t}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	file << "\t]\n}\n";
+	return bool(file);
+}
+
+#pragma endregion
+
+#pragma region Baseline
+
+// Row of a baseline CSV, with only the columns that are compared
+struct BaselineRow
+{
+	int depth = 0;
+	uint64_t firstSeed = 0ULL;
+	uint64_t seeds = 0ULL;
+	double milliseconds = 0.0;
+	uint64_t allocations = 0ULL;
+	uint64_t outputHash = 0ULL;
+};
+
+static bool ReadBaseline(const char* path, std::vector<BaselineRow>& rows)
+{
+	std::ifstream file(path);
+	std::string line;
+	if (!std::getline(file, line) || line != CsvHeader)
+		return false;
+
+	while (std::getline(file, line))
+	{
+		std::vector<std::string> fields;
+		std::stringstream stream(line);
+		std::string field;
+		while (std::getline(stream, field, ','))
+			fields.push_back(field);
+		if (fields.size() != 14)
+			return false;
+
+		BaselineRow row;
+		row.depth = std::atoi(fields[0].c_str());
+		row.firstSeed = std::strtoull(fields[1].c_str(), nullptr, 10);
+		row.seeds = std::strtoull(fields[2].c_str(), nullptr, 10);
+		row.milliseconds = std::atof(fields[3].c_str());
+		row.allocations = std::strtoull(fields[9].c_str(), nullptr, 10);
+		row.outputHash = std::strtoull(fields[13].c_str(), nullptr, 16);
+		rows.push_back(row);
+	}
+	return true;
+}
+
+// Print every difference that counts as a regression, and return how many there were
+static int CompareWithBaseline(const std::vector<BaselineRow>& baseline, uint64_t firstSeed, uint64_t seedCount,
+	const std::vector<DepthResult>& results, double tolerance)
+{
+	int regressions = 0;
+	for (const DepthResult& r : results)
+	{
+		const BaselineRow* row = nullptr;
+		for (const BaselineRow& candidate : baseline)
+			if (candidate.depth == r.depth && candidate.firstSeed == firstSeed && candidate.seeds == seedCount)
+				row = &candidate;
+
+		if (!row)
+		{
+			std::cout << "  Depth " << r.depth << ": not in the baseline for this corpus" << std::endl;
+			continue;
+		}
+
+		if (r.outputHash != row->outputHash)
+		{
+			std::cout << "  Depth " << r.depth << ": REGRESSION, generates different shaders than the baseline" << std::endl;
+			regressions++;
+		}
+		if (r.milliseconds > row->milliseconds * (1.0 + tolerance))
+		{
+			std::cout << "  Depth " << r.depth << ": REGRESSION, " << r.milliseconds << " ms instead of " << row->milliseconds << " ms" << std::endl;
+			regressions++;
+		}
+		if (double(r.allocations) > double(row->allocations) * (1.0 + tolerance))
+		{
+			std::cout << "  Depth " << r.depth << ": REGRESSION, " << r.allocations << " allocations instead of " << row->allocations << std::endl;
+			regressions++;
+		}
+	}
+	return regressions;
+}
+
+#pragma endregion
+
+int main(int argc, char** argv)
+{
+	uint64_t firstSeed = 0ULL;
+	uint64_t seedCount = 100ULL;
+	int minDepth = 3;
+	int maxDepth = 14;
+	int repeat = 5;
+	const char* jsonPath = nullptr;
+	const char* csvPath = nullptr;
+	const char* baselinePath = nullptr;
+	double tolerance = 0.1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		if (!value)
+		{
+			std::cout << "Missing value for " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+
+		if      (std::strcmp(arg, "--seed") == 0)      firstSeed = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(arg, "--seeds") == 0)     seedCount = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(arg, "--min-depth") == 0) minDepth = std::atoi(value);
+		else if (std::strcmp(arg, "--max-depth") == 0) maxDepth = std::atoi(value);
+		else if (std::strcmp(arg, "--repeat") == 0)    repeat = std::atoi(value);
+		else if (std::strcmp(arg, "--json") == 0)      jsonPath = value;
+		else if (std::strcmp(arg, "--csv") == 0)       csvPath = value;
+		else if (std::strcmp(arg, "--baseline") == 0)  baselinePath = value;
+		else if (std::strcmp(arg, "--tolerance") == 0) tolerance = std::atof(value);
+		else
+		{
+			std::cout << "Unknown option " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+		i++;
+	}
+
+	if (seedCount == 0ULL || minDepth < 1 || maxDepth < minDepth || repeat <= 0 || tolerance < 0.0)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// Read before running, so that a missing baseline does not waste a whole run
+	std::vector<BaselineRow> baseline;
+	if (baselinePath && !ReadBaseline(baselinePath, baseline))
+	{
+		std::cout << "Could not read the baseline " << baselinePath << std::endl;
+		return 1;
+	}
+
+	// The templates of the generator are parsed on the first call, which is not part of any measurement
+	{
+		GenerationProfile warmUp;
+		GenerateShaderCodeProfiled(firstSeed, minDepth, warmUp);
+	}
+
+	std::cout << "Generating seeds " << firstSeed << " to " << firstSeed + seedCount - 1ULL << ", fastest of " << repeat << std::endl;
+
+	std::vector<DepthResult> results;
+	for (int depth = minDepth; depth <= maxDepth; depth++)
+	{
+		const DepthResult r = BenchmarkDepth(firstSeed, seedCount, depth, repeat);
+		results.push_back(r);
+
+		const double perSeed = 1.0e3 * r.milliseconds / double(seedCount);
+		const double total = r.profile.TotalNanoseconds() > 0.0 ? r.profile.TotalNanoseconds() : 1.0;
+		std::cout << "  Depth " << r.depth << ": " << perSeed << " us per seed ("
+			<< int(100.0 * r.profile.maskNanoseconds / total + 0.5) << "% mask, "
+			<< int(100.0 * r.profile.expansionNanoseconds / total + 0.5) << "% expansion, "
+			<< int(100.0 * r.profile.constantNanoseconds / total + 0.5) << "% constants, "
+			<< int(100.0 * r.profile.programNanoseconds / total + 0.5) << "% program, "
+			<< int(100.0 * r.profile.sourceNanoseconds / total + 0.5) << "% source), "
+			<< r.nodes / seedCount << " nodes, " << r.outputBytes / seedCount << " bytes, "
+			<< r.allocations / seedCount << " allocations per seed" << std::endl;
+	}
+
+	if (jsonPath && !WriteJson(jsonPath, firstSeed, seedCount, repeat, results))
+	{
+		std::cout << "Could not write " << jsonPath << std::endl;
+		return 1;
+	}
+	if (csvPath && !WriteCsv(csvPath, firstSeed, seedCount, results))
+	{
+		std::cout << "Could not write " << csvPath << std::endl;
+		return 1;
+	}
+
+	if (baselinePath)
+	{
+		std::cout << "Comparing with " << baselinePath << std::endl;
+		const int regressions = CompareWithBaseline(baseline, firstSeed, seedCount, results, tolerance);
+		if (regressions > 0)
+		{
+			std::cout << regressions << " regressions" << std::endl;
+			return 1;
+		}
+		std::cout << "No regressions" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,408 @@
+#include <iostream>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "Shader.h"
+#include "CpuRenderer.h"
+#include "Jit.h"
+#include "X64Kernel.h"
+#include "Image.h"
+#include "FrameCache.h"
+#include "KernelCache.h"
+#include "SeedPipeline.h"
+#include "TierStats.h"
+
+// Everything needed to render a seed, which can be done ahead of time on other threads
+struct PreparedSeed
+{
+	Expression expression;
+	std::unique_ptr<CpuRenderer> renderer;
+	// The kernels must outlive every render that uses them
+	std::unique_ptr<JitKernel> kernel;
+	std::unique_ptr<X64Kernel> x64Kernel;
+	std::unique_ptr<BackgroundJitKernel> tieredKernel; // Replaces block evaluation between frames once it is compiled
+	std::string error; // Why the seed cannot be rendered, if it cannot
+};
+
+static void PrintUsage()
+{
+	std::cout <<
+		"Usage: PollockRender [options]\n"
+		"  --seed N       First seed to render (default: current time, like the interactive program)\n"
+		"  --count N      Number of consecutive seeds to render (default: 1)\n"
+		"  --width N      Image width in pixels (default: 1600)\n"
+		"  --height N     Image height in pixels (default: 900)\n"
+		"  --time T       Animation time in seconds (default: 0)\n"
+		"  --threads N    Number of render threads, 0 for all cores (default: 0)\n"
+		"  --tile WxH     Size of the tiles handed out to the render threads (default: 64x16)\n"
+		"  --order O      Order of the tiles, rows, morton or hilbert (default: hilbert)\n"
+		"  --stats        Print the time each thread spent rendering\n"
+		"  --simd S       Instruction set, scalar, sse4.2, avx2 or avx512 (default: fastest supported)\n"
+		"  --backend B    block (evaluate the expression in blocks of pixels), jit (compile it with the system C++ compiler)\n"
+		"                 or x64 (generate AVX2 machine code directly), or tiered (start with block and switch to jit\n"
+		"                 between frames once it is compiled, unless its first frame is slower) (default: block)\n"
+		"  --cxx PATH     Compiler used by the jit backend (default: $CXX, or c++)\n"
+		"  --jit-flags F  Compiler flags used by the jit backend (default: -O3 -march=native -ffast-math)\n"
+		"  --max-cost C   Generate the expression of a seed again, from seeds derived from it, while its estimated cost per pixel\n"
+		"                 is over C, so that a seed and a budget always give the same image (default: no limit)\n"
+		"  --frame-budget MS  Same as --max-cost, with the cost estimated to render a frame in MS milliseconds at the given size\n"
+		"                 and thread count\n"
+		"  --prefetch K   Generate and compile up to K seeds ahead on background threads while rendering (default: 0)\n"
+		"  --prefetch-threads N  Number of threads preparing seeds ahead (default: 1)\n"
+		"  --kernel-cache DIR  Directory where the jit backend keeps compiled kernels between runs, or none\n"
+		"                 (default: pollock_kernels in the system temporary directory)\n"
+		"  --format F     Output format, ppm (8 bits per channel) or pfm (float) (default: ppm)\n"
+		"  --out PREFIX   Output file prefix, the seed and extension are appended (default: pollock)\n"
+		"  --loop N       Render N keyframes of the animation loop into a frame cache, or reuse the cache if it exists,\n"
+		"                 and write the frame at --time from the cache (ppm only)\n"
+		"  --cache DIR    Directory of the frame caches (default: current directory)\n"
+		"  --interpolate  Blend the two keyframes around --time instead of taking the nearest one\n";
+}
+
+int main(int argc, char** argv)
+{
+	auto now = std::chrono::high_resolution_clock::now();
+	uint64_t seed = std::chrono::time_point_cast<std::chrono::microseconds>(now).time_since_epoch().count();
+	uint64_t count = 1ULL;
+	int width = 1600;
+	int height = 900;
+	float time = 0.0f;
+	int threads = 0;
+	TileSettings tiles;
+	bool stats = false;
+	SimdLevel simd = DetectSimdLevel();
+	std::string backend = "block";
+	JitOptions jitOptions;
+	jitOptions.cacheDirectory = KernelCache::GetDefaultDirectory();
+	std::string format = "ppm";
+	std::string out = "pollock";
+	int loopFrames = 0;
+	std::string cacheDirectory;
+	bool interpolate = false;
+	int prefetch = 0;
+	int prefetchThreads = 1;
+	float maxCost = 0.0f;
+	double frameBudget = 0.0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+		{
+			PrintUsage();
+			return 0;
+		}
+		if (std::strcmp(arg, "--stats") == 0)
+		{
+			stats = true;
+			continue;
+		}
+		if (std::strcmp(arg, "--interpolate") == 0)
+		{
+			interpolate = true;
+			continue;
+		}
+		if (!value)
+		{
+			std::cout << "Missing value for " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+
+		if      (std::strcmp(arg, "--seed") == 0)    seed = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(arg, "--count") == 0)   count = std::strtoull(value, nullptr, 10);
+		else if (std::strcmp(arg, "--width") == 0)   width = std::atoi(value);
+		else if (std::strcmp(arg, "--height") == 0)  height = std::atoi(value);
+		else if (std::strcmp(arg, "--time") == 0)    time = float(std::atof(value));
+		else if (std::strcmp(arg, "--threads") == 0) threads = std::atoi(value);
+		else if (std::strcmp(arg, "--tile") == 0)
+		{
+			if (std::sscanf(value, "%dx%d", &tiles.width, &tiles.height) != 2 || tiles.width <= 0 || tiles.height <= 0)
+			{
+				std::cout << "Invalid tile size " << value << std::endl;
+				return 1;
+			}
+		}
+		else if (std::strcmp(arg, "--order") == 0)
+		{
+			bool found = false;
+			for (TileOrder order : { TileOrder::Rows, TileOrder::Morton, TileOrder::Hilbert })
+			{
+				if (std::strcmp(value, GetTileOrderName(order)) == 0)
+				{
+					tiles.order = order;
+					found = true;
+				}
+			}
+			if (!found)
+			{
+				std::cout << "Unknown tile order " << value << std::endl;
+				return 1;
+			}
+		}
+		else if (std::strcmp(arg, "--simd") == 0)
+		{
+			bool found = false;
+			for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512 })
+			{
+				if (std::strcmp(value, GetSimdLevelName(level)) == 0 && level <= DetectSimdLevel())
+				{
+					simd = level;
+					found = true;
+				}
+			}
+			if (!found)
+			{
+				std::cout << "Instruction set " << value << " is not supported" << std::endl;
+				return 1;
+			}
+		}
+		else if (std::strcmp(arg, "--backend") == 0) backend = value;
+		else if (std::strcmp(arg, "--cxx") == 0)     jitOptions.compiler = value;
+		else if (std::strcmp(arg, "--jit-flags") == 0) jitOptions.flags = value;
+		else if (std::strcmp(arg, "--max-cost") == 0) maxCost = float(std::atof(value));
+		else if (std::strcmp(arg, "--frame-budget") == 0) frameBudget = std::atof(value);
+		else if (std::strcmp(arg, "--prefetch") == 0) prefetch = std::atoi(value);
+		else if (std::strcmp(arg, "--prefetch-threads") == 0) prefetchThreads = std::atoi(value);
+		else if (std::strcmp(arg, "--kernel-cache") == 0) jitOptions.cacheDirectory = std::strcmp(value, "none") == 0 ? "" : value;
+		else if (std::strcmp(arg, "--format") == 0)  format = value;
+		else if (std::strcmp(arg, "--out") == 0)     out = value;
+		else if (std::strcmp(arg, "--loop") == 0)    loopFrames = std::atoi(value);
+		else if (std::strcmp(arg, "--cache") == 0)   cacheDirectory = value;
+		else
+		{
+			std::cout << "Unknown option " << arg << std::endl;
+			PrintUsage();
+			return 1;
+		}
+		i++;
+	}
+
+	if (width <= 0 || height <= 0 || (format != "ppm" && format != "pfm") || (backend != "block" && backend != "jit" && backend != "x64" && backend != "tiered")
+		|| loopFrames < 0 || (loopFrames > 0 && format != "ppm") || prefetch < 0 || prefetchThreads <= 0
+		|| maxCost < 0.0f || frameBudget < 0.0)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const FrameInputs frame = FrameInputs::AtTime(time);
+	std::vector<uint8_t> rgba;
+	std::vector<float> rgb;
+
+	// The render threads are started once for all seeds
+	ThreadPool pool(threads);
+
+	// A frame budget only depends on the size and thread count, so it selects the same expressions every run
+	if (frameBudget > 0.0)
+		maxCost = GetFrameCostBudget(frameBudget, width, height, pool.ThreadCount());
+
+	// Generate the expression, build the renderer and compile the kernel of a seed
+	auto prepare = [&](uint64_t currentSeed)
+	{
+		PreparedSeed prepared;
+		prepared.expression = GenerateExpression(currentSeed, maxCost);
+		prepared.renderer = std::make_unique<CpuRenderer>(prepared.expression, pool);
+		prepared.renderer->SetSimdLevel(simd);
+		prepared.renderer->SetTileSettings(tiles);
+
+		if (backend == "jit")
+		{
+			prepared.kernel = std::make_unique<JitKernel>(prepared.expression, jitOptions);
+			if (!prepared.kernel->GetRowFunction())
+				prepared.error = prepared.kernel->GetError();
+			prepared.renderer->SetRowFunction(prepared.kernel->GetRowFunction());
+		}
+		else if (backend == "tiered")
+			prepared.tieredKernel = std::make_unique<BackgroundJitKernel>(prepared.expression, jitOptions);
+		else if (backend == "x64")
+		{
+			prepared.x64Kernel = std::make_unique<X64Kernel>(prepared.expression);
+			if (!prepared.x64Kernel->GetRowFunction())
+				prepared.error = prepared.x64Kernel->GetError();
+			prepared.renderer->SetRowFunction(prepared.x64Kernel->GetRowFunction(), prepared.x64Kernel->GetContext());
+		}
+
+		return prepared;
+	};
+
+	// With prefetching, the next seeds are prepared while the current one renders
+	std::unique_ptr<SeedPipeline<PreparedSeed>> pipeline;
+	if (prefetch > 0)
+		pipeline = std::make_unique<SeedPipeline<PreparedSeed>>(seed, count, prefetch, prefetchThreads, prepare);
+
+	for (uint64_t i = 0ULL; i < count; i++)
+	{
+		auto prepareStart = std::chrono::high_resolution_clock::now();
+
+		uint64_t currentSeed = seed + i;
+		PreparedSeed prepared = pipeline ? pipeline->Next(currentSeed) : prepare(currentSeed);
+		if (!prepared.error.empty())
+		{
+			std::cout << prepared.error << std::endl;
+			return 1;
+		}
+
+		auto prepareEnd = std::chrono::high_resolution_clock::now();
+		double prepareMs = std::chrono::duration<double, std::milli>(prepareEnd - prepareStart).count();
+
+		const std::string path = out + "_" + std::to_string(currentSeed) + "." + format;
+		const Expression& expression = prepared.expression;
+		CpuRenderer& renderer = *prepared.renderer;
+		const JitKernel* kernel = prepared.kernel.get();
+		const X64Kernel* x64Kernel = prepared.x64Kernel.get();
+
+		// With the tiered backend, frames are evaluated in blocks (tier 0) until the jit kernel (tier 1) is compiled
+		// The renderer only switches between frames, when no thread is using it
+		// The jit kernel does not hoist the values that depend on a single coordinate, so it can be slower than the blocks,
+		// and its first frame is timed against those of tier 0 to go back to the blocks when it is
+		int tier = 0;
+		bool jitRejected = false;
+		TierStats tierStats[2];
+		auto renderFrame = [&](FrameInputs inputs, auto* pixels)
+		{
+			const JitKernel* compiled = prepared.tieredKernel ? prepared.tieredKernel->TryGet() : nullptr;
+			if (tier == 0 && !jitRejected && tierStats[0].frames > 0 && compiled && compiled->GetRowFunction())
+			{
+				renderer.SetRowFunction(compiled->GetRowFunction());
+				kernel = compiled;
+				tier = 1;
+			}
+
+			auto frameStart = std::chrono::high_resolution_clock::now();
+			renderer.Render(width, height, inputs, pixels);
+			auto frameEnd = std::chrono::high_resolution_clock::now();
+
+			const double frameMs = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+			tierStats[tier].AddFrame(std::chrono::duration<double, std::milli>(frameEnd - prepareStart).count(), frameMs);
+
+			if (tier == 1 && tierStats[1].frames == 1 && frameMs > tierStats[0].AverageFrameMilliseconds())
+			{
+				renderer.SetRowFunction(nullptr);
+				tier = 0;
+				jitRejected = true;
+			}
+		};
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// Frames rendered for this image, none if it came from an existing loop cache
+		int renderedFrames = 1;
+		std::string cachePath;
+
+		if (loopFrames > 0)
+		{
+			// With a budget, the seed may render another expression, which is identified by the seed it was generated from
+			const FrameCacheKey key = { maxCost > 0.0f ? expression.seed : currentSeed, width, height, loopFrames };
+			cachePath = GetFrameCachePath(cacheDirectory, key);
+			rgba.resize(4 * size_t(width) * size_t(height));
+
+			auto cache = std::make_unique<FrameCache>(cachePath);
+			renderedFrames = 0;
+			if (!cache->IsValid() || !(cache->GetKey() == key))
+			{
+				FrameCacheWriter writer(cachePath, key);
+				for (int k = 0; k < loopFrames; k++)
+				{
+					renderFrame(FrameInputs::AtTime(GetKeyframeTime(k, loopFrames)), rgba.data());
+					if (!writer.WriteFrame(rgba.data()))
+						break;
+				}
+				if (!writer.Finish())
+				{
+					std::cout << writer.GetError() << std::endl;
+					return 1;
+				}
+				renderedFrames = loopFrames;
+
+				cache = std::make_unique<FrameCache>(cachePath);
+				if (!cache->IsValid())
+				{
+					std::cout << cache->GetError() << std::endl;
+					return 1;
+				}
+			}
+
+			cache->SampleFrame(time, interpolate, rgba.data());
+		}
+		else if (format == "ppm")
+		{
+			rgba.resize(4 * size_t(width) * size_t(height));
+			renderFrame(frame, rgba.data());
+		}
+		else
+		{
+			rgb.resize(3 * size_t(width) * size_t(height));
+			renderFrame(frame, rgb.data());
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+		// Time per pixel on a single thread, to compare backends regardless of the thread count
+		double nsPerPixel = 1.0e6 * ms * renderer.ThreadCount() / (double(width) * double(height) * std::max(renderedFrames, 1));
+
+		bool ok = format == "ppm"
+			? WritePPM(path.c_str(), width, height, rgba.data())
+			: WritePFM(path.c_str(), width, height, rgb.data());
+
+		if (!ok)
+		{
+			std::cout << "Could not write " << path << std::endl;
+			return 1;
+		}
+
+		std::cout << "Shader seed: " << expression.seed << " -> " << path << " (" << renderer.RegisterCount() << " nodes, "
+			<< renderer.GetProgram().sharedCount << " shared, " << renderer.GetProgram().simplifiedCount << " simplified, cost " << int(EstimateCost(renderer.GetProgram()) + 0.5f) << ", ";
+		if (backend == "block")
+			std::cout << renderer.GetBlockProgram().pixels.code.size() << " per pixel, ";
+		if (pipeline)
+			std::cout << "waited " << prepareMs << " ms for prefetch, ";
+		if (kernel)
+			std::cout << (kernel->FromCache() ? "loaded from cache in " : "compiled in ") << kernel->CompileMilliseconds() << " ms, ";
+		if (x64Kernel)
+			std::cout << "generated " << x64Kernel->CodeSize() << " bytes in " << x64Kernel->CompileMicroseconds() << " us, ";
+		if (loopFrames > 0 && renderedFrames == 0)
+			std::cout << "sampled from " << cachePath << " in " << ms << " ms)" << std::endl;
+		else if (loopFrames > 0)
+			std::cout << loopFrames << " frames cached in " << cachePath << ", rendered in " << ms << " ms, " << nsPerPixel << " ns per pixel per thread)" << std::endl;
+		else
+			std::cout << "rendered in " << ms << " ms, " << nsPerPixel << " ns per pixel per thread)" << std::endl;
+
+		if (prepared.tieredKernel)
+		{
+			static const char* const tierNames[2] = { "block", "jit" };
+			for (int t = 0; t < 2; t++)
+			{
+				std::cout << "  Tier " << t << " (" << tierNames[t] << "): ";
+				if (tierStats[t].frames == 0)
+					std::cout << (t == 0 ? "no frames" : "not compiled before the last frame") << std::endl;
+				else
+					std::cout << "first pixel after " << tierStats[t].firstPixelMilliseconds << " ms, " << tierStats[t].frames << " frames, "
+						<< tierStats[t].AverageFrameMilliseconds() << " ms per frame" << std::endl;
+			}
+			if (jitRejected)
+				std::cout << "  Tier 1 was slower than tier 0 on its first frame, so the other frames were evaluated in blocks" << std::endl;
+		}
+
+		if (stats)
+		{
+			for (int t = 0; t < pool.ThreadCount(); t++)
+			{
+				const ThreadStats& thread = pool.GetStats()[t];
+				std::cout << "  Thread " << t << ": " << int(100.0 * pool.Utilization(t) + 0.5) << "% busy, "
+					<< thread.tasks << " tiles (" << thread.stolenTasks << " stolen)" << std::endl;
+			}
+		}
+	}
+
+	return 0;
+}
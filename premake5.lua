@@ -13,6 +13,21 @@ workspace "ProceduralPollock"
 
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
+-- Each SIMD file is compiled for its own instruction set, and the right one is selected at runtime
+function simdbuildoptions()
+	filter { "files:src/SimdSSE42.cpp", "toolset:not msc*" }
+		buildoptions "-msse4.2"
+	filter { "files:src/SimdAVX2.cpp", "toolset:not msc*" }
+		buildoptions "-mavx2"
+	filter { "files:src/SimdAVX512.cpp", "toolset:not msc*" }
+		buildoptions "-mavx512f"
+	filter { "files:src/SimdAVX2.cpp", "toolset:msc*" }
+		buildoptions "/arch:AVX2"
+	filter { "files:src/SimdAVX512.cpp", "toolset:msc*" }
+		buildoptions "/arch:AVX512"
+	filter {}
+end
+
 -- Project
 project "ProceduralPollock"
 	kind "ConsoleApp"
@@ -49,6 +64,195 @@ project "ProceduralPollock"
 		"d3dcompiler"
 	}
 	
+	simdbuildoptions()
+	
+	filter "system:windows"
+		systemversion "latest"
+		defines "UNICODE"
+	
+	filter "configurations:Debug"
+		defines "_DEBUG"
+		runtime "Debug"
+		symbols "On"
+	
+	filter "configurations:Profile"
+		defines "_PROFILE"
+		runtime "Release"
+		symbols "On"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+		
+	filter "configurations:Release"
+		defines "_RELEASE"
+		runtime "Release"
+		symbols "Off"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+
+-- Headless CPU renderer
+project "PollockRender"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "On"
+	floatingpoint "Fast"
+	flags { "MultiProcessorCompile" }
+
+	targetdir("bin/output/" .. outputdir .. "/%{prj.name}")
+	objdir("bin/intermediates/" .. outputdir .. "/%{prj.name}")
+	
+	files
+	{
+		-- Source files
+		"cli/**.cpp",
+		"src/Expression.h",
+		"src/Expression.cpp",
+		"src/Shader.h",
+		"src/Shader.cpp",
+		"src/RandFS.h",
+		"src/Primitives.h",
+		"src/Program.h",
+		"src/Program.cpp",
+		"src/CpuRenderer.h",
+		"src/CpuRenderer.cpp",
+		"src/Scheduler.h",
+		"src/Scheduler.cpp",
+		"src/Simd.h",
+		"src/Simd.cpp",
+		"src/SimdKernels.inl",
+		"src/SimdSSE42.cpp",
+		"src/SimdAVX2.cpp",
+		"src/SimdAVX512.cpp",
+		"src/Jit.h",
+		"src/Jit.cpp",
+		"src/X64Kernel.h",
+		"src/X64Kernel.cpp",
+		"src/Image.h",
+		"src/Image.cpp",
+		"src/FrameCache.h",
+		"src/FrameCache.cpp",
+		"src/KernelCache.h",
+		"src/KernelCache.cpp",
+		"src/SeedPipeline.h",
+		"src/TierStats.h"
+	}
+	
+	includedirs
+	{
+		"src"
+	}
+	
+	simdbuildoptions()
+	
+	filter "system:windows"
+		systemversion "latest"
+		defines "UNICODE"
+	
+	filter "system:linux"
+		links { "pthread", "dl" }
+	
+	filter "configurations:Debug"
+		defines "_DEBUG"
+		runtime "Debug"
+		symbols "On"
+	
+	filter "configurations:Profile"
+		defines "_PROFILE"
+		runtime "Release"
+		symbols "On"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+		
+	filter "configurations:Release"
+		defines "_RELEASE"
+		runtime "Release"
+		symbols "Off"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+
+-- Benchmark of the expression generator
+project "PollockBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "On"
+	floatingpoint "Fast"
+	flags { "MultiProcessorCompile" }
+
+	targetdir("bin/output/" .. outputdir .. "/%{prj.name}")
+	objdir("bin/intermediates/" .. outputdir .. "/%{prj.name}")
+	
+	files
+	{
+		-- Source files
+		"bench/main.cpp",
+		"src/Expression.h",
+		"src/Expression.cpp",
+		"src/Shader.h",
+		"src/Shader.cpp",
+		"src/RandFS.h",
+		"src/Primitives.h",
+		"src/Program.h",
+		"src/Program.cpp"
+	}
+	
+	includedirs
+	{
+		"src"
+	}
+	
+	filter "system:windows"
+		systemversion "latest"
+		defines "UNICODE"
+	
+	filter "configurations:Debug"
+		defines "_DEBUG"
+		runtime "Debug"
+		symbols "On"
+	
+	filter "configurations:Profile"
+		defines "_PROFILE"
+		runtime "Release"
+		symbols "On"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+		
+	filter "configurations:Release"
+		defines "_RELEASE"
+		runtime "Release"
+		symbols "Off"
+		optimize "Speed"
+		inlining ("Auto")
+		linktimeoptimization "On"
+
+-- Benchmark of RandFS against the generators of the standard library
+project "RandBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "On"
+	flags { "MultiProcessorCompile" }
+
+	targetdir("bin/output/" .. outputdir .. "/%{prj.name}")
+	objdir("bin/intermediates/" .. outputdir .. "/%{prj.name}")
+	
+	files
+	{
+		-- Source files
+		"bench/RandBench.cpp",
+		"src/RandFS.h"
+	}
+	
+	includedirs
+	{
+		"src"
+	}
+	
 	filter "system:windows"
 		systemversion "latest"
 		defines "UNICODE"
@@ -0,0 +1,275 @@
+#include "CpuRenderer.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Primitives.h"
+
+CpuRenderer::CpuRenderer(const Expression& expression, int threadCount)
+	: m_Program(BuildProgram(expression)), m_OwnedPool(std::make_unique<ThreadPool>(threadCount))
+{
+	m_Pool = m_OwnedPool.get();
+	m_BlockProgram = BuildSeparatedBlockProgram(m_Program);
+	SetSimdLevel(DetectSimdLevel());
+}
+
+CpuRenderer::CpuRenderer(const Expression& expression, ThreadPool& pool)
+	: m_Program(BuildProgram(expression)), m_Pool(&pool)
+{
+	m_BlockProgram = BuildSeparatedBlockProgram(m_Program);
+	SetSimdLevel(DetectSimdLevel());
+}
+
+void CpuRenderer::SetSimdLevel(SimdLevel level)
+{
+	m_SimdLevel = level;
+	m_BlockFunction = GetBlockFunction(level);
+}
+
+void CpuRenderer::EvaluatePixel(float x, float y, FrameInputs frame, float* r, float* rgb) const
+{
+	const Instruction* code = m_Program.code.data();
+	const uint32_t size = uint32_t(m_Program.code.size());
+
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		const Instruction& in = code[i];
+		const uint32_t* a = in.args;
+
+		switch (in.op)
+		{
+			case Op::X:          r[i] = x; break;
+			case Op::Y:          r[i] = y; break;
+			case Op::InvX:       r[i] = 1.0f - x; break;
+			case Op::InvY:       r[i] = 1.0f - y; break;
+			case Op::SinTime:    r[i] = frame.sinTime; break;
+			case Op::CosTime:    r[i] = frame.cosTime; break;
+			case Op::Const:      r[i] = in.value; break;
+
+			case Op::Inv:        r[i] = fInv(r[a[0]]); break;
+			case Op::Sqr:        r[i] = fSqr(r[a[0]]); break;
+			case Op::Sqrt:       r[i] = fSqrt(r[a[0]]); break;
+			case Op::Smooth:     r[i] = fSmooth(r[a[0]]); break;
+			case Op::Sharp:      r[i] = fSharp(r[a[0]]); break;
+
+			case Op::Add:        r[i] = fAdd(r[a[0]], r[a[1]]); break;
+			case Op::Sub:        r[i] = fSub(r[a[0]], r[a[1]]); break;
+			case Op::Mul:        r[i] = fMul(r[a[0]], r[a[1]]); break;
+			case Op::Div:        r[i] = fDiv(r[a[0]], r[a[1]]); break;
+			case Op::Avg:        r[i] = fAvg(r[a[0]], r[a[1]]); break;
+			case Op::Geom:       r[i] = fGeom(r[a[0]], r[a[1]]); break;
+			case Op::Harm:       r[i] = fHarm(r[a[0]], r[a[1]]); break;
+			case Op::Hypo:       r[i] = fHypo(r[a[0]], r[a[1]]); break;
+			case Op::Min:        r[i] = fMin(r[a[0]], r[a[1]]); break;
+			case Op::Max:        r[i] = fMax(r[a[0]], r[a[1]]); break;
+			case Op::Pow:        r[i] = fPow(r[a[0]], r[a[1]]); break;
+			case Op::Bell:       r[i] = fBell(r[a[0]], r[a[1]]); break;
+			case Op::Wave:       r[i] = fWave(r[a[0]], r[a[1]]); break;
+			case Op::WaveDamp:   r[i] = fWaveDamp(r[a[0]], r[a[1]]); break;
+
+			case Op::Lerp:       r[i] = fLerp(r[a[0]], r[a[1]], r[a[2]]); break;
+			case Op::SmoothLerp: r[i] = fSmoothLerp(r[a[0]], r[a[1]], r[a[2]]); break;
+			case Op::Mlerp:      r[i] = fMlerp(r[a[0]], r[a[1]], r[a[2]]); break;
+			case Op::Clamp:      r[i] = fClamp(r[a[0]], r[a[1]], r[a[2]]); break;
+
+			case Op::Dist:       r[i] = fDist(r[a[0]], r[a[1]], r[a[2]], r[a[3]]); break;
+			case Op::DistLine:   r[i] = fDistLine(r[a[0]], r[a[1]], r[a[2]], r[a[3]]); break;
+
+			default: r[i] = 0.0f; break;
+		}
+	}
+
+	for (int c = 0; c < 3; c++)
+		rgb[c] = r[m_Program.channels[c]];
+
+	for (const MaskStep& step : m_Program.mask)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			switch (step.op)
+			{
+				case Op::Inv3: rgb[c] = fInv3(rgb[c]); break;
+				case Op::Add3: rgb[c] = fAdd3(rgb[c], r[step.arg]); break;
+				case Op::Sub3: rgb[c] = fSub3(rgb[c], r[step.arg]); break;
+				default: break;
+			}
+		}
+	}
+}
+
+// Evaluate the values of a hoisted program for 'stride' columns or rows, in blocks, into one array of 'stride' floats per value
+// 'setCoordinates' fills the x and y coordinates of the block starting at the given column or row
+template <typename SetCoordinates>
+static void EvaluateHoisted(const HoistedBlockProgram& hoisted, BlockFunction function, FrameInputs frame, int stride,
+	SetCoordinates setCoordinates, std::vector<float>& values)
+{
+	values.resize(hoisted.values.size() * size_t(stride));
+	if (hoisted.values.empty())
+		return;
+
+	// Block functions need 64-byte aligned memory
+	std::vector<float> slotMemory(size_t(hoisted.program.slotCount + 1U) * BlockSize + 16);
+	float* slots = reinterpret_cast<float*>((reinterpret_cast<uintptr_t>(slotMemory.data()) + 63) & ~uintptr_t(63));
+
+	alignas(64) float x[BlockSize] = {};
+	alignas(64) float y[BlockSize] = {};
+	alignas(64) float rgb[3 * BlockSize];
+
+	for (int i0 = 0; i0 < stride; i0 += BlockSize)
+	{
+		setCoordinates(i0, x, y);
+		function(hoisted.program, x, y, frame, slots, rgb);
+
+		for (size_t v = 0; v < hoisted.values.size(); v++)
+		{
+			const float* src = slots + size_t(hoisted.values[v]) * BlockSize;
+			std::copy(src, src + BlockSize, values.begin() + v * size_t(stride) + size_t(i0));
+		}
+	}
+}
+
+template <typename StoreSpan>
+void CpuRenderer::RenderTiles(int width, int height, FrameInputs frame, StoreSpan storeSpan) const
+{
+	// Pixels that cost more tend to be close together, so the frame is split into tiles that are handed out dynamically
+	const int tileWidth = m_TileSettings.width > 0 ? m_TileSettings.width : width;
+	const int tileHeight = m_TileSettings.height > 0 ? m_TileSettings.height : height;
+	const int tilesX = (width + tileWidth - 1) / tileWidth;
+	const int tilesY = (height + tileHeight - 1) / tileHeight;
+	const std::vector<uint32_t> order = BuildTileOrder(tilesX, tilesY, m_TileSettings.order);
+
+	// Sample at pixel centers, with uv.y pointing up like in the vertex shader
+	// Columns are padded so that the last block of a span, which may run past the end of the image, can read a full block
+	const int columnStride = (width + 2 * BlockSize - 1) / BlockSize * BlockSize;
+	const int rowStride = (height + BlockSize - 1) / BlockSize * BlockSize;
+	std::vector<float> columnX(columnStride), rowY(rowStride);
+	for (int px = 0; px < columnStride; px++)
+		columnX[px] = (float(px) + 0.5f) / float(width);
+	for (int py = 0; py < rowStride; py++)
+		rowY[py] = 1.0f - (float(py) + 0.5f) / float(height);
+
+	// Values that do not depend on both coordinates are evaluated first, with the same block function and coordinates as the pixels
+	std::vector<float> columnValues, rowValues, frameValues;
+	if (!m_RowFunction)
+	{
+		EvaluateHoisted(m_BlockProgram.columns, m_BlockFunction, frame, columnStride, [&](int i0, float* x, float*)
+		{
+			std::copy_n(&columnX[i0], BlockSize, x);
+		}, columnValues);
+
+		EvaluateHoisted(m_BlockProgram.rows, m_BlockFunction, frame, rowStride, [&](int i0, float*, float* y)
+		{
+			std::copy_n(&rowY[i0], BlockSize, y);
+		}, rowValues);
+
+		EvaluateHoisted(m_BlockProgram.frame, m_BlockFunction, frame, BlockSize, [](int, float*, float*) {}, frameValues);
+	}
+
+	const BlockProgram& pixels = m_BlockProgram.pixels;
+	const HoistedBlockProgram& columns = m_BlockProgram.columns;
+	const HoistedBlockProgram& rows = m_BlockProgram.rows;
+
+	// Working memory of each thread
+	struct Scratch
+	{
+		std::vector<float> slotMemory;
+		float* slots = nullptr;
+		std::vector<float> span;
+	};
+	std::vector<Scratch> scratch(size_t(m_Pool->ThreadCount()));
+
+	m_Pool->Run(uint32_t(order.size()), [&](uint32_t task, int thread)
+	{
+		Scratch& s = scratch[thread];
+		if (!s.slots)
+		{
+			// Block functions need 64-byte aligned memory
+			s.slotMemory.resize(size_t(pixels.slotCount + 1U) * BlockSize + 16);
+			s.slots = reinterpret_cast<float*>((reinterpret_cast<uintptr_t>(s.slotMemory.data()) + 63) & ~uintptr_t(63));
+			s.span.resize(3 * size_t(tileWidth));
+		}
+
+		alignas(64) float x[BlockSize];
+		alignas(64) float y[BlockSize];
+		alignas(64) float rgb[3 * BlockSize];
+
+		const int tx = int(order[task] % uint32_t(tilesX));
+		const int ty = int(order[task] / uint32_t(tilesX));
+		const int x0 = tx * tileWidth;
+		const int y0 = ty * tileHeight;
+		const int count = width - x0 < tileWidth ? width - x0 : tileWidth;
+		const int y1 = height - y0 < tileHeight ? height : y0 + tileHeight;
+
+		for (int py = y0; py < y1; py++)
+		{
+			if (m_RowFunction)
+			{
+				m_RowFunction(m_RowContext, width, height, py, x0, count, frame.sinTime, frame.cosTime, s.span.data());
+				storeSpan(x0, py, count, s.span.data());
+				continue;
+			}
+
+			std::fill_n(y, BlockSize, rowY[py]);
+
+			// Hoisted values that are the same for the whole row are written once, into slots that the block function never overwrites
+			for (size_t k = 0; k < rows.targets.size(); k++)
+				std::fill_n(s.slots + size_t(rows.targets[k]) * BlockSize, BlockSize, rowValues[k * size_t(rowStride) + size_t(py)]);
+			for (size_t k = 0; k < m_BlockProgram.frame.targets.size(); k++)
+				std::fill_n(s.slots + size_t(m_BlockProgram.frame.targets[k]) * BlockSize, BlockSize, frameValues[k * size_t(BlockSize)]);
+
+			for (int px0 = 0; px0 < count; px0 += BlockSize)
+			{
+				// The last block of a span may run past its end, those pixels are discarded
+				std::copy_n(&columnX[x0 + px0], BlockSize, x);
+
+				for (size_t k = 0; k < columns.targets.size(); k++)
+				{
+					const float* src = &columnValues[k * size_t(columnStride) + size_t(x0 + px0)];
+					std::copy(src, src + BlockSize, s.slots + size_t(columns.targets[k]) * BlockSize);
+				}
+
+				m_BlockFunction(pixels, x, y, frame, s.slots, rgb);
+
+				const int blockCount = count - px0 < BlockSize ? count - px0 : BlockSize;
+				for (int i = 0; i < blockCount; i++)
+				{
+					float* dst = &s.span[3 * size_t(px0 + i)];
+					dst[0] = rgb[i];
+					dst[1] = rgb[BlockSize + i];
+					dst[2] = rgb[2 * BlockSize + i];
+				}
+			}
+			storeSpan(x0, py, count, s.span.data());
+		}
+	});
+}
+
+void CpuRenderer::Render(int width, int height, FrameInputs frame, float* rgb) const
+{
+	RenderTiles(width, height, frame, [&](int x0, int py, int count, const float* span)
+	{
+		float* dst = rgb + 3 * (size_t(py) * size_t(width) + size_t(x0));
+		for (size_t i = 0; i < 3 * size_t(count); i++)
+			dst[i] = span[i];
+	});
+}
+
+void CpuRenderer::Render(int width, int height, FrameInputs frame, uint8_t* rgba) const
+{
+	RenderTiles(width, height, frame, [&](int x0, int py, int count, const float* span)
+	{
+		uint8_t* dst = rgba + 4 * (size_t(py) * size_t(width) + size_t(x0));
+		for (int px = 0; px < count; px++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				// Same conversion as a UNORM render target: saturate, with NaN becoming 0
+				float v = span[3 * px + c];
+				v = v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;
+				dst[4 * px + c] = uint8_t(v * 255.0f + 0.5f);
+			}
+			dst[4 * px + 3] = 255;
+		}
+	});
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+
+#include "Expression.h"
+#include "Program.h"
+#include "Scheduler.h"
+#include "Simd.h"
+
+// Renders generated expressions on the CPU, without any graphics API
+// Every pixel gets the same value as the full screen quad drawn by Graphics::DrawViewportQuad at the same resolution
+class CpuRenderer
+{
+public:
+	// A thread count of 0 uses all available hardware threads
+	// Pixels are evaluated in blocks, with the fastest instruction set supported by the CPU
+	CpuRenderer(const Expression& expression, int threadCount = 0);
+	// Render with the threads of an existing pool, which must outlive the renderer
+	// Sharing a pool avoids starting new threads for every expression
+	CpuRenderer(const Expression& expression, ThreadPool& pool);
+
+	// Render into 3 floats per pixel (red, green, blue), with rows ordered from top to bottom
+	void Render(int width, int height, FrameInputs frame, float* rgb) const;
+	// Render into 4 bytes per pixel (red, green, blue, alpha), with rows ordered from top to bottom
+	void Render(int width, int height, FrameInputs frame, uint8_t* rgba) const;
+
+	// Evaluate the color of a single pixel, at normalized coordinates (x, y) with (0, 0) at the bottom left
+	// 'registers' must hold at least RegisterCount() floats
+	// This is the reference implementation, and does not use the block functions
+	void EvaluatePixel(float x, float y, FrameInputs frame, float* registers, float* rgb) const;
+
+	// Choose the instruction set used for block evaluation, which must be supported by the CPU
+	void SetSimdLevel(SimdLevel level);
+	SimdLevel GetSimdLevel() const { return m_SimdLevel; }
+
+	// Evaluate rows of tiles with a natively compiled function instead of the block functions (see Jit.h and X64Kernel.h)
+	// The function and its context must stay alive while this renderer is used, and nullptr goes back to block evaluation
+	void SetRowFunction(RowFunction function, const void* context = nullptr) { m_RowFunction = function; m_RowContext = context; }
+	RowFunction GetRowFunction() const { return m_RowFunction; }
+
+	// Frames are split into tiles, which the threads of the pool take in the given order
+	void SetTileSettings(const TileSettings& settings) { m_TileSettings = settings; }
+	const TileSettings& GetTileSettings() const { return m_TileSettings; }
+
+	// Pool used by Render, whose statistics describe the last render
+	const ThreadPool& GetThreadPool() const { return *m_Pool; }
+
+	const Program& GetProgram() const { return m_Program; }
+	// Program evaluated by the block functions, with the values that do not depend on both coordinates hoisted out of the pixels
+	const SeparatedBlockProgram& GetBlockProgram() const { return m_BlockProgram; }
+	int RegisterCount() const { return int(m_Program.code.size()); }
+	int ThreadCount() const { return m_Pool->ThreadCount(); }
+
+private:
+	Program m_Program;
+	SeparatedBlockProgram m_BlockProgram;
+
+	std::unique_ptr<ThreadPool> m_OwnedPool;
+	ThreadPool* m_Pool;
+	TileSettings m_TileSettings;
+
+	SimdLevel m_SimdLevel;
+	BlockFunction m_BlockFunction;
+	RowFunction m_RowFunction = nullptr;
+	const void* m_RowContext = nullptr;
+
+	// Render every tile one row at a time into a temporary float buffer, and pass each row of each tile to 'storeSpan', in parallel
+	template <typename StoreSpan>
+	void RenderTiles(int width, int height, FrameInputs frame, StoreSpan storeSpan) const;
+};
@@ -0,0 +1,222 @@
+#include "Expression.h"
+
+#include <cstring>
+
+// Costs were measured with the block evaluator, by timing long chains of each operation
+// Transcendental functions dominate: fPow, fBell and fMlerp call pow, fWave and fWaveDamp call cos, and fDistLine calls tan
+static constexpr OpInfo opInfos[] =
+{
+	// Values
+	{ "uv.x", 0, 0.0f },
+	{ "uv.y", 0, 0.0f },
+	{ "invX", 0, 0.0f },
+	{ "invY", 0, 0.0f },
+	{ "sinTime", 0, 0.0f },
+	{ "cosTime", 0, 0.0f },
+	{ "#", 0, 0.0f },
+
+	// 1 input
+	{ "fInv", 1, 1.0f },
+	{ "fSqr", 1, 1.0f },
+	{ "fSqrt", 1, 3.0f },
+	{ "fSmooth", 1, 2.0f },
+	{ "fSharp", 1, 2.0f },
+
+	// 2 inputs
+	{ "fAdd", 2, 2.0f },
+	{ "fSub", 2, 2.0f },
+	{ "fMul", 2, 1.0f },
+	{ "fDiv", 2, 5.0f },
+	{ "fAvg", 2, 1.0f },
+	{ "fGeom", 2, 4.0f },
+	{ "fHarm", 2, 4.0f },
+	{ "fHypo", 2, 4.0f },
+	{ "fMin", 2, 2.0f },
+	{ "fMax", 2, 2.0f },
+	{ "fPow", 2, 43.0f },
+	{ "fBell", 2, 40.0f },
+	{ "fWave", 2, 14.0f },
+	{ "fWaveDamp", 2, 21.0f },
+
+	// 3 inputs
+	{ "fLerp", 3, 2.0f },
+	{ "fSmoothLerp", 3, 2.0f },
+	{ "fMlerp", 3, 42.0f },
+	{ "fClamp", 3, 5.0f },
+
+	// 4 inputs
+	{ "fDist", 4, 4.0f },
+	{ "fDistLine", 4, 45.0f },
+
+	// Masks
+	{ "rgb", 3, 0.0f },
+	{ "fInv3", 1, 3.0f },
+	{ "fAdd3", 2, 6.0f },
+	{ "fSub3", 2, 6.0f },
+
+	{ "@", 0, 0.0f }
+};
+static_assert(sizeof(opInfos) / sizeof(OpInfo) == size_t(Op::Count), "Every operation must have an entry in opInfos.");
+
+const OpInfo& GetOpInfo(Op op)
+{
+	return opInfos[size_t(op)];
+}
+
+uint32_t Expression::AddNode(const Node& node)
+{
+	nodes.push_back(node);
+	return uint32_t(nodes.size() - 1);
+}
+
+void Expression::Instantiate(const Expression& pattern, uint32_t index, std::vector<uint32_t>& holes)
+{
+	// Template node 0 goes to the given index, and node k > 0 goes to base + k - 1
+	const uint32_t base = uint32_t(nodes.size());
+	auto remap = [&](uint32_t k) { return k == 0U ? index : base + k - 1U; };
+
+	for (uint32_t k = 0U; k < uint32_t(pattern.nodes.size()); k++)
+	{
+		Node node = pattern.nodes[k];
+		for (int a = 0; a < GetOpInfo(node.op).arity; a++)
+			node.args[a] = remap(node.args[a]);
+
+		if (k == 0U)
+			nodes[index] = node;
+		else
+			nodes.push_back(node);
+
+		// Template nodes are stored in preorder, so holes come out in the order they appear in the text
+		if (node.op == Op::Hole)
+			holes.push_back(remap(k));
+	}
+}
+
+uint32_t Expression::RgbNode() const
+{
+	uint32_t index = root;
+	while (nodes[index].op != Op::Rgb)
+		index = nodes[index].args[0];
+	return index;
+}
+
+void Expression::AppendSource(uint32_t index, std::string& out) const
+{
+	const Node& node = nodes[index];
+	const OpInfo& info = GetOpInfo(node.op);
+
+	if (node.op == Op::Const)
+	{
+		out += std::to_string(node.value);
+		out += 'f';
+		return;
+	}
+
+	// The color is always referenced through the 'rgb' variable
+	if (info.arity == 0 || node.op == Op::Rgb)
+	{
+		out += info.name;
+		return;
+	}
+
+	out += info.name;
+	out += '(';
+	for (int a = 0; a < info.arity; a++)
+	{
+		if (a > 0)
+			out += ", ";
+		AppendSource(node.args[a], out);
+	}
+	out += ')';
+}
+
+std::string Expression::Source(uint32_t index) const
+{
+	std::string out;
+	AppendSource(index, out);
+	return out;
+}
+
+#pragma region Template parser
+
+static Op FindOp(const char* name, size_t length)
+{
+	for (size_t i = 0; i < size_t(Op::Count); i++)
+	{
+		if (std::strlen(opInfos[i].name) == length && std::strncmp(opInfos[i].name, name, length) == 0)
+			return Op(i);
+	}
+	return Op::Count;
+}
+
+static void SkipSpaces(const char*& c)
+{
+	while (*c == ' ')
+		c++;
+}
+
+// Recursive descent parser, nodes are appended in preorder
+static uint32_t ParseNode(const char*& c, Expression& out)
+{
+	SkipSpaces(c);
+
+	// Read a name (identifiers may contain dots, as in "uv.x"), or a single '@' or '#' token
+	const char* begin = c;
+	if (*c == '@' || *c == '#')
+		c++;
+	else
+		while ((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '.')
+			c++;
+
+	Op op = FindOp(begin, size_t(c - begin));
+	if (op == Op::Count)
+		return ~0U;
+
+	Node node;
+	node.op = op;
+	uint32_t index = out.AddNode(node);
+
+	// The color has no explicit inputs in the source, they are filled in by the generator
+	if (op == Op::Rgb)
+		return index;
+
+	const int arity = GetOpInfo(op).arity;
+	if (arity == 0)
+		return index;
+
+	SkipSpaces(c);
+	if (*c++ != '(')
+		return ~0U;
+
+	for (int a = 0; a < arity; a++)
+	{
+		if (a > 0)
+		{
+			SkipSpaces(c);
+			if (*c++ != ',')
+				return ~0U;
+		}
+
+		uint32_t arg = ParseNode(c, out);
+		if (arg == ~0U)
+			return ~0U;
+		out.nodes[index].args[a] = arg;
+	}
+
+	SkipSpaces(c);
+	if (*c++ != ')')
+		return ~0U;
+
+	return index;
+}
+
+Expression ParseTemplate(const char* source)
+{
+	Expression pattern;
+	const char* c = source;
+	if (ParseNode(c, pattern) == ~0U)
+		pattern.nodes.clear();
+	return pattern;
+}
+
+#pragma endregion
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Every value, primitive function and mask that can appear in a generated expression
+enum class Op : uint8_t
+{
+	// Values
+	X,
+	Y,
+	InvX,
+	InvY,
+	SinTime,
+	CosTime,
+	Const,
+
+	// 1 input
+	Inv,
+	Sqr,
+	Sqrt,
+	Smooth,
+	Sharp,
+
+	// 2 inputs
+	Add,
+	Sub,
+	Mul,
+	Div,
+	Avg,
+	Geom,
+	Harm,
+	Hypo,
+	Min,
+	Max,
+	Pow,
+	Bell,
+	Wave,
+	WaveDamp,
+
+	// 3 inputs
+	Lerp,
+	SmoothLerp,
+	Mlerp,
+	Clamp,
+
+	// 4 inputs
+	Dist,
+	DistLine,
+
+	// Masks (operate on the float3 color instead of a single float)
+	Rgb, // float3(r, g, b), the unmasked color
+	Inv3,
+	Add3,
+	Sub3,
+
+	// Token that has not been expanded yet (only exists during generation)
+	Hole,
+
+	Count
+};
+
+struct OpInfo
+{
+	const char* name; // Name of the function (or value) in the generated source
+	int arity; // Number of inputs
+	float cost; // Rough time to evaluate it for one pixel on the CPU, in multiplications (see EstimateCost)
+};
+
+// Get the name, number of inputs and cost of the given operation
+const OpInfo& GetOpInfo(Op op);
+
+struct Node
+{
+	Op op = Op::Hole;
+	float value = 0.0f; // Only used by Op::Const
+	uint32_t args[4] = {}; // Indices of the input nodes, only the first 'arity' are used
+};
+
+// A procedurally generated expression
+// All nodes live in a single contiguous arena and refer to each other by index
+struct Expression
+{
+	std::vector<Node> nodes;
+	uint32_t root = 0U; // Root of the mask chain, which ends at the Op::Rgb node
+
+	uint64_t seed = 0ULL; // Seed that generated this expression
+	int maxDepth = 0;
+
+	// Append a node to the arena and return its index
+	uint32_t AddNode(const Node& node);
+
+	// Copy the given template into the arena, with its root overwriting the node at the given index
+	// Indices of the template holes are appended to 'holes', in the same order they appear in the source text
+	void Instantiate(const Expression& pattern, uint32_t index, std::vector<uint32_t>& holes);
+
+	// Find the node holding the unmasked float3(r, g, b) color
+	uint32_t RgbNode() const;
+
+	// Append the source code of the subtree at the given index to 'out'
+	void AppendSource(uint32_t index, std::string& out) const;
+	std::string Source(uint32_t index) const;
+};
+
+// Parse a single template (e.g. "fInv(fDist(uv.x, uv.y, @, #))") into an expression whose root is node 0
+// '@' becomes an Op::Hole and '#' becomes an Op::Const to be filled in later
+Expression ParseTemplate(const char* source);
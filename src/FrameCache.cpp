@@ -0,0 +1,292 @@
+#include "FrameCache.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "RandFS.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Start of every cache file, padded so that the frames after it stay aligned
+struct FrameCacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	int32_t frameCount;
+	uint64_t seed;
+	int32_t width;
+	int32_t height;
+	uint64_t check; // Hash of the fields above, to reject headers that were damaged or written by something else
+	uint8_t padding[24];
+};
+static_assert(sizeof(FrameCacheHeader) == 64, "Frame cache header must keep the frames aligned");
+
+static constexpr char FrameCacheMagic[8] = { 'P', 'O', 'L', 'L', 'O', 'C', 'K', 'F' };
+static constexpr uint32_t FrameCacheVersion = 1U;
+
+static uint64_t HeaderCheck(const FrameCacheHeader& header)
+{
+	return Hash::UInt64(uint64_t(header.version), header.seed, uint64_t(uint32_t(header.width)), uint64_t(uint32_t(header.height)),
+		uint64_t(uint32_t(header.frameCount)));
+}
+
+float GetKeyframeTime(int frame, int frameCount)
+{
+	return float(double(frame) * double(LoopPeriod) / double(frameCount));
+}
+
+std::string GetFrameCachePath(const std::string& directory, const FrameCacheKey& key)
+{
+	std::string path = directory;
+	if (!path.empty() && path.back() != '/' && path.back() != '\\')
+		path += '/';
+
+	path += "pollock_";
+	path += std::to_string(key.seed);
+	path += '_';
+	path += std::to_string(key.width);
+	path += 'x';
+	path += std::to_string(key.height);
+	path += '_';
+	path += std::to_string(key.frameCount);
+	path += ".pfc";
+	return path;
+}
+
+#pragma region Writer
+
+FrameCacheWriter::FrameCacheWriter(const std::string& path, const FrameCacheKey& key)
+	: m_Path(path), m_TemporaryPath(path + ".tmp"), m_Key(key)
+{
+	if (key.width <= 0 || key.height <= 0 || key.frameCount <= 0)
+	{
+		m_Error = "Invalid frame cache size";
+		return;
+	}
+
+	m_File = std::fopen(m_TemporaryPath.c_str(), "wb");
+	if (!m_File)
+	{
+		m_Error = "Could not create " + m_TemporaryPath;
+		return;
+	}
+
+	FrameCacheHeader header = {};
+	std::memcpy(header.magic, FrameCacheMagic, sizeof(header.magic));
+	header.version = FrameCacheVersion;
+	header.frameCount = key.frameCount;
+	header.seed = key.seed;
+	header.width = key.width;
+	header.height = key.height;
+	header.check = HeaderCheck(header);
+
+	if (std::fwrite(&header, sizeof(header), 1, m_File) != 1)
+		m_Error = "Could not write " + m_TemporaryPath;
+}
+
+FrameCacheWriter::~FrameCacheWriter()
+{
+	// Unfinished caches are thrown away
+	if (m_File)
+	{
+		std::fclose(m_File);
+		std::remove(m_TemporaryPath.c_str());
+	}
+}
+
+bool FrameCacheWriter::WriteFrame(const uint8_t* rgba)
+{
+	if (!m_File || !m_Error.empty())
+		return false;
+
+	if (m_FramesWritten == m_Key.frameCount)
+	{
+		m_Error = "Too many frames for the cache";
+		return false;
+	}
+
+	const size_t size = 4 * size_t(m_Key.width) * size_t(m_Key.height);
+	if (std::fwrite(rgba, 1, size, m_File) != size)
+	{
+		m_Error = "Could not write " + m_TemporaryPath;
+		return false;
+	}
+
+	m_FramesWritten++;
+	return true;
+}
+
+bool FrameCacheWriter::Finish()
+{
+	if (!m_File || !m_Error.empty())
+		return false;
+
+	if (m_FramesWritten != m_Key.frameCount)
+	{
+		m_Error = "Only " + std::to_string(m_FramesWritten) + " of " + std::to_string(m_Key.frameCount) + " frames were written";
+		return false;
+	}
+
+	const bool closed = std::fclose(m_File) == 0;
+	m_File = nullptr;
+
+	// Renaming does not replace existing files on every system
+	std::remove(m_Path.c_str());
+	if (!closed || std::rename(m_TemporaryPath.c_str(), m_Path.c_str()) != 0)
+	{
+		std::remove(m_TemporaryPath.c_str());
+		m_Error = "Could not write " + m_Path;
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region Cache
+
+FrameCache::FrameCache(const std::string& path)
+{
+	#ifdef _WIN32
+
+	m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		m_File = nullptr;
+		m_Error = "Could not open " + path;
+		return;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(m_File, &fileSize) || fileSize.QuadPart < LONGLONG(sizeof(FrameCacheHeader)))
+	{
+		m_Error = path + " is not a frame cache";
+		return;
+	}
+
+	m_MappingHandle = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	m_Mapping = m_MappingHandle ? MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	m_MappingSize = size_t(fileSize.QuadPart);
+
+	#else
+
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		m_Error = "Could not open " + path;
+		return;
+	}
+
+	struct stat status = {};
+	if (fstat(file, &status) != 0 || status.st_size < off_t(sizeof(FrameCacheHeader)))
+	{
+		close(file);
+		m_Error = path + " is not a frame cache";
+		return;
+	}
+
+	// The mapping stays valid after the file is closed
+	m_MappingSize = size_t(status.st_size);
+	m_Mapping = mmap(nullptr, m_MappingSize, PROT_READ, MAP_SHARED, file, 0);
+	if (m_Mapping == MAP_FAILED)
+		m_Mapping = nullptr;
+	close(file);
+
+	#endif
+
+	if (!m_Mapping)
+	{
+		m_Error = "Could not map " + path;
+		return;
+	}
+
+	FrameCacheHeader header;
+	std::memcpy(&header, m_Mapping, sizeof(header));
+	if (std::memcmp(header.magic, FrameCacheMagic, sizeof(header.magic)) != 0 || header.check != HeaderCheck(header))
+	{
+		m_Error = path + " is not a frame cache";
+		return;
+	}
+	if (header.version != FrameCacheVersion)
+	{
+		m_Error = path + " was written by a different version";
+		return;
+	}
+
+	m_Key.seed = header.seed;
+	m_Key.width = header.width;
+	m_Key.height = header.height;
+	m_Key.frameCount = header.frameCount;
+
+	if (m_Key.width <= 0 || m_Key.height <= 0 || m_Key.frameCount <= 0
+		|| m_MappingSize != sizeof(FrameCacheHeader) + size_t(m_Key.frameCount) * FrameSize())
+	{
+		m_Error = path + " is truncated";
+		return;
+	}
+
+	m_Frames = static_cast<const uint8_t*>(m_Mapping) + sizeof(FrameCacheHeader);
+}
+
+FrameCache::~FrameCache()
+{
+	#ifdef _WIN32
+
+	if (m_Mapping)
+		UnmapViewOfFile(m_Mapping);
+	if (m_MappingHandle)
+		CloseHandle(m_MappingHandle);
+	if (m_File)
+		CloseHandle(m_File);
+
+	#else
+
+	if (m_Mapping)
+		munmap(m_Mapping, m_MappingSize);
+
+	#endif
+}
+
+void FrameCache::SampleFrame(float seconds, bool interpolate, uint8_t* rgba) const
+{
+	const int count = m_Key.frameCount;
+
+	// Position in keyframes, in [0, count)
+	double phase = std::fmod(double(seconds), double(LoopPeriod)) / double(LoopPeriod) * count;
+	if (phase < 0.0)
+		phase += count;
+
+	const int first = int(phase) % count;
+	const int second = (first + 1) % count;
+
+	// Blend weight of the second keyframe, out of 256
+	// Times of keyframes are rounded to float, so weights that round to a whole keyframe copy it exactly
+	const int weight = interpolate ? int((phase - std::floor(phase)) * 256.0 + 0.5) : (phase - std::floor(phase) < 0.5 ? 0 : 256);
+
+	if (weight == 0)
+	{
+		std::memcpy(rgba, GetFrame(first), FrameSize());
+		return;
+	}
+	if (weight == 256)
+	{
+		std::memcpy(rgba, GetFrame(second), FrameSize());
+		return;
+	}
+
+	const uint8_t* a = GetFrame(first);
+	const uint8_t* b = GetFrame(second);
+	const size_t size = FrameSize();
+	for (size_t i = 0; i < size; i++)
+		rgba[i] = uint8_t((a[i] * (256 - weight) + b[i] * weight + 128) >> 8);
+}
+
+#pragma endregion
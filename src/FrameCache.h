@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+// Time only enters the shaders through sin(0.5 t) and cos(0.5 t), so every animation repeats after this many seconds
+static constexpr float LoopPeriod = 12.566370614359172f; // 4 pi
+
+// What a cache of loop frames was rendered for, a cache is only reused if all of it matches
+struct FrameCacheKey
+{
+	uint64_t seed = 0ULL;
+	int width = 0;
+	int height = 0;
+	int frameCount = 0; // Keyframes spread evenly over one loop period
+
+	bool operator==(const FrameCacheKey& other) const = default;
+};
+
+// Time in seconds of the given keyframe, with keyframe 0 at time 0
+float GetKeyframeTime(int frame, int frameCount);
+
+// File name of the cache for the given key inside a directory, such as "frames/pollock_42_1600x900_240.pfc"
+std::string GetFrameCachePath(const std::string& directory, const FrameCacheKey& key);
+
+// Writes the keyframes of a loop to a cache file, as 4 bytes per pixel (red, green, blue, alpha) with rows from top to bottom
+// Frames are written to a temporary file, which only replaces the cache once every frame has been written,
+// so an interrupted render never leaves a cache that looks complete
+class FrameCacheWriter
+{
+public:
+	FrameCacheWriter(const std::string& path, const FrameCacheKey& key);
+	~FrameCacheWriter();
+
+	FrameCacheWriter(const FrameCacheWriter&) = delete;
+	FrameCacheWriter& operator=(const FrameCacheWriter&) = delete;
+
+	// Frames must be written in order, and false means the file could not be written, in which case GetError explains why
+	bool WriteFrame(const uint8_t* rgba);
+	// Move the finished cache to its path, after all key.frameCount frames have been written
+	bool Finish();
+
+	const std::string& GetError() const { return m_Error; }
+
+private:
+	std::string m_Path;
+	std::string m_TemporaryPath;
+	FrameCacheKey m_Key;
+	FILE* m_File = nullptr;
+	int m_FramesWritten = 0;
+	std::string m_Error;
+};
+
+// Keyframes of a loop, memory mapped from a cache file so that playback only reads the pages it needs
+class FrameCache
+{
+public:
+	explicit FrameCache(const std::string& path);
+	~FrameCache();
+
+	FrameCache(const FrameCache&) = delete;
+	FrameCache& operator=(const FrameCache&) = delete;
+
+	// False if the file is missing, truncated or was not written by FrameCacheWriter, in which case GetError explains why
+	bool IsValid() const { return m_Frames != nullptr; }
+	const std::string& GetError() const { return m_Error; }
+
+	const FrameCacheKey& GetKey() const { return m_Key; }
+	// 4 bytes per pixel of the given keyframe, rows from top to bottom
+	const uint8_t* GetFrame(int frame) const { return m_Frames + size_t(frame) * FrameSize(); }
+	size_t FrameSize() const { return 4 * size_t(m_Key.width) * size_t(m_Key.height); }
+
+	// Fill 'rgba' with the frame at the given time, wrapping around the loop period
+	// Either the nearest keyframe is copied, or the two keyframes around the time are blended linearly
+	void SampleFrame(float seconds, bool interpolate, uint8_t* rgba) const;
+
+private:
+	FrameCacheKey m_Key;
+	const uint8_t* m_Frames = nullptr;
+	void* m_Mapping = nullptr;
+	size_t m_MappingSize = 0;
+	std::string m_Error;
+
+	#ifdef _WIN32
+	void* m_File = nullptr;
+	void* m_MappingHandle = nullptr;
+	#endif
+};
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
+#include <vector>
 #include <Windows.h>
 #include <d3d11.h>
 #include <d3dcompiler.h>
@@ -64,7 +66,7 @@
 
 #pragma endregion
 
-Graphics::Graphics(int width, int height, const char* shaderPtr, int shaderSize)
+Graphics::Graphics(int width, int height, const SplitShaderCode& shaders)
 {
 	HINSTANCE hInstance = GetModuleHandle(nullptr);
 
@@ -157,12 +159,10 @@ Graphics::Graphics(int width, int height, const char* shaderPtr, int shaderSize)
 	"could not create device and/or swap chain");
 
 	// Get a view on the back buffer and set it as the render target
-	ID3D11Resource* backBufferResource = nullptr;
-	ID3D11RenderTargetView* backBuffer = nullptr;
-	ASSERT_WINDOWS(m_SwapChain->GetBuffer(0, __uuidof(ID3D11Resource), (void**)(&backBufferResource)), "could not get back buffer");
-	ASSERT_WINDOWS(m_Device->CreateRenderTargetView(backBufferResource, nullptr, &backBuffer), "could not create render target view on back buffer");
-	m_Context->OMSetRenderTargets(1, &backBuffer, nullptr);
-	backBufferResource->Release();
+	// The back buffer itself is kept to copy images that do not need to be drawn again
+	ASSERT_WINDOWS(m_SwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)(&m_BackBuffer)), "could not get back buffer");
+	ASSERT_WINDOWS(m_Device->CreateRenderTargetView(m_BackBuffer, nullptr, &m_BackBufferView), "could not create render target view on back buffer");
+	m_Context->OMSetRenderTargets(1, &m_BackBufferView, nullptr);
 
 	// Set viewport as the entire window
 	D3D11_VIEWPORT vp =
@@ -187,11 +187,15 @@ Graphics::Graphics(int width, int height, const char* shaderPtr, int shaderSize)
 	CreateIndexBuffer();
 	CreateConstantBuffer();
 	CreateVertexShader();
-	CreatePixelShader(shaderPtr, shaderSize);
+	CreatePixelShaders(shaders);
 }
 Graphics::~Graphics()	
 {
 	// DirectX11
+	ReleasePixelShaders();
+	RELEASE_COM_PTR(m_FrameTexture);
+	RELEASE_COM_PTR(m_BackBufferView);
+	RELEASE_COM_PTR(m_BackBuffer);
 	RELEASE_COM_PTR(m_ConstantBuffer);
 	RELEASE_COM_PTR(m_Context);
 	RELEASE_COM_PTR(m_Device);
@@ -216,12 +220,47 @@ bool Graphics::UpdateInputs() const
 
 	return true;
 }
-void Graphics::CreatePixelShader(const void* shaderPtr, int shaderSize)
+// Compilation flags for the given optimization level, from 0 to 4 like SHADER_OPTIMIZATION_LEVEL
+static uint32_t GetCompileFlags(int optimizationLevel)
 {
 	#if _DEBUG
 
-		// Compilation flags
-		uint32_t flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+		(void)optimizationLevel;
+		return D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+
+	#else
+
+		uint32_t flags = D3DCOMPILE_PARTIAL_PRECISION | D3DCOMPILE_SKIP_VALIDATION;
+		switch (optimizationLevel)
+		{
+			case 0: flags |= D3DCOMPILE_SKIP_OPTIMIZATION; break;
+			case 1: flags |= D3DCOMPILE_OPTIMIZATION_LEVEL0; break;
+			case 2: flags |= D3DCOMPILE_OPTIMIZATION_LEVEL1; break;
+			case 3: flags |= D3DCOMPILE_OPTIMIZATION_LEVEL2; break;
+			default: flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3; break;
+		}
+		return flags;
+
+	#endif
+}
+bool Graphics::HasOptimizedTier() const
+{
+	return GetCompileFlags(0) != GetCompileFlags(SHADER_OPTIMIZATION_LEVEL);
+}
+std::vector<uint8_t> Graphics::CompileBytecode(const void* shaderPtr, int shaderSize, uint64_t programHash, int optimizationLevel) const
+{
+	// Compilation flags
+	const uint32_t flags = GetCompileFlags(optimizationLevel);
+
+	// Look for bytecode compiled with the same flags from the same source
+	const uint64_t sourceHash = KernelCache::HashSource(shaderPtr, size_t(shaderSize));
+	const uint64_t key = KernelCache::MakeKey(programHash ? programHash : sourceHash, "ps_5_0 " + std::to_string(flags));
+
+	std::vector<uint8_t> bytecode;
+	if (m_ShaderCache.Load(key, sourceHash, bytecode))
+		return bytecode;
+
+	#if _DEBUG
 
 		// Compile shader
 		ID3DBlob* blob = nullptr;
@@ -244,37 +283,112 @@ void Graphics::CreatePixelShader(const void* shaderPtr, int shaderSize)
 
 	#else
 
-		// Compilation flags
-		uint32_t flags = D3DCOMPILE_PARTIAL_PRECISION | D3DCOMPILE_SKIP_VALIDATION;
-
-		#if SHADER_OPTIMIZATION_LEVEL == 0
-			flags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-		#elif SHADER_OPTIMIZATION_LEVEL == 1
-			flags |= D3DCOMPILE_OPTIMIZATION_LEVEL0;
-		#elif SHADER_OPTIMIZATION_LEVEL == 2
-			flags |= D3DCOMPILE_OPTIMIZATION_LEVEL1;
-		#elif SHADER_OPTIMIZATION_LEVEL == 3
-			flags |= D3DCOMPILE_OPTIMIZATION_LEVEL2;
-		#elif SHADER_OPTIMIZATION_LEVEL == 4
-			flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
-		#endif
-
 		// Compile shader
 		ID3DBlob* blob = nullptr;
 		D3DCompile(shaderPtr, shaderSize, nullptr, nullptr, nullptr, "main", "ps_5_0", flags, 0, &blob, nullptr);
 
 	#endif
 
-	// Create pixel shader
-	ID3D11PixelShader* pixelShader = nullptr;
-	m_Device->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), nullptr, &pixelShader);
-	
-	// Bind pixel shader
-	m_Context->PSSetShader(pixelShader, nullptr, 0);
+	// Keep the bytecode, and store it for the next time this shader is needed
+	const uint8_t* data = static_cast<const uint8_t*>(blob->GetBufferPointer());
+	bytecode.assign(data, data + blob->GetBufferSize());
+	m_ShaderCache.Store(key, sourceHash, bytecode.data(), bytecode.size());
 
 	// Release data blob COM pointer
 	blob->Release();
-	pixelShader->Release();
+
+	return bytecode;
+}
+ID3D11PixelShader* Graphics::CreatePixelShaderObject(const std::vector<uint8_t>& bytecode) const
+{
+	ID3D11PixelShader* pixelShader = nullptr;
+	ASSERT_WINDOWS(m_Device->CreatePixelShader(bytecode.data(), bytecode.size(), nullptr, &pixelShader), "could not create pixel shader");
+	return pixelShader;
+}
+void Graphics::CreatePixelShader(const void* shaderPtr, int shaderSize)
+{
+	ReleasePixelShaders();
+
+	// Bind pixel shader
+	m_FrameShader = CreatePixelShaderObject(CompileBytecode(shaderPtr, shaderSize, 0ULL, SHADER_OPTIMIZATION_LEVEL));
+	m_Context->PSSetShader(m_FrameShader, nullptr, 0);
+}
+CompiledShaders Graphics::CompilePixelShaders(const SplitShaderCode& shaders, bool optimized) const
+{
+	const int level = optimized ? SHADER_OPTIMIZATION_LEVEL : 0;
+
+	CompiledShaders compiled;
+	compiled.code = shaders;
+	if (!shaders.cache.empty())
+		compiled.cache = CompileBytecode(shaders.cache.c_str(), int(shaders.cache.length()), KernelCache::MakeKey(shaders.programHash, "cache"), level);
+	if (!shaders.frame.empty())
+		compiled.frame = CompileBytecode(shaders.frame.c_str(), int(shaders.frame.length()), KernelCache::MakeKey(shaders.programHash, "frame"), level);
+	return compiled;
+}
+void Graphics::CreatePixelShaders(const SplitShaderCode& shaders)
+{
+	CreatePixelShaders(CompilePixelShaders(shaders));
+}
+void Graphics::CreatePixelShaders(const CompiledShaders& shaders)
+{
+	ReleasePixelShaders();
+
+	m_Animated = shaders.code.animated;
+	m_CacheDrawn = false;
+
+	if (!shaders.cache.empty())
+	{
+		// Cached values keep full precision, while a cached image has the format of the back buffer so that it can be copied
+		m_CacheShader = CreatePixelShaderObject(shaders.cache);
+		CreateCacheTargets(shaders.code.cacheTargets, shaders.code.animated ? DXGI_FORMAT_R32G32B32A32_FLOAT : DXGI_FORMAT_R8G8B8A8_UNORM);
+	}
+
+	if (!shaders.frame.empty())
+	{
+		// Bind pixel shader
+		m_FrameShader = CreatePixelShaderObject(shaders.frame);
+		m_Context->PSSetShader(m_FrameShader, nullptr, 0);
+	}
+}
+void Graphics::CreateCacheTargets(int count, DXGI_FORMAT format)
+{
+	// Same size as the back buffer, so that every pixel of a frame reads the value at its own position
+	D3D11_TEXTURE2D_DESC td = {};
+	m_BackBuffer->GetDesc(&td);
+	td.Format = format;
+	td.MipLevels = 1;
+	td.ArraySize = 1;
+	td.SampleDesc = { .Count = 1, .Quality = 0 };
+	td.Usage = D3D11_USAGE_DEFAULT;
+	td.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	td.CPUAccessFlags = 0;
+	td.MiscFlags = 0;
+
+	m_CacheTargetCount = count;
+	for (int i = 0; i < count; i++)
+	{
+		ASSERT_WINDOWS(m_Device->CreateTexture2D(&td, nullptr, &m_CacheTextures[i]), "could not create cache texture");
+		ASSERT_WINDOWS(m_Device->CreateRenderTargetView(m_CacheTextures[i], nullptr, &m_CacheTargets[i]), "could not create render target view on cache texture");
+		ASSERT_WINDOWS(m_Device->CreateShaderResourceView(m_CacheTextures[i], nullptr, &m_CacheViews[i]), "could not create shader resource view on cache texture");
+	}
+}
+void Graphics::ReleasePixelShaders()
+{
+	// Unbind the cache textures before releasing them
+	ID3D11ShaderResourceView* nullViews[MaxCacheTargets] = {};
+	m_Context->PSSetShaderResources(0, MaxCacheTargets, nullViews);
+
+	for (int i = 0; i < m_CacheTargetCount; i++)
+	{
+		RELEASE_COM_PTR(m_CacheViews[i]);
+		RELEASE_COM_PTR(m_CacheTargets[i]);
+		RELEASE_COM_PTR(m_CacheTextures[i]);
+	}
+	m_CacheTargetCount = 0;
+
+	RELEASE_COM_PTR(m_CacheShader);
+	RELEASE_COM_PTR(m_FrameShader);
+	m_Animated = true;
 }
 void Graphics::UpdateConstantBuffer(float x, float y, float z, float w) const
 {
@@ -290,7 +404,54 @@ void Graphics::UpdateConstantBuffer(float x, float y, float z, float w) const
 }
 void Graphics::DrawViewportQuad() const
 {
-	m_Context->DrawIndexed(4, 0, 0);
+	// Values that do not depend on time are drawn only once for each shader, before its first frame
+	if (m_CacheShader && !m_CacheDrawn)
+	{
+		m_Context->OMSetRenderTargets(m_CacheTargetCount, m_CacheTargets, nullptr);
+		m_Context->PSSetShader(m_CacheShader, nullptr, 0);
+		m_Context->DrawIndexed(4, 0, 0);
+
+		// Go back to drawing the frame shader on the back buffer, reading the cache
+		m_Context->OMSetRenderTargets(1, &m_BackBufferView, nullptr);
+		m_Context->PSSetShader(m_FrameShader, nullptr, 0);
+		if (m_Animated)
+			m_Context->PSSetShaderResources(0, m_CacheTargetCount, m_CacheViews);
+
+		m_CacheDrawn = true;
+	}
+
+	// Images that do not change over time are only drawn once, and copied to the back buffer for every frame after that
+	if (!m_Animated)
+		m_Context->CopyResource(m_BackBuffer, m_CacheTextures[0]);
+	else
+		m_Context->DrawIndexed(4, 0, 0);
+}
+void Graphics::PresentFrame(const uint8_t* rgba)
+{
+	D3D11_TEXTURE2D_DESC td = {};
+	m_BackBuffer->GetDesc(&td);
+
+	// Created on first use, with the size and format of the back buffer so that it can be copied
+	if (!m_FrameTexture)
+	{
+		td.MipLevels = 1;
+		td.ArraySize = 1;
+		td.SampleDesc = { .Count = 1, .Quality = 0 };
+		td.Usage = D3D11_USAGE_DYNAMIC;
+		td.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		td.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		td.MiscFlags = 0;
+		ASSERT_WINDOWS(m_Device->CreateTexture2D(&td, nullptr, &m_FrameTexture), "could not create frame texture");
+	}
+
+	// Rows of the mapped texture may be padded
+	D3D11_MAPPED_SUBRESOURCE msr = {};
+	ASSERT_WINDOWS(m_Context->Map(m_FrameTexture, 0, D3D11_MAP_WRITE_DISCARD, 0, &msr), "could not map frame texture");
+	for (UINT y = 0; y < td.Height; y++)
+		memcpy(static_cast<uint8_t*>(msr.pData) + size_t(y) * msr.RowPitch, rgba + 4 * size_t(y) * td.Width, 4 * size_t(td.Width));
+	m_Context->Unmap(m_FrameTexture, 0);
+
+	m_Context->CopyResource(m_BackBuffer, m_FrameTexture);
 }
 void Graphics::SwapBuffers() const
 {
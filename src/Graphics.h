@@ -1,18 +1,42 @@
 #pragma once
 
+#include <vector>
+#include <cstdint>
 #include <Windows.h>
 #include <d3d11.h>
 
+#include "Shader.h"
+#include "KernelCache.h"
+
+// Bytecode of the passes of a split shader, which can be compiled on any thread before the shaders are created
+struct CompiledShaders
+{
+	SplitShaderCode code;
+	std::vector<uint8_t> cache; // Empty if the split shader has no cache pass
+	std::vector<uint8_t> frame;
+};
+
 class Graphics
 {
 public:
-	Graphics(int width, int height, const char* shaderPtr, int shaderSize);
+	Graphics(int width, int height, const SplitShaderCode& shaders);
 	~Graphics();
 
 	bool UpdateInputs() const;
+	// Draw every frame with a single pixel shader
 	void CreatePixelShader(const void* shaderPtr, int shaderSize);
+	// Draw with the two passes of a split shader, the cache pass being drawn once, before the next frame
+	void CreatePixelShaders(const SplitShaderCode& shaders);
+	void CreatePixelShaders(const CompiledShaders& shaders);
+	// Compile the passes of a split shader without creating them, which is safe on any thread while this object is alive
+	// Unoptimized shaders compile much faster, and can be drawn while the optimized ones are compiled
+	CompiledShaders CompilePixelShaders(const SplitShaderCode& shaders, bool optimized = true) const;
+	// Whether optimized shaders are compiled differently from unoptimized ones, which is not the case in Debug builds or at level 0
+	bool HasOptimizedTier() const;
 	void UpdateConstantBuffer(float x, float y, float z, float w) const;
 	void DrawViewportQuad() const;
+	// Show an image of 4 bytes per pixel (rows from top to bottom, the size of the window) instead of drawing a pixel shader
+	void PresentFrame(const uint8_t* rgba);
 	void SwapBuffers() const;
 
 private:
@@ -25,12 +49,37 @@ private:
 	ID3D11Device* m_Device = nullptr;
 	ID3D11DeviceContext* m_Context = nullptr;
 	ID3D11Buffer* m_ConstantBuffer = nullptr;
+	ID3D11Texture2D* m_BackBuffer = nullptr;
+	ID3D11RenderTargetView* m_BackBufferView = nullptr;
+
+	// Pixel shaders
+	ID3D11PixelShader* m_FrameShader = nullptr;
+	ID3D11PixelShader* m_CacheShader = nullptr;
+	bool m_Animated = true;
+	mutable bool m_CacheDrawn = false;
+
+	// Values that do not depend on time, or the whole image if nothing does
+	int m_CacheTargetCount = 0;
+	ID3D11Texture2D* m_CacheTextures[MaxCacheTargets] = {};
+	ID3D11RenderTargetView* m_CacheTargets[MaxCacheTargets] = {};
+	ID3D11ShaderResourceView* m_CacheViews[MaxCacheTargets] = {};
+
+	// Compiled pixel shaders kept between runs, so that seeds seen before skip D3DCompile
+	KernelCache m_ShaderCache = KernelCache(KernelCache::GetDefaultDirectory());
+
+	// Images uploaded from the CPU, such as frames played back from a loop cache
+	ID3D11Texture2D* m_FrameTexture = nullptr;
 
 	void CreateQuad();
 	void CreateBlendingMode();
 	void CreateIndexBuffer();
 	void CreateConstantBuffer();
 	void CreateVertexShader();
+	// A structural hash of 0 finds the compiled shader in the cache by its source alone
+	std::vector<uint8_t> CompileBytecode(const void* shaderPtr, int shaderSize, uint64_t programHash, int optimizationLevel) const;
+	ID3D11PixelShader* CreatePixelShaderObject(const std::vector<uint8_t>& bytecode) const;
+	void CreateCacheTargets(int count, DXGI_FORMAT format);
+	void ReleasePixelShaders();
 
 	static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 };
@@ -0,0 +1,49 @@
+#include "Image.h"
+
+#include <cstdio>
+#include <vector>
+
+bool WritePPM(const char* path, int width, int height, const uint8_t* rgba)
+{
+	FILE* file = std::fopen(path, "wb");
+	if (!file)
+		return false;
+
+	std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+	std::vector<uint8_t> row(3 * size_t(width));
+	bool ok = true;
+	for (int y = 0; y < height && ok; y++)
+	{
+		const uint8_t* src = rgba + 4 * size_t(y) * size_t(width);
+		for (int x = 0; x < width; x++)
+		{
+			row[3 * x + 0] = src[4 * x + 0];
+			row[3 * x + 1] = src[4 * x + 1];
+			row[3 * x + 2] = src[4 * x + 2];
+		}
+		ok = std::fwrite(row.data(), 1, row.size(), file) == row.size();
+	}
+
+	return std::fclose(file) == 0 && ok;
+}
+
+bool WritePFM(const char* path, int width, int height, const float* rgb)
+{
+	FILE* file = std::fopen(path, "wb");
+	if (!file)
+		return false;
+
+	// Negative scale means little endian
+	std::fprintf(file, "PF\n%d %d\n-1.0\n", width, height);
+
+	// PFM stores rows from bottom to top
+	bool ok = true;
+	for (int y = height - 1; y >= 0 && ok; y--)
+	{
+		const float* src = rgb + 3 * size_t(y) * size_t(width);
+		ok = std::fwrite(src, sizeof(float), 3 * size_t(width), file) == 3 * size_t(width);
+	}
+
+	return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Write a buffer of 4 bytes per pixel (rows from top to bottom) as a binary PPM image, dropping the alpha channel
+bool WritePPM(const char* path, int width, int height, const uint8_t* rgba);
+// Write a buffer of 3 floats per pixel (rows from top to bottom) as a PFM image
+bool WritePFM(const char* path, int width, int height, const float* rgb);
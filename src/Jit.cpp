@@ -0,0 +1,301 @@
+#include "Jit.h"
+
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <process.h>
+#else
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+#include "Shader.h"
+#include "Simd.h"
+#include "KernelCache.h"
+
+#pragma region Kernel source
+
+// Definitions that let the HLSL primitive functions compile as C++
+static constexpr char kernelPrelude[] =
+R"(
+#include <cmath>
+
+#ifdef _WIN32
+#define KERNEL_EXPORT extern "C" __declspec(dllexport)
+#else
+#define KERNEL_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+// Float overloads of the HLSL intrinsics
+using std::sqrt;
+using std::pow;
+using std::exp2;
+using std::cos;
+using std::tan;
+using std::abs;
+
+struct float2
+{
+	float x, y;
+};
+
+struct float3
+{
+	float x, y, z;
+
+	float3() = default;
+	float3(float x, float y, float z) : x(x), y(y), z(z) {}
+};
+
+static inline float3 operator+(float3 a, float3 b) { return float3(a.x + b.x, a.y + b.y, a.z + b.z); }
+static inline float3 operator-(float3 a, float3 b) { return float3(a.x - b.x, a.y - b.y, a.z - b.z); }
+static inline float3 operator-(float a, float3 b) { return float3(a - b.x, a - b.y, a - b.z); }
+static inline float3 operator-(float3 a) { return float3(-a.x, -a.y, -a.z); }
+
+// HLSL ldexp takes a float exponent
+static inline float ldexp(float x, float e)
+{
+	return x * exp2(e);
+}
+
+static inline float3 lerp(float3 a, float3 b, float3 t)
+{
+	return float3(a.x + t.x * (b.x - a.x), a.y + t.y * (b.y - a.y), a.z + t.z * (b.z - a.z));
+}
+
+static inline float3 step(float e, float3 x)
+{
+	return float3(x.x >= e ? 1.0f : 0.0f, x.y >= e ? 1.0f : 0.0f, x.z >= e ? 1.0f : 0.0f);
+}
+)";
+
+// Same as the main function of the pixel shader, evaluated for blocks of pixels along a row
+// The whole expression is inlined into the loop over a block, which the compiler vectorizes, calling the vector versions of cos and pow
+// Inputs that are the same for the whole row are read from arrays anyway, so that branches on them become selects instead of preventing vectorization
+static constexpr char kernelFunction[] =
+R"(
+KERNEL_EXPORT __attribute__((flatten)) void PollockRow(const void* context, int width, int height, int row, int x0, int count, float rowSinTime, float rowCosTime, float* out)
+{
+	alignas(64) float rowY[BLOCK_SIZE];
+	alignas(64) float sinTimes[BLOCK_SIZE];
+	alignas(64) float cosTimes[BLOCK_SIZE];
+	alignas(64) float block[3][BLOCK_SIZE];
+
+	for (int i = 0; i < BLOCK_SIZE; i++)
+	{
+		rowY[i] = 1.0f - (float(row) + 0.5f) / float(height);
+		sinTimes[i] = rowSinTime;
+		cosTimes[i] = rowCosTime;
+	}
+
+	for (int px0 = 0; px0 < count; px0 += BLOCK_SIZE)
+	{
+		for (int i = 0; i < BLOCK_SIZE; i++)
+		{
+			float2 uv;
+			uv.x = (float(x0 + px0 + i) + 0.5f) / float(width);
+			uv.y = rowY[i];
+			float invX = 1.0f - uv.x;
+			float invY = 1.0f - uv.y;
+			float sinTime = sinTimes[i];
+			float cosTime = cosTimes[i];
+@LOCALS@
+			float3 rgb = float3(@RGB@);
+			rgb = @MASK@;
+
+			block[0][i] = rgb.x;
+			block[1][i] = rgb.y;
+			block[2][i] = rgb.z;
+		}
+
+		// The last block may run past the end of the span, those pixels are discarded
+		const int blockCount = count - px0 < BLOCK_SIZE ? count - px0 : BLOCK_SIZE;
+		for (int i = 0; i < blockCount; i++)
+		{
+			out[3 * (px0 + i) + 0] = block[0][i];
+			out[3 * (px0 + i) + 1] = block[1][i];
+			out[3 * (px0 + i) + 2] = block[2][i];
+		}
+	}
+}
+)";
+
+#pragma endregion
+
+std::string GenerateKernelSource(const Program& program)
+{
+	const ProgramSource source = GenerateProgramSource(program, "\t\t\t");
+
+	std::string function = kernelFunction;
+	function.replace(function.find("@MASK@"), 6, source.mask);
+	function.replace(function.find("@RGB@"), 5, source.channels);
+	function.replace(function.find("@LOCALS@"), 8, source.locals);
+
+	return kernelPrelude + ("\n#define BLOCK_SIZE " + std::to_string(BlockSize) + "\n") + GetFunctionDefinitions() + function;
+}
+
+#pragma region Compilation
+
+static std::string ReadFile(const std::filesystem::path& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::stringstream text;
+	text << file.rdbuf();
+	return text.str();
+}
+
+// Compile the source into a shared library, and return the reason if that failed
+static std::string CompileLibrary(const std::string& compiler, const std::string& flags, const std::string& source,
+	const std::filesystem::path& sourcePath, const std::filesystem::path& logPath, const std::filesystem::path& libraryPath)
+{
+	{
+		std::ofstream file(sourcePath);
+		file << source;
+		if (!file)
+			return "Could not write " + sourcePath.string();
+	}
+
+	// libm is linked explicitly, because the compiler may replace loops over cos and pow with calls to its vector versions
+	std::string command = "\"" + compiler + "\" " + flags + " -std=c++17 -shared -fPIC -fvisibility=hidden"
+		+ " -o \"" + libraryPath.string() + "\" \"" + sourcePath.string() + "\" -lm > \"" + logPath.string() + "\" 2>&1";
+#ifdef _WIN32
+	// cmd.exe strips the outermost pair of quotes
+	command = "\"" + command + "\"";
+#endif
+
+	std::error_code error;
+	const int status = std::system(command.c_str());
+	const std::string log = ReadFile(logPath);
+	std::filesystem::remove(sourcePath, error);
+	std::filesystem::remove(logPath, error);
+
+	if (status != 0)
+	{
+		std::filesystem::remove(libraryPath, error);
+		return "Compiler failed: " + command + "\n" + log;
+	}
+
+	return std::string();
+}
+
+JitKernel::JitKernel(const Expression& expression, const JitOptions& options)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::string compiler = options.compiler;
+	if (compiler.empty())
+	{
+		const char* cxx = std::getenv("CXX");
+		compiler = cxx && *cxx ? cxx : "c++";
+	}
+
+	// Several kernels can be compiled at once, by different threads or processes
+	static std::atomic<int> counter = 0;
+#ifdef _WIN32
+	const int pid = _getpid();
+	const char* extension = ".dll";
+#else
+	const int pid = int(getpid());
+	const char* extension = ".so";
+#endif
+
+	std::error_code error;
+	std::filesystem::path directory = options.directory.empty() ? std::filesystem::temp_directory_path(error) : std::filesystem::path(options.directory);
+	const std::string name = "pollock_" + std::to_string(expression.seed) + "_" + std::to_string(pid) + "_" + std::to_string(counter++);
+	const std::filesystem::path sourcePath = directory / (name + ".cpp");
+	const std::filesystem::path logPath = directory / (name + ".log");
+	const std::filesystem::path libraryPath = directory / (name + extension);
+
+	// Kernels are cached by the structure of the expression and the compiler settings, and only loaded if their source is the same
+	const KernelCache cache(options.cacheDirectory);
+	const Program program = BuildProgram(expression);
+	const std::string kernelSource = GenerateKernelSource(program);
+	const uint64_t cacheKey = KernelCache::MakeKey(HashProgram(program), compiler + " " + options.flags + extension);
+	const uint64_t sourceHash = KernelCache::HashSource(kernelSource.data(), kernelSource.size());
+
+	std::vector<uint8_t> cached;
+	if (cache.Load(cacheKey, sourceHash, cached))
+	{
+		std::ofstream library(libraryPath, std::ios::binary);
+		library.write(reinterpret_cast<const char*>(cached.data()), std::streamsize(cached.size()));
+		if (!library)
+		{
+			m_Error = "Could not write " + libraryPath.string();
+			return;
+		}
+		m_FromCache = true;
+	}
+	else
+	{
+		m_Error = CompileLibrary(compiler, options.flags, kernelSource, sourcePath, logPath, libraryPath);
+		if (!m_Error.empty())
+			return;
+
+		if (cache.IsEnabled())
+		{
+			const std::string library = ReadFile(libraryPath);
+			cache.Store(cacheKey, sourceHash, library.data(), library.size());
+		}
+	}
+
+	m_LibraryPath = libraryPath.string();
+
+#ifdef _WIN32
+	HMODULE library = LoadLibraryA(m_LibraryPath.c_str());
+	m_Library = library;
+	if (library)
+		m_RowFunction = reinterpret_cast<RowFunction>(GetProcAddress(library, "PollockRow"));
+	else
+		m_Error = "Could not load " + m_LibraryPath;
+#else
+	m_Library = dlopen(m_LibraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (m_Library)
+		m_RowFunction = reinterpret_cast<RowFunction>(dlsym(m_Library, "PollockRow"));
+	else
+		m_Error = dlerror();
+#endif
+
+	if (m_Library && !m_RowFunction)
+		m_Error = "PollockRow not found in " + m_LibraryPath;
+
+	auto end = std::chrono::high_resolution_clock::now();
+	m_CompileMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+JitKernel::~JitKernel()
+{
+	if (m_Library)
+	{
+#ifdef _WIN32
+		FreeLibrary(HMODULE(m_Library));
+#else
+		dlclose(m_Library);
+#endif
+	}
+
+	std::error_code error;
+	if (!m_LibraryPath.empty())
+		std::filesystem::remove(m_LibraryPath, error);
+}
+
+BackgroundJitKernel::BackgroundJitKernel(const Expression& expression, const JitOptions& options)
+{
+	m_Thread = std::thread([this, expression, options]()
+	{
+		m_Kernel = std::make_unique<JitKernel>(expression, options);
+		m_Ready.store(true, std::memory_order_release);
+	});
+}
+
+BackgroundJitKernel::~BackgroundJitKernel()
+{
+	m_Thread.join();
+}
+
+#pragma endregion
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+
+#include "Expression.h"
+#include "Program.h"
+
+// Settings used to compile the generated C++ source
+struct JitOptions
+{
+	std::string compiler; // Empty uses the CXX environment variable, or c++ if it is not set
+	std::string flags = "-O3 -march=native -ffast-math";
+	std::string directory; // Where the temporary files are written, empty uses the system temporary directory
+	std::string cacheDirectory; // Where compiled kernels are kept between runs (see KernelCache), empty compiles every kernel
+};
+
+// Native code for a single expression, built by the system C++ compiler and loaded as a shared library
+// Compiling takes a few hundred milliseconds, which pays off for large images and long batches
+class JitKernel
+{
+public:
+	JitKernel(const Expression& expression, const JitOptions& options = JitOptions());
+	~JitKernel();
+
+	JitKernel(const JitKernel&) = delete;
+	JitKernel& operator=(const JitKernel&) = delete;
+
+	// Returns nullptr if compiling or loading failed, in which case GetError explains why
+	RowFunction GetRowFunction() const { return m_RowFunction; }
+	const std::string& GetError() const { return m_Error; }
+
+	// Time spent writing the source, compiling it and loading the library
+	double CompileMilliseconds() const { return m_CompileMilliseconds; }
+	// Whether the library was loaded from the kernel cache instead of being compiled
+	bool FromCache() const { return m_FromCache; }
+
+private:
+	void* m_Library = nullptr;
+	std::string m_LibraryPath;
+	RowFunction m_RowFunction = nullptr;
+	std::string m_Error;
+	double m_CompileMilliseconds = 0.0;
+	bool m_FromCache = false;
+};
+
+// Compiles a JitKernel on its own thread, so that rendering can start with block evaluation and switch to the kernel once it is done
+class BackgroundJitKernel
+{
+public:
+	BackgroundJitKernel(const Expression& expression, const JitOptions& options = JitOptions());
+	// Waits for the compiler to finish
+	~BackgroundJitKernel();
+
+	BackgroundJitKernel(const BackgroundJitKernel&) = delete;
+	BackgroundJitKernel& operator=(const BackgroundJitKernel&) = delete;
+
+	// Returns nullptr until compiling is done, and the kernel after that, even if it failed to compile
+	const JitKernel* TryGet() const { return m_Ready.load(std::memory_order_acquire) ? m_Kernel.get() : nullptr; }
+
+private:
+	std::unique_ptr<JitKernel> m_Kernel;
+	std::atomic<bool> m_Ready = false;
+	std::thread m_Thread;
+};
+
+// Generate a C++ translation unit with the primitive functions and a RowFunction named PollockRow, from the program of an expression (see BuildProgram)
+std::string GenerateKernelSource(const Program& program);
@@ -0,0 +1,176 @@
+#include "KernelCache.h"
+
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+
+#include "RandFS.h"
+
+// Start of every entry, followed by the compiled kernel
+struct KernelCacheHeader
+{
+	char magic[8];
+	uint64_t key;
+	uint64_t sourceHash;
+	uint64_t size;
+	uint64_t checksum; // Hash of the kernel, to reject entries that were damaged or only partly written
+};
+
+static constexpr char KernelCacheMagic[8] = { 'P', 'O', 'L', 'L', 'O', 'C', 'K', 'K' };
+static constexpr char KernelCacheExtension[] = ".pkc";
+
+KernelCache::KernelCache(const std::string& directory, uint64_t maxBytes)
+	: m_Directory(directory), m_MaxBytes(maxBytes)
+{
+	std::error_code error;
+	if (!m_Directory.empty())
+		std::filesystem::create_directories(m_Directory, error);
+}
+
+uint64_t KernelCache::MakeKey(uint64_t programHash, const std::string& settings)
+{
+	return Hash::UInt64(programHash, HashSource(settings.data(), settings.size()));
+}
+
+uint64_t KernelCache::HashSource(const void* source, size_t size)
+{
+	// Bytes64 reads 16 bytes per step and mixes in the size itself, which matters for whole generated sources
+	return Hash::Bytes64(source, uint64_t(size));
+}
+
+std::string KernelCache::GetDefaultDirectory()
+{
+	std::error_code error;
+	const std::filesystem::path temporary = std::filesystem::temp_directory_path(error);
+	return error ? std::string() : (temporary / "pollock_kernels").string();
+}
+
+std::string KernelCache::GetEntryPath(uint64_t key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+	return (std::filesystem::path(m_Directory) / (std::string(name) + KernelCacheExtension)).string();
+}
+
+bool KernelCache::Load(uint64_t key, uint64_t sourceHash, std::vector<uint8_t>& data) const
+{
+	if (!IsEnabled())
+		return false;
+
+	const std::string path = GetEntryPath(key);
+	FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	KernelCacheHeader header;
+	bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+		&& std::memcmp(header.magic, KernelCacheMagic, sizeof(header.magic)) == 0
+		&& header.key == key
+		&& header.size <= m_MaxBytes;
+
+	if (ok)
+	{
+		data.resize(size_t(header.size));
+		ok = std::fread(data.data(), 1, data.size(), file) == data.size() && std::fgetc(file) == EOF
+			&& HashSource(data.data(), data.size()) == header.checksum;
+	}
+	std::fclose(file);
+
+	std::error_code error;
+	if (!ok)
+	{
+		// Damaged entries would fail the same way every time
+		std::filesystem::remove(path, error);
+		return false;
+	}
+
+	// Entries compiled from different source are left for eviction, the key will be stored again with the new source
+	if (header.sourceHash != sourceHash)
+		return false;
+
+	// The modification time of an entry is the last time it was used
+	std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+	return true;
+}
+
+bool KernelCache::Store(uint64_t key, uint64_t sourceHash, const void* data, size_t size) const
+{
+	if (!IsEnabled() || size > m_MaxBytes)
+		return false;
+
+	KernelCacheHeader header = {};
+	std::memcpy(header.magic, KernelCacheMagic, sizeof(header.magic));
+	header.key = key;
+	header.sourceHash = sourceHash;
+	header.size = size;
+	header.checksum = HashSource(data, size);
+
+	// Written to a temporary file first, so that other threads and processes never load a partial entry
+	static std::atomic<int> counter = 0;
+	const std::string path = GetEntryPath(key);
+	const std::string temporaryPath = path + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+		+ "_" + std::to_string(counter++) + ".tmp";
+
+	FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+	if (!file)
+		return false;
+
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 && std::fwrite(data, 1, size, file) == size;
+	ok = std::fclose(file) == 0 && ok;
+
+	std::error_code error;
+	if (ok)
+		std::filesystem::rename(temporaryPath, path, error);
+	if (!ok || error)
+	{
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	Evict();
+	return true;
+}
+
+void KernelCache::Evict() const
+{
+	struct Entry
+	{
+		std::filesystem::path path;
+		std::filesystem::file_time_type lastUse;
+		uint64_t size;
+	};
+
+	std::vector<Entry> entries;
+	uint64_t total = 0ULL;
+
+	std::error_code error;
+	for (const std::filesystem::directory_entry& file : std::filesystem::directory_iterator(m_Directory, error))
+	{
+		if (file.path().extension() != KernelCacheExtension)
+			continue;
+
+		Entry entry = { file.path(), file.last_write_time(error), file.file_size(error) };
+		if (error)
+			continue;
+
+		total += entry.size;
+		entries.push_back(entry);
+	}
+
+	if (total <= m_MaxBytes)
+		return;
+
+	// Least recently used first
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+
+	for (const Entry& entry : entries)
+	{
+		if (total <= m_MaxBytes)
+			break;
+		if (std::filesystem::remove(entry.path, error))
+			total -= entry.size;
+	}
+}
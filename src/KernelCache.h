@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Directory of compiled kernels kept between runs, such as pixel shader bytecode or JIT libraries
+// Each entry is a file named after its key, holding the hash of the source it was compiled from and a checksum of its contents,
+// so that entries compiled from different source, or damaged on disk, are treated as missing instead of being loaded
+// Loading an entry marks it as recently used, and storing one removes the least recently used entries beyond the size limit
+class KernelCache
+{
+public:
+	// An empty directory disables the cache, so that every lookup misses and nothing is stored
+	explicit KernelCache(const std::string& directory, uint64_t maxBytes = DefaultMaxBytes);
+
+	// Key of a kernel, from the structural hash of its program (see HashProgram) and a description of every setting
+	// that changes the compiled code, such as the compiler, its flags and the kind of kernel
+	static uint64_t MakeKey(uint64_t programHash, const std::string& settings);
+	// Hash of the exact source passed to the compiler, which every entry must match to be loaded
+	static uint64_t HashSource(const void* source, size_t size);
+
+	// Returns false if there is no valid entry for the key and source
+	bool Load(uint64_t key, uint64_t sourceHash, std::vector<uint8_t>& data) const;
+	// Returns false if the entry could not be written, which only means that the kernel will be compiled again next time
+	bool Store(uint64_t key, uint64_t sourceHash, const void* data, size_t size) const;
+
+	const std::string& GetDirectory() const { return m_Directory; }
+	bool IsEnabled() const { return !m_Directory.empty(); }
+
+	// Subdirectory of the system temporary directory, used when nothing else is given
+	static std::string GetDefaultDirectory();
+	static constexpr uint64_t DefaultMaxBytes = 256ULL << 20;
+
+private:
+	std::string m_Directory;
+	uint64_t m_MaxBytes;
+
+	std::string GetEntryPath(uint64_t key) const;
+	void Evict() const;
+};
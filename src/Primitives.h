@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cmath>
+
+// C++ versions of the primitive functions used by the generated shaders
+// These must match the HLSL definitions in Shader.cpp exactly, so that the CPU renders the same images
+
+#pragma region 1 input
+
+inline float fInv(float x)
+{
+	return 1.0f - x;
+}
+
+inline float fSqr(float x)
+{
+	return x * x;
+}
+
+inline float fSqrt(float x)
+{
+	return std::sqrt(x);
+}
+
+inline float fSmooth(float x)
+{
+	float x2 = x * x;
+	float x3 = x2 * x;
+	return x2 + x2 + x2 - x3 - x3;
+}
+
+inline float fSharp(float x)
+{
+	return x * (x * (x + x - 3.0f) + 2.0f);
+}
+
+#pragma endregion
+
+#pragma region 2 inputs
+
+inline float fAdd(float x, float y)
+{
+	float res = x + y;
+	if (res > 1.0f)
+		return 2.0f - res;
+	return res;
+}
+
+inline float fSub(float x, float y)
+{
+	float res = x - y;
+	if (res < 0.0f)
+		return -res;
+	return res;
+}
+
+inline float fMul(float x, float y)
+{
+	return x * y;
+}
+
+inline float fDiv(float x, float y)
+{
+	float min = x, max = y;
+	if (x > y)
+	{
+		min = y;
+		max = x;
+	}
+	if (max < 0.0001f)
+		max = 0.0001f;
+	return min / max;
+}
+
+inline float fAvg(float x, float y)
+{
+	return (x + y) * 0.5f;
+}
+
+inline float fGeom(float x, float y)
+{
+	return std::sqrt(x * y);
+}
+
+inline float fHarm(float x, float y)
+{
+	float den = x + y;
+	if (den < 0.0001f)
+		den = 0.0001f;
+	return (2.0f * x * y) / den;
+}
+
+inline float fHypo(float x, float y)
+{
+	return 0.70710678f * std::sqrt(x * x + y * y); // Scale by 1 / sqrt(2)
+}
+
+inline float fMin(float x, float y)
+{
+	return x < y ? x : y;
+}
+
+inline float fMax(float x, float y)
+{
+	return x > y ? x : y;
+}
+
+inline float fPow(float x, float y)
+{
+	if (x < 0.01f)
+		x = 0.01f;
+	if (x > 0.99f)
+		x = 0.99f;
+	float exp = std::exp2(4.0f * y - 2.0f);
+	return std::pow(x, exp);
+}
+
+inline float fBell(float x, float y)
+{
+	if (x < 0.01f)
+		x = 0.01f;
+	if (x > 0.99f)
+		x = 0.99f;
+	float y2 = y * y;
+	return std::pow(4.0f * x * (1.0f - x), 20.0f * y2 * y2 + 0.3f);
+}
+
+inline float fWave(float x, float y)
+{
+	const float MAX_FREQUENCY = 6.0f * 3.1415927f;
+	return 0.5f + 0.5f * std::cos(MAX_FREQUENCY * x * y);
+}
+
+inline float fWaveDamp(float x, float y)
+{
+	const float FREQUENCY_FACTOR = 3.0f * 3.1415927f;
+	const float SHIFT_FACTOR = 1.0f / 6.0f;
+	// HLSL ldexp takes a float exponent, so it is written as a multiplication by exp2
+	float osc = std::cos(FREQUENCY_FACTOR * x * (y + SHIFT_FACTOR)) * std::exp2(-x * x);
+	return osc * osc;
+}
+
+#pragma endregion
+
+#pragma region 3 inputs
+
+inline float fLerp(float x, float y, float z)
+{
+	return (1.0f - z) * x + z * y;
+}
+
+inline float fSmoothLerp(float x, float y, float z)
+{
+	float z2 = z * z;
+	float z3 = z2 * z;
+	float smooth = z2 + z2 + z2 - z3 - z3;
+	return smooth * (y - x) + x;
+}
+
+inline float fMlerp(float x, float y, float z)
+{
+	if (x < 0.0001f)
+		x = 0.0001f;
+	if (y < 0.0001f)
+		y = 0.0001f;
+	return x * std::pow(y / x, z);
+}
+
+inline float fClamp(float x, float y, float z)
+{
+	float min = x, max = y;
+	if (x > y)
+	{
+		min = y;
+		max = x;
+	}
+	if (z < min)
+		return min;
+	else if (z > max)
+		return max;
+	return z;
+}
+
+#pragma endregion
+
+#pragma region 4 inputs
+
+inline float fDist(float x, float y, float z, float w)
+{
+	float dx = x - z;
+	float dy = y - w;
+	return 0.70710678f * std::sqrt(dx * dx + dy * dy); // Scale by 1 / sqrt(2)
+}
+
+inline float fDistLine(float x, float y, float z, float w)
+{
+	if (z < 0.499f)
+	{
+		float m = std::tan(z * 3.1415927f);
+		float n = (1.0f - w) * (1.0f + m) - m;
+		float c = (x + y * m - m * n) / (m * m + 1.0f);
+		float dx = c - x;
+		float dy = m * c + n - y;
+		return 0.70710678f * std::sqrt(dx * dx + dy * dy);
+	}
+	else if (z > 0.501f)
+	{
+		float m = std::tan(z * 3.1415927f);
+		float n = w - m * w;
+		float c = (x + y * m - m * n) / (m * m + 1.0f);
+		float dx = c - x;
+		float dy = m * c + n - y;
+		return 0.70710678f * std::sqrt(dx * dx + dy * dy);
+	}
+	else
+	{
+		return 0.70710678f * std::fabs(w - x);
+	}
+}
+
+#pragma endregion
+
+#pragma region Masks
+
+// Masks are applied to each color channel independently
+
+inline float fInv3(float v)
+{
+	return 1.0f - v;
+}
+
+inline float fAdd3(float v, float x)
+{
+	// Same as HLSL lerp(res, 2.0f - res, step(1.0f, res))
+	float res = v + x;
+	float t = res >= 1.0f ? 1.0f : 0.0f;
+	return res + t * ((2.0f - res) - res);
+}
+
+inline float fSub3(float v, float x)
+{
+	// Same as HLSL lerp(-res, res, step(0.0f, res))
+	float res = v - x;
+	float t = res >= 0.0f ? 1.0f : 0.0f;
+	return -res + t * (res + res);
+}
+
+#pragma endregion
@@ -0,0 +1,435 @@
+#include "Program.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Primitives.h"
+#include "RandFS.h"
+
+FrameInputs FrameInputs::AtTime(float seconds)
+{
+	FrameInputs frame;
+	frame.sinTime = 0.5f + 0.5f * std::sin(0.5f * seconds);
+	frame.cosTime = 0.5f + 0.5f * std::cos(0.5f * seconds);
+	return frame;
+}
+
+// Registers of the instructions already in the program, by structural hash
+typedef std::unordered_multimap<uint64_t, uint32_t> InstructionTable;
+
+static bool SameInstruction(const Instruction& a, const Instruction& b)
+{
+	if (a.op != b.op || std::memcmp(&a.value, &b.value, sizeof(float)) != 0)
+		return false;
+
+	for (int i = 0; i < GetOpInfo(a.op).arity; i++)
+		if (a.args[i] != b.args[i])
+			return false;
+
+	return true;
+}
+
+#pragma region Simplification
+
+// Evaluate the given operation on constant inputs, with the same functions as the reference implementation
+// Only operations with a single rounding step (besides exact scalings and comparisons) are folded, since those give the same result in every
+// backend and with any floating point settings, while longer formulas may be reordered or fused by the compiler of each backend,
+// and exp2, pow, cos and tan are approximated differently by the vectorized backends and by each graphics card
+static bool Fold(Op op, const float* x, float& result)
+{
+	switch (op)
+	{
+		case Op::Inv:   result = fInv(x[0]); break;
+		case Op::Sqr:   result = fSqr(x[0]); break;
+		case Op::Sqrt:  result = fSqrt(x[0]); break;
+
+		case Op::Add:   result = fAdd(x[0], x[1]); break;
+		case Op::Sub:   result = fSub(x[0], x[1]); break;
+		case Op::Mul:   result = fMul(x[0], x[1]); break;
+		case Op::Div:   result = fDiv(x[0], x[1]); break;
+		case Op::Avg:   result = fAvg(x[0], x[1]); break;
+		case Op::Min:   result = fMin(x[0], x[1]); break;
+		case Op::Max:   result = fMax(x[0], x[1]); break;
+
+		case Op::Clamp: result = fClamp(x[0], x[1], x[2]); break;
+
+		default: return false;
+	}
+
+	// Infinities and NaNs have no literal in the generated source
+	return std::isfinite(result);
+}
+
+// Try to replace the instruction with a constant, or with one of its inputs when the result always equals that input
+// Rewrites must hold for every possible input, so some that only hold approximately in floating point are left out:
+// fInv(fInv(x)) loses the low bits of small values, fLerp(x, x, t) is not exactly x, and fMul(x, c) changes x unless c is exactly 1
+// Returns true and sets 'reg' if the instruction reduces to an existing register
+static bool Simplify(const Program& program, Instruction& instruction, uint32_t& reg)
+{
+	const int arity = GetOpInfo(instruction.op).arity;
+	if (arity == 0)
+		return false;
+
+	float inputs[4];
+	bool constant = true;
+	for (int a = 0; a < arity; a++)
+	{
+		const Instruction& input = program.code[instruction.args[a]];
+		constant = constant && input.op == Op::Const;
+		inputs[a] = input.value;
+	}
+
+	float value;
+	if (constant && Fold(instruction.op, inputs, value))
+	{
+		instruction = Instruction();
+		instruction.value = value;
+		return false;
+	}
+
+	const uint32_t* args = instruction.args;
+	auto isOne = [&](uint32_t arg) { return program.code[arg].op == Op::Const && program.code[arg].value == 1.0f; };
+
+	switch (instruction.op)
+	{
+		// Comparisons of a value with itself always select that value, even if it is NaN
+		case Op::Min:
+		case Op::Max:
+			if (args[0] != args[1])
+				return false;
+			reg = args[0];
+			return true;
+
+		case Op::Mul:
+			if (isOne(args[1]))
+				reg = args[0];
+			else if (isOne(args[0]))
+				reg = args[1];
+			else
+				return false;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+// Remove the instructions that no longer contribute to the color, such as the inputs of folded constants
+static void RemoveDeadCode(Program& program)
+{
+	const uint32_t size = uint32_t(program.code.size());
+	std::vector<uint8_t> live(size);
+	for (int c = 0; c < 3; c++)
+		live[program.channels[c]] = 1;
+	for (const MaskStep& step : program.mask)
+		if (step.op != Op::Inv3)
+			live[step.arg] = 1;
+
+	// Instructions only use earlier registers, so a single backwards pass finds every live one
+	for (uint32_t i = size; i-- > 0U;)
+		if (live[i])
+			for (int a = 0; a < GetOpInfo(program.code[i].op).arity; a++)
+				live[program.code[i].args[a]] = 1;
+
+	std::vector<uint32_t> remap(size);
+	uint32_t count = 0U;
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		if (!live[i])
+			continue;
+
+		Instruction instruction = program.code[i];
+		for (int a = 0; a < GetOpInfo(instruction.op).arity; a++)
+			instruction.args[a] = remap[instruction.args[a]];
+		remap[i] = count;
+		program.code[count++] = instruction;
+	}
+
+	program.simplifiedCount += size - count;
+	program.code.resize(count);
+	for (int c = 0; c < 3; c++)
+		program.channels[c] = remap[program.channels[c]];
+	for (MaskStep& step : program.mask)
+		step.arg = remap[step.arg];
+}
+
+#pragma endregion
+
+// Append the subtree at the given node to the program in postorder, and return the register holding its result
+// The inputs of identical subtrees end up in the same registers, so comparing instructions is enough to find them
+static uint32_t Emit(const Expression& expression, uint32_t index, bool simplify, Program& program, InstructionTable& table)
+{
+	const Node& node = expression.nodes[index];
+
+	Instruction instruction;
+	instruction.op = node.op;
+	instruction.value = node.value;
+	for (int a = 0; a < GetOpInfo(node.op).arity; a++)
+		instruction.args[a] = Emit(expression, node.args[a], simplify, program, table);
+
+	uint32_t same;
+	if (simplify && Simplify(program, instruction, same))
+	{
+		program.simplifiedCount++;
+		return same;
+	}
+
+	uint32_t bits;
+	std::memcpy(&bits, &instruction.value, sizeof(bits));
+	const uint64_t key = Hash::UInt64(uint64_t(instruction.op), uint64_t(bits),
+		uint64_t(instruction.args[0]), uint64_t(instruction.args[1]), uint64_t(instruction.args[2]), uint64_t(instruction.args[3]));
+
+	auto range = table.equal_range(key);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		if (SameInstruction(program.code[it->second], instruction))
+		{
+			program.sharedCount++;
+			return it->second;
+		}
+	}
+
+	program.code.push_back(instruction);
+	const uint32_t reg = uint32_t(program.code.size() - 1);
+	table.emplace(key, reg);
+	return reg;
+}
+
+Program BuildProgram(const Expression& expression, bool simplify)
+{
+	Program program;
+	program.code.reserve(expression.nodes.size());
+	InstructionTable table;
+
+	// Color channels first
+	const uint32_t rgb = expression.RgbNode();
+	for (int c = 0; c < 3; c++)
+		program.channels[c] = Emit(expression, expression.nodes[rgb].args[c], simplify, program, table);
+
+	// Then the masks, which are nested with the innermost one closest to the color node
+	std::vector<uint32_t> chain;
+	for (uint32_t index = expression.root; index != rgb; index = expression.nodes[index].args[0])
+		chain.push_back(index);
+
+	for (auto it = chain.rbegin(); it != chain.rend(); it++)
+	{
+		const Node& node = expression.nodes[*it];
+
+		MaskStep step;
+		step.op = node.op;
+		if (node.op != Op::Inv3)
+			step.arg = Emit(expression, node.args[1], simplify, program, table);
+		program.mask.push_back(step);
+	}
+
+	if (simplify)
+		RemoveDeadCode(program);
+
+	return program;
+}
+
+uint64_t HashProgram(const Program& program)
+{
+	uint64_t hash = Hash::UInt64(uint64_t(program.code.size()), uint64_t(program.mask.size()));
+	for (const Instruction& in : program.code)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &in.value, sizeof(bits));
+		hash = Hash::UInt64(hash, uint64_t(in.op), uint64_t(bits), uint64_t(in.args[0]), uint64_t(in.args[1]), uint64_t(in.args[2]), uint64_t(in.args[3]));
+	}
+
+	hash = Hash::UInt64(hash, uint64_t(program.channels[0]), uint64_t(program.channels[1]), uint64_t(program.channels[2]));
+	for (const MaskStep& step : program.mask)
+		hash = Hash::UInt64(hash, uint64_t(step.op), uint64_t(step.arg));
+
+	return hash;
+}
+
+float EstimateCost(const Program& program)
+{
+	float cost = 0.0f;
+	for (const Instruction& in : program.code)
+		cost += GetOpInfo(in.op).cost;
+	for (const MaskStep& step : program.mask)
+		cost += GetOpInfo(step.op).cost;
+	return cost;
+}
+
+double EstimateFrameMilliseconds(float cost, int width, int height, int threadCount)
+{
+	return 1.0e-6 * double(PixelCost + cost) * CostUnitNanoseconds * double(width) * double(height) / double(threadCount > 0 ? threadCount : 1);
+}
+
+float GetFrameCostBudget(double milliseconds, int width, int height, int threadCount)
+{
+	const double perPixel = 1.0e6 * milliseconds * double(threadCount > 0 ? threadCount : 1) / (CostUnitNanoseconds * double(width) * double(height));
+	return std::max(float(perPixel) - PixelCost, 1.0f);
+}
+
+std::vector<uint8_t> FindInputs(const Program& program)
+{
+	std::vector<uint8_t> inputs(program.code.size());
+	for (uint32_t i = 0U; i < uint32_t(program.code.size()); i++)
+	{
+		const Instruction& in = program.code[i];
+		switch (in.op)
+		{
+			case Op::X:
+			case Op::InvX:
+				inputs[i] = InputX;
+				break;
+
+			case Op::Y:
+			case Op::InvY:
+				inputs[i] = InputY;
+				break;
+
+			case Op::SinTime:
+			case Op::CosTime:
+				inputs[i] = InputTime;
+				break;
+
+			default:
+				for (int a = 0; a < GetOpInfo(in.op).arity; a++)
+					inputs[i] |= inputs[in.args[a]];
+				break;
+		}
+	}
+	return inputs;
+}
+
+#pragma region Source generation
+
+// Append the source of the given register, referring to the locals of shared values and to named registers by name
+static void AppendSource(const Program& program, const std::vector<uint32_t>& useCounts, const std::vector<std::string>& names,
+	uint32_t reg, bool define, std::string& out)
+{
+	const Instruction& in = program.code[reg];
+	const OpInfo& info = GetOpInfo(in.op);
+
+	if (!names.empty() && !names[reg].empty())
+	{
+		out += names[reg];
+		return;
+	}
+
+	if (in.op == Op::Const)
+	{
+		// Generated constants are exact in 6 decimals, but folded ones need all 9 significant digits to keep their value
+		std::string text = std::to_string(in.value);
+		if (std::strtof(text.c_str(), nullptr) != in.value)
+		{
+			char digits[32];
+			std::snprintf(digits, sizeof(digits), "%.8e", double(in.value));
+			text = digits;
+		}
+		out += text;
+		out += 'f';
+		return;
+	}
+
+	if (info.arity == 0)
+	{
+		out += info.name;
+		return;
+	}
+
+	if (useCounts[reg] > 1U && !define)
+	{
+		out += 'v';
+		out += std::to_string(reg);
+		return;
+	}
+
+	out += info.name;
+	out += '(';
+	for (int a = 0; a < info.arity; a++)
+	{
+		if (a > 0)
+			out += ", ";
+		AppendSource(program, useCounts, names, in.args[a], false, out);
+	}
+	out += ')';
+}
+
+RegisterSource GenerateRegisterSource(const Program& program, const std::vector<uint32_t>& registers, const char* indent,
+	const std::vector<std::string>& names)
+{
+	// Count the uses of every value that the requested registers need, without looking inside named registers
+	const uint32_t size = uint32_t(program.code.size());
+	std::vector<uint32_t> useCounts(size);
+	std::vector<uint8_t> needed(size);
+	for (uint32_t reg : registers)
+	{
+		useCounts[reg]++;
+		needed[reg] = 1;
+	}
+
+	for (uint32_t i = size; i-- > 0U;)
+	{
+		if (!needed[i] || (!names.empty() && !names[i].empty()))
+			continue;
+
+		const Instruction& in = program.code[i];
+		for (int a = 0; a < GetOpInfo(in.op).arity; a++)
+		{
+			useCounts[in.args[a]]++;
+			needed[in.args[a]] = 1;
+		}
+	}
+
+	RegisterSource source;
+
+	// Instructions are in postorder, so every local is declared before it is used
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		if (useCounts[i] < 2U || GetOpInfo(program.code[i].op).arity == 0 || (!names.empty() && !names[i].empty()))
+			continue;
+
+		source.locals += indent;
+		source.locals += "float v" + std::to_string(i) + " = ";
+		AppendSource(program, useCounts, names, i, true, source.locals);
+		source.locals += ";\n";
+	}
+
+	for (uint32_t reg : registers)
+	{
+		source.values.emplace_back();
+		AppendSource(program, useCounts, names, reg, false, source.values.back());
+	}
+
+	return source;
+}
+
+ProgramSource GenerateProgramSource(const Program& program, const char* indent, const std::vector<std::string>& names)
+{
+	// The three channels, followed by the inputs of the masks
+	std::vector<uint32_t> registers(program.channels, program.channels + 3);
+	for (const MaskStep& step : program.mask)
+		if (step.op != Op::Inv3)
+			registers.push_back(step.arg);
+
+	RegisterSource values = GenerateRegisterSource(program, registers, indent, names);
+
+	ProgramSource source;
+	source.locals = std::move(values.locals);
+	source.channels = values.values[0] + ", " + values.values[1] + ", " + values.values[2];
+
+	source.mask = "rgb";
+	size_t next = 3;
+	for (const MaskStep& step : program.mask)
+	{
+		source.mask = std::string(GetOpInfo(step.op).name) + "(" + source.mask;
+		if (step.op != Op::Inv3)
+			source.mask += ", " + values.values[next++];
+		source.mask += ")";
+	}
+
+	return source;
+}
+
+#pragma endregion
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Expression.h"
+
+// One step of a program, which writes its result to the register with the same index as the instruction
+struct Instruction
+{
+	Op op = Op::Const;
+	float value = 0.0f; // Only used by Op::Const
+	uint32_t args[4] = {}; // Registers holding the inputs, only the first 'arity' are used
+};
+
+// One mask applied to the color after the three channels are computed
+struct MaskStep
+{
+	Op op = Op::Inv3; // Op::Inv3, Op::Add3 or Op::Sub3
+	uint32_t arg = 0U; // Register holding the scalar input (unused by Op::Inv3)
+};
+
+// Linear form of an expression, for evaluation on the CPU
+// Instructions are ordered so that every input is computed before it is used
+// Identical subtrees, within a channel or across channels and masks, are computed once and share a register
+struct Program
+{
+	std::vector<Instruction> code;
+	uint32_t channels[3] = {}; // Registers holding the red, green and blue channels
+	std::vector<MaskStep> mask; // Applied in order, from the innermost mask to the outermost
+
+	uint32_t sharedCount = 0U; // Nodes of the expression tree that reuse the register of an identical subtree
+	uint32_t simplifiedCount = 0U; // Nodes of the expression tree removed by constant folding and simplification
+};
+
+// Source code of a program, as HLSL or C++ with the primitive functions of Shader.cpp
+// Every value used more than once is bound to a local variable, declared before the color
+struct ProgramSource
+{
+	std::string locals; // One declaration per line, such as "float v12 = fDist(uv.x, uv.y, 0.5f, 0.3f);"
+	std::string channels; // Red, green and blue expressions, separated by commas
+	std::string mask; // Masked color, as an expression of 'rgb'
+};
+
+// Source code of some registers of a program, in the same form as ProgramSource
+struct RegisterSource
+{
+	std::string locals; // Declarations of the values used more than once
+	std::vector<std::string> values; // Expression of each requested register
+};
+
+// Inputs that a value can depend on, combined as bits
+static constexpr uint8_t InputX = 1; // uv.x or invX
+static constexpr uint8_t InputY = 2; // uv.y or invY
+static constexpr uint8_t InputTime = 4; // sinTime or cosTime
+
+// Time inputs of the generated shaders for a single frame
+struct FrameInputs
+{
+	float sinTime = 0.5f;
+	float cosTime = 1.0f;
+
+	// Compute the inputs for the given time in seconds, the same way main.cpp does
+	static FrameInputs AtTime(float seconds);
+};
+
+// Natively compiled function that evaluates 'count' pixels of a row, starting at column x0, into 3 floats per pixel (red, green, blue)
+// Row 0 is the top of the image, like in Render, and 'context' is whatever was registered along with the function
+typedef void (*RowFunction)(const void* context, int width, int height, int row, int x0, int count, float sinTime, float cosTime, float* rgb);
+
+// Flatten the expression tree into a program
+// Unless 'simplify' is false, constant subtrees are folded and operations that always return one of their inputs are removed,
+// in a way that does not change the result of any pixel
+Program BuildProgram(const Expression& expression, bool simplify = true);
+
+// Hash of the structure of a program, equal for every expression that flattens to the same instructions, channels and masks
+uint64_t HashProgram(const Program& program);
+
+// Rough time of one unit of cost (see OpInfo::cost) for one pixel on one thread, fitted to the render times of generated seeds
+// with the block evaluator and AVX2, which overlaps independent operations instead of waiting for each one like a chain does
+static constexpr double CostUnitNanoseconds = 0.05;
+// Cost paid by every pixel regardless of its program, to convert and write the color
+static constexpr float PixelCost = 19.0f;
+
+// Estimate the cost of evaluating one pixel of the program, as the sum of the costs of its instructions and masks
+// Shared registers are only counted once, like they are evaluated
+float EstimateCost(const Program& program);
+// Estimate how long a frame of the given size takes to render on the CPU with the given number of threads
+double EstimateFrameMilliseconds(float cost, int width, int height, int threadCount);
+// Largest cost whose frames are estimated to render within the given time, the inverse of EstimateFrameMilliseconds
+// Never less than 1, so that a budget too small for any expression still selects the cheapest ones
+float GetFrameCostBudget(double milliseconds, int width, int height, int threadCount);
+
+// Find the inputs that the value of each register depends on
+std::vector<uint8_t> FindInputs(const Program& program);
+
+// Generate the source of the given program, with every line of 'locals' starting with 'indent'
+// Registers with a name in 'names' (either empty or one entry per register) are not computed, and are referred to by that name instead
+ProgramSource GenerateProgramSource(const Program& program, const char* indent, const std::vector<std::string>& names = {});
+// Generate the source of the given registers only, with the same rules as GenerateProgramSource
+RegisterSource GenerateRegisterSource(const Program& program, const std::vector<uint32_t>& registers, const char* indent,
+	const std::vector<std::string>& names = {});
@@ -14,7 +14,8 @@ INCLUDE:
 		#include "RandFS.h"
 
 	Examples of usage and benchmarks are available at https://github.com/diegoquintanilha/RandFS/ (COMING SOON!)
-	The core PRNG of this library is based on Takuji Nishimura and Makoto Matsumoto's MT19937-64.
+	The core PRNG of this library is based on Takuji Nishimura and Makoto Matsumoto's MT19937-64,
+	with xoshiro256**, by David Blackman and Sebastiano Vigna, and PCG64, by Melissa O'Neill, as alternatives.
 	The core hash of this library is based on an implementation of CityHash, by Google, which can be found at http://code.google.com/p/cityhash/.
 
 EXAMPLE USAGE:
@@ -25,6 +26,16 @@ EXAMPLE USAGE:
 		int randomInteger = rand.IntBetween(5, 10);
 		float randomFloat = rand.FloatNormal();
 
+	The Random class draws from MT19937-64. To draw from another engine, give it to the BasicRandom class template,
+	which has the same member functions, along with any other arguments that the constructor of the engine takes:
+
+		BasicRandom<Xoshiro256> fastRand(42);
+		BasicRandom<Pcg64> streamRand(42, 7); // Seed 42 on stream 7
+
+	With C++20, both classes can also be used at compile time, except for the Jump of MT19937-64 and the Batch functions:
+
+		constexpr uint64_t seeds[3] = { Hash::UInt64(1ULL), Hash::UInt64(2ULL), Hash::UInt64(3ULL) };
+
 	To hash values using the Hash class, simply call any of its static member functions directly.
 	As a pure static class, it requires no instantiation. Just provide the value(s) you want to hash as arguments:
 
@@ -32,6 +43,14 @@ EXAMPLE USAGE:
 		int randomInteger = Hash::IntBetween(n, 5, 10);
 		float randomFloat = Hash::FloatNormal(n);
 
+	To hash long buffers, such as whole files, use Hash::Bytes64, or Hash::Stream64 when the buffer arrives in pieces.
+	They read 8-byte words in the native byte order, so their values differ between little- and big-endian machines:
+
+		Hash::Stream64 stream;
+		stream.Update(header, headerSize);
+		stream.Update(body, bodySize);
+		uint64_t h = stream.Digest(); // Same as Hash::Bytes64 of the header and body together
+
 	The example file at https://github.com/diegoquintanilha/RandFS/Examples/RandFS (COMING SOON!) demonstrates how to use most of the available functions
 
 ADDITIONAL CONFIGURATION:
@@ -40,6 +59,13 @@ ADDITIONAL CONFIGURATION:
 	or this:
 		#define RANDFS_NO_HASH
 	to suppress the implementation of either the Random class or the Hash class, respectively.
+
+	The state of the Random class is regenerated, the values of its Fill functions are tempered and the Batch functions
+	of the Hash class are computed with SSE2, AVX2 or AVX-512 instructions, whichever is the widest enabled by the
+	compiler flags (such as -mavx2, -march=native or /arch:AVX2), which gives the same values as the scalar code.
+	The intrinsics headers include the standard library, so RANDFS_NO_STD also disables them.
+	You can force the scalar code by doing this:
+		#define RANDFS_NO_SIMD
 	
 LICENSE:
 	See the end of file for license information.
@@ -117,63 +143,539 @@ static_assert(sizeof(int32_t) == sizeof(float), "RandFS requires int32_t and flo
 static_assert(std::numeric_limits<float>::is_iec559, "RandFS requires float types to follow the IEEE 754 standard.");
 #endif // RANDFS_NO_STD
 
+/*
+	The state of the Mersenne Twister is regenerated in groups of
+	RANDFS_SIMD_WIDTH words, using the widest instruction set that
+	the compiler is allowed to use. Every group only reads words
+	that are either not regenerated yet or regenerated by an earlier
+	group, so the result is exactly the same as the scalar loops.
+*/
+#if !defined(RANDFS_NO_SIMD) && !defined(RANDFS_NO_STD)
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define RANDFS_SIMD_WIDTH 8U
+#if defined(__AVX512DQ__)
+// Lanes of 64 bits can only be multiplied in one instruction with AVX-512DQ, which Hash::BatchUInt64 needs to be faster than scalar code
+#define RANDFS_SIMD_MUL64
+#endif
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define RANDFS_SIMD_WIDTH 4U
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RANDFS_SIMD_WIDTH 2U
+#endif
+#endif // RANDFS_NO_SIMD && RANDFS_NO_STD
+
+/*
+	With C++20, the functions that do not use SIMD instructions are constexpr, so that
+	tables of seeds, hashes or random values can be computed at compile time. The bit copies
+	between floats and integers are done with std::bit_cast instead of memcpy, which is not
+	allowed in constant expressions. Older standards get the same functions, as inline ones.
+	Integers are the same at compile time and at run time, but floats may differ in the last
+	bit if the compiler fuses a multiplication and an addition at run time (such as with FMA).
+*/
+#if !defined(RANDFS_NO_STD) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L)
+#include <bit> // For bit_cast
+#include <type_traits> // For is_constant_evaluated and is_trivially_copyable_v
+#endif
+#if defined(__cpp_lib_bit_cast) && defined(__cpp_lib_is_constant_evaluated)
+#define RANDFS_CONSTEXPR constexpr
+#define RANDFS_BIT_CAST
+// Whether the function is being evaluated at compile time, where SIMD instructions and intrinsics cannot be used
+#define RANDFS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define RANDFS_CONSTEXPR inline
+#define RANDFS_CONSTANT_EVALUATED() false
+#endif
+
+// Pcg64 needs the full 128-bit product of two 64-bit integers, which MSVC only offers as an intrinsic
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__) && !defined(RANDFS_NO_STD)
+#include <intrin.h>
+#define RANDFS_UMUL128
+#endif
+
 #pragma endregion
 
 #ifndef RANDFS_NO_RANDOM
 
+#pragma region Random engines declaration
+
+/*
+	The Random class takes its 64-bit values from an engine, which is one
+	of the following classes or any other with the same public members:
+	a constructor that takes a 64-bit seed, Next, Fill, Discard and Jump.
+
+	With C++20, all of them are constexpr except MersenneTwister64::Jump,
+	so a generator can be seeded and drawn from at compile time.
+*/
+
+// MT19937-64, by Takuji Nishimura and Makoto Matsumoto, with a period of 2^19937-1 and 2.5 KB of state
+// It is the engine of the Random class, and gives the same values as std::mt19937_64
+class MersenneTwister64
+{
+public:
+	// How the constructor turns the seed into the state
+	enum class Seeding
+	{
+		Full, // The original seeding of MT19937-64, which gives the same values as std::mt19937_64 and takes about as long as 200 draws
+		Lazy // Each word of the state is a hash of the seed and its position, computed only once a draw needs it, which makes the first draw over 10 times faster
+	};
+
+	// Both kinds of seeding give sequences of the same quality, but different ones for the same seed
+	RANDFS_CONSTEXPR MersenneTwister64(uint64_t seed = 0ULL, Seeding seeding = Seeding::Full);
+
+	// Generate the next 64-bit value
+	RANDFS_CONSTEXPR uint64_t Next();
+	// Fill the given array with the next 'count' values
+	RANDFS_CONSTEXPR void Fill(uint64_t* values, uint32_t count);
+	// Skip the next 'n' values, without computing them
+	RANDFS_CONSTEXPR void Discard(uint64_t n);
+	// Skip the next 2^128 values, in about a millisecond
+	void Jump();
+
+private:
+	uint64_t m_State[312]; // State array
+	uint32_t m_Index; // Array index counter
+	uint32_t m_End; // Words of the state generated so far, which is less than 312 only until a lazily seeded state is done
+	uint64_t m_Seed; // Seed of a lazily seeded state, for the words that are still needed
+
+	// Generate the next 312 words of the state, or the next few of a lazily seeded one
+	RANDFS_CONSTEXPR void Refill();
+	// Generate the next 312 words of the state at run time, with SIMD instructions if there are any
+	void Regenerate();
+	// Same as Fill at run time, with SIMD instructions if there are any
+	void FillTempered(uint64_t* values, uint32_t count);
+	// Word of a lazily seeded state at the given position, before it is regenerated for the first time
+	RANDFS_CONSTEXPR uint64_t SeedWord(uint32_t index) const;
+	// Generate the first words of a lazily seeded state that are not generated yet, the next few or all of them
+	RANDFS_CONSTEXPR void RefillSeeded(uint32_t end);
+	// Move the state as many words ahead as the given jump polynomial stands for (see MersenneTwister64::Jump)
+	void Jump(const uint64_t* polynomial);
+
+	// Turn a word of the state into an output value
+	static RANDFS_CONSTEXPR uint64_t Temper(uint64_t x)
+	{
+		x ^= (x >> 29) & 0x5555555555555555ULL;
+		x ^= (x << 17) & 0x71d67fffeda60000ULL;
+		x ^= (x << 37) & 0xfff7eee000000000ULL;
+		x ^= (x >> 43);
+		return x;
+	}
+
+#ifdef RANDFS_SIMD_WIDTH
+	// Regenerate RANDFS_SIMD_WIDTH consecutive words, given the words 156 positions away from them
+	static void TwistLanes(uint64_t* words, const uint64_t* far);
+	// Temper RANDFS_SIMD_WIDTH consecutive words into output values
+	static void TemperLanes(const uint64_t* words, uint64_t* values);
+#endif // RANDFS_SIMD_WIDTH
+};
+
+// xoshiro256**, by David Blackman and Sebastiano Vigna, with a period of 2^256-1 and 32 bytes of state
+// It is seeded in a few nanoseconds and is the fastest of these engines, but it can only skip far ahead with Jump
+class Xoshiro256
+{
+public:
+	// The four words of the state are the first four values of SplitMix64 from the seed, as its authors recommend
+	RANDFS_CONSTEXPR Xoshiro256(uint64_t seed = 0ULL);
+
+	// Generate the next 64-bit value
+	RANDFS_CONSTEXPR uint64_t Next();
+	// Fill the given array with the next 'count' values
+	RANDFS_CONSTEXPR void Fill(uint64_t* values, uint32_t count);
+	// Skip the next 'n' values, one at a time, so Jump is the way to move far ahead
+	RANDFS_CONSTEXPR void Discard(uint64_t n);
+	// Skip the next 2^128 values
+	RANDFS_CONSTEXPR void Jump();
+
+private:
+	uint64_t m_State[4]; // State words, never all zero
+
+	static RANDFS_CONSTEXPR uint64_t RotateLeft(uint64_t x, uint32_t k) { return (x << k) | (x >> (64U - k)); }
+};
+
+// PCG64 (PCG-XSL-RR 128/64), by Melissa O'Neill, with a period of 2^128 and 32 bytes of state
+// Its state is a 128-bit linear congruential generator, so it can skip any number of values in a few nanoseconds
+class Pcg64
+{
+public:
+	// Seed the generator on its default stream, the same as pcg64 in the reference implementation
+	RANDFS_CONSTEXPR Pcg64(uint64_t seed = 0ULL);
+	// Seed the generator on one of its 2^63 streams, which are different sequences, the same as pcg64(seed, stream) in the reference implementation
+	RANDFS_CONSTEXPR Pcg64(uint64_t seed, uint64_t stream);
+
+	// Generate the next 64-bit value
+	RANDFS_CONSTEXPR uint64_t Next();
+	// Fill the given array with the next 'count' values
+	RANDFS_CONSTEXPR void Fill(uint64_t* values, uint32_t count);
+	// Skip the next 'n' values, without computing them
+	RANDFS_CONSTEXPR void Discard(uint64_t n);
+	// Skip the next 2^64 values, since the whole period is 2^128
+	RANDFS_CONSTEXPR void Jump();
+
+private:
+	// Unsigned 128-bit integer, made of two 64-bit halves
+	struct UInt128
+	{
+		uint64_t high;
+		uint64_t low;
+	};
+
+	// Multiplier of the linear congruential generator
+	static constexpr UInt128 Multiplier = { 0x2360ed051fc65da4ULL, 0x4385df649fccf645ULL };
+
+	UInt128 m_State; // State of the linear congruential generator
+	UInt128 m_Increment; // Odd increment of the linear congruential generator, which selects the stream
+
+	// 128-bit arithmetic, modulo 2^128
+	static RANDFS_CONSTEXPR UInt128 Add(UInt128 a, UInt128 b);
+	static RANDFS_CONSTEXPR UInt128 Multiply(UInt128 a, UInt128 b);
+
+	// Move the state 'delta' steps ahead, with the jump-ahead algorithm of Brown (1994)
+	RANDFS_CONSTEXPR void Advance(UInt128 delta);
+};
+
+#pragma endregion
+
+#pragma region Random engines implementation (constexpr)
+
+// These members are defined in the header, since constexpr functions have to be defined wherever they are used
+
+RANDFS_CONSTEXPR MersenneTwister64::MersenneTwister64(uint64_t seed, Seeding seeding)
+	: m_State{}, m_Index(0U), m_End(0U), m_Seed(seed)
+{
+	// Nothing is generated until the first draw
+	if (seeding == Seeding::Lazy)
+		return;
+
+	// From Takuji Nishimura and Makoto Matsumoto's MT19937-64 implementation (see license at the end of file)
+
+	m_State[0] = seed;
+	for (m_Index = 1U; m_Index < 312U; m_Index++)
+	{
+		m_State[m_Index] = 0x5851f42d4c957f2dULL * (m_State[m_Index - 1U] ^ (m_State[m_Index - 1U] >> 62)) + m_Index;
+	}
+	m_End = 312U;
+}
+
+RANDFS_CONSTEXPR uint64_t MersenneTwister64::SeedWord(uint32_t index) const
+{
+	// SplitMix64, whose words are independent of each other, unlike those of the full seeding
+	uint64_t z = m_Seed + (uint64_t(index) + 1ULL) * 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+RANDFS_CONSTEXPR void MersenneTwister64::RefillSeeded(uint32_t end)
+{
+	constexpr uint64_t MS = 0xffffffff80000000ULL; // Most significant 33 bits
+	constexpr uint64_t LS = 0x7fffffffULL; // Least significant 31 bits
+
+	// The same as Refill, where the words that it would read before they are regenerated are computed from the seed instead
+	for (uint32_t i = m_End; i < end; i++)
+	{
+		const uint64_t x = (SeedWord(i) & MS) | ((i < 311U ? SeedWord(i + 1U) : m_State[0]) & LS);
+		m_State[i] = (i < 156U ? SeedWord(i + 156U) : m_State[i - 156U]) ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+	}
+	m_End = end;
+}
+
+RANDFS_CONSTEXPR void MersenneTwister64::Refill()
+{
+	// A lazily seeded state is generated 8 words at a time, as the draws reach them
+	if (m_End < 312U)
+	{
+		RefillSeeded(m_End + 8U < 312U ? m_End + 8U : 312U);
+		return;
+	}
+
+	if (!RANDFS_CONSTANT_EVALUATED())
+	{
+		Regenerate();
+		return;
+	}
+
+	// The same as Regenerate, one word at a time
+	constexpr uint64_t MS = 0xffffffff80000000ULL; // Most significant 33 bits
+	constexpr uint64_t LS = 0x7fffffffULL; // Least significant 31 bits
+
+	for (uint32_t i = 0U; i < 312U; i++)
+	{
+		const uint64_t x = (m_State[i] & MS) | (m_State[i < 311U ? i + 1U : 0U] & LS);
+		m_State[i] = m_State[i < 156U ? i + 156U : i - 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+	}
+	m_Index = 0U;
+}
+
+RANDFS_CONSTEXPR uint64_t MersenneTwister64::Next()
+{
+	// From Takuji Nishimura and Makoto Matsumoto's MT19937-64 implementation (see license at the end of file)
+
+	if (m_Index >= m_End) // Generate the next words of the state
+		Refill();
+
+	return Temper(m_State[m_Index++]);
+}
+
+RANDFS_CONSTEXPR void MersenneTwister64::Fill(uint64_t* values, uint32_t count)
+{
+	if (!RANDFS_CONSTANT_EVALUATED())
+	{
+		FillTempered(values, count);
+		return;
+	}
+
+	for (uint32_t i = 0U; i < count; i++)
+		values[i] = Next();
+}
+
+RANDFS_CONSTEXPR void MersenneTwister64::Discard(uint64_t n)
+{
+	// Words left in the state are skipped over and the others are regenerated a whole state at a time, without tempering them
+	while (n > 0ULL)
+	{
+		if (m_Index >= m_End)
+			Refill();
+
+		const uint32_t left = m_End - m_Index;
+		const uint32_t skip = n < left ? uint32_t(n) : left;
+		m_Index += skip;
+		n -= skip;
+	}
+}
+
+// From David Blackman and Sebastiano Vigna's reference implementation of xoshiro256** (public domain)
+
+RANDFS_CONSTEXPR Xoshiro256::Xoshiro256(uint64_t seed)
+{
+	for (uint32_t i = 0U; i < 4U; i++)
+	{
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		m_State[i] = z ^ (z >> 31);
+	}
+}
+
+RANDFS_CONSTEXPR uint64_t Xoshiro256::Next()
+{
+	const uint64_t result = RotateLeft(m_State[1] * 5ULL, 7U) * 9ULL;
+	const uint64_t t = m_State[1] << 17;
+
+	m_State[2] ^= m_State[0];
+	m_State[3] ^= m_State[1];
+	m_State[1] ^= m_State[2];
+	m_State[0] ^= m_State[3];
+	m_State[2] ^= t;
+	m_State[3] = RotateLeft(m_State[3], 45U);
+
+	return result;
+}
+
+RANDFS_CONSTEXPR void Xoshiro256::Fill(uint64_t* values, uint32_t count)
+{
+	for (uint32_t i = 0U; i < count; i++)
+		values[i] = Next();
+}
+
+RANDFS_CONSTEXPR void Xoshiro256::Discard(uint64_t n)
+{
+	for (; n > 0ULL; n--)
+		Next();
+}
+
+RANDFS_CONSTEXPR void Xoshiro256::Jump()
+{
+	// The state 2^128 steps ahead is a sum of the states up to 255 steps ahead, in the same way as for MT19937-64
+	constexpr uint64_t polynomial[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+	uint64_t sum[4] = { 0ULL, 0ULL, 0ULL, 0ULL };
+	for (uint32_t i = 0U; i < 4U; i++)
+	{
+		for (uint32_t bit = 0U; bit < 64U; bit++)
+		{
+			if ((polynomial[i] >> bit) & 1ULL)
+			{
+				for (uint32_t j = 0U; j < 4U; j++)
+					sum[j] ^= m_State[j];
+			}
+			Next();
+		}
+	}
+
+	for (uint32_t j = 0U; j < 4U; j++)
+		m_State[j] = sum[j];
+}
+
+// From Melissa O'Neill's reference implementation of PCG (see license at the end of file)
+
+RANDFS_CONSTEXPR Pcg64::Pcg64(uint64_t seed)
+	: m_State{ 0ULL, 0ULL }, m_Increment{ 0x5851f42d4c957f2dULL, 0x14057b7ef767814fULL }
+{
+	m_State = Add(UInt128{ 0ULL, seed }, m_Increment);
+	Next();
+}
+
+RANDFS_CONSTEXPR Pcg64::Pcg64(uint64_t seed, uint64_t stream)
+	: m_State{ 0ULL, 0ULL }, m_Increment{ stream >> 63, (stream << 1) | 1ULL }
+{
+	m_State = Add(UInt128{ 0ULL, seed }, m_Increment);
+	Next();
+}
+
+RANDFS_CONSTEXPR Pcg64::UInt128 Pcg64::Add(UInt128 a, UInt128 b)
+{
+	const uint64_t low = a.low + b.low;
+	return UInt128{ a.high + b.high + (low < a.low ? 1ULL : 0ULL), low };
+}
+
+RANDFS_CONSTEXPR Pcg64::UInt128 Pcg64::Multiply(UInt128 a, UInt128 b)
+{
+	// The high halves only multiply into the high half of the result, so only the product of the low halves needs all 128 bits
+	UInt128 result = { 0ULL, 0ULL };
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = static_cast<unsigned __int128>(a.low) * b.low;
+	result = UInt128{ uint64_t(product >> 64), uint64_t(product) };
+#else
+#ifdef RANDFS_UMUL128
+	// The intrinsic cannot be used at compile time
+	if (!RANDFS_CONSTANT_EVALUATED())
+		result.low = _umul128(a.low, b.low, &result.high);
+	else
+#endif // RANDFS_UMUL128
+	{
+		const uint64_t aLow = a.low & 0xffffffffULL, aHigh = a.low >> 32;
+		const uint64_t bLow = b.low & 0xffffffffULL, bHigh = b.low >> 32;
+		const uint64_t lowLow = aLow * bLow;
+		const uint64_t middle = (lowLow >> 32) + (aHigh * bLow & 0xffffffffULL) + aLow * bHigh;
+		result = UInt128{ aHigh * bHigh + (aHigh * bLow >> 32) + (middle >> 32), (middle << 32) | (lowLow & 0xffffffffULL) };
+	}
+#endif
+	result.high += a.high * b.low + a.low * b.high;
+	return result;
+}
+
+RANDFS_CONSTEXPR uint64_t Pcg64::Next()
+{
+	// The state advances first, and the output is its two halves XORed together, rotated by its top 6 bits
+	m_State = Add(Multiply(m_State, Multiplier), m_Increment);
+	const uint64_t x = m_State.high ^ m_State.low;
+	const uint32_t rotation = uint32_t(m_State.high >> 58);
+	return (x >> rotation) | (x << ((64U - rotation) & 63U));
+}
+
+RANDFS_CONSTEXPR void Pcg64::Fill(uint64_t* values, uint32_t count)
+{
+	for (uint32_t i = 0U; i < count; i++)
+		values[i] = Next();
+}
+
+RANDFS_CONSTEXPR void Pcg64::Advance(UInt128 delta)
+{
+	// Compose the affine step x -> multiplier * x + increment with itself, once for each bit of delta
+	UInt128 accumulatedMultiplier = { 0ULL, 1ULL };
+	UInt128 accumulatedIncrement = { 0ULL, 0ULL };
+	UInt128 currentMultiplier = Multiplier;
+	UInt128 currentIncrement = m_Increment;
+	while (delta.high != 0ULL || delta.low != 0ULL)
+	{
+		if (delta.low & 1ULL)
+		{
+			accumulatedMultiplier = Multiply(accumulatedMultiplier, currentMultiplier);
+			accumulatedIncrement = Add(Multiply(accumulatedIncrement, currentMultiplier), currentIncrement);
+		}
+		currentIncrement = Multiply(Add(currentMultiplier, UInt128{ 0ULL, 1ULL }), currentIncrement);
+		currentMultiplier = Multiply(currentMultiplier, currentMultiplier);
+		delta.low = (delta.low >> 1) | (delta.high << 63);
+		delta.high >>= 1;
+	}
+	m_State = Add(Multiply(accumulatedMultiplier, m_State), accumulatedIncrement);
+}
+
+RANDFS_CONSTEXPR void Pcg64::Discard(uint64_t n) { Advance(UInt128{ 0ULL, n }); }
+RANDFS_CONSTEXPR void Pcg64::Jump() { Advance(UInt128{ 1ULL, 0ULL }); }
+
+#pragma endregion
+
 #pragma region Random declaration
 
-class Random
+template <typename Engine = MersenneTwister64>
+class BasicRandom
 {
 public:
-	// Initialize a Mersenne Twister PRNG with the given seed
-	Random(uint64_t seed = 0ULL);
-	~Random() = default;
+	// Initialize the engine with the given seed, along with any other arguments its constructor takes
+	template <typename... Args>
+	RANDFS_CONSTEXPR BasicRandom(uint64_t seed = 0ULL, Args... args)
+		: m_Engine(seed, args...), m_Cache(0U), m_HasCache(false)
+	{
+	}
+	~BasicRandom() = default;
 
 	// Generate random 64-bit integer on the interval [0, 2^64-1]
-	uint64_t UInt64();
+	RANDFS_CONSTEXPR uint64_t UInt64();
 	// Generate random 64-bit integer on the interval [-2^63, 2^63-1]
-	int64_t Int64();
+	RANDFS_CONSTEXPR int64_t Int64();
 	// Generate random 64-bit integer on the interval [0, 2^63-1]
-	int64_t PosInt64();
+	RANDFS_CONSTEXPR int64_t PosInt64();
 	// Generate random 32-bit integer on the interval [0, 2^32-1]
-	uint32_t UInt32();
+	RANDFS_CONSTEXPR uint32_t UInt32();
 	// Generate random 32-bit integer on the interval [-2^31, 2^31-1]
-	int32_t Int32();
+	RANDFS_CONSTEXPR int32_t Int32();
 	// Generate random 32-bit integer on the interval [0, 2^31-1]
-	int32_t PosInt32();
+	RANDFS_CONSTEXPR int32_t PosInt32();
 
 	// Generate random double (64-bit floating-point value) on the closed interval [0, 1]
-	double DoubleC();
+	RANDFS_CONSTEXPR double DoubleC();
 	// Generate random double (64-bit floating-point value) on the half-closed interval [0, 1)
-	double DoubleH();
+	RANDFS_CONSTEXPR double DoubleH();
 	// Generate random double (64-bit floating-point value) on the open interval (0, 1)
-	double DoubleO();
+	RANDFS_CONSTEXPR double DoubleO();
 	// Generate random 32-bit float on the closed interval [0, 1]
-	float FloatC();
+	RANDFS_CONSTEXPR float FloatC();
 	// Generate random 32-bit float on the half-closed interval [0, 1)
-	float FloatH();
+	RANDFS_CONSTEXPR float FloatH();
 	// Generate random 32-bit float on the open interval (0, 1)
-	float FloatO();
+	RANDFS_CONSTEXPR float FloatO();
 
 	// Generate random byte
-	uint8_t UInt8();
+	RANDFS_CONSTEXPR uint8_t UInt8();
 	// Generate random boolean
-	bool Bool();
+	RANDFS_CONSTEXPR bool Bool();
 
 	// Generate random 32-bit integer on the half-closed interval [min, max)
-	int32_t IntBetween(int32_t min, int32_t max);
+	RANDFS_CONSTEXPR int32_t IntBetween(int32_t min, int32_t max);
 	// Generate random 32-bit float on the closed interval [min, max]
-	float FloatBetween(float min, float max);
+	RANDFS_CONSTEXPR float FloatBetween(float min, float max);
 
 	// Generate random 32-bit float with normal distribution, with mean 0 and standard deviation 1
-	float FloatNormal();
+	RANDFS_CONSTEXPR float FloatNormal();
 	// Generate random 32-bit float with normal distribution, with the given mean and standard deviation (stdDev)
-	float FloatNormal(float mean, float stdDev);
+	RANDFS_CONSTEXPR float FloatNormal(float mean, float stdDev);
+
+	// Fill the given array with 'count' values, the same ones that 'count' calls of the function of the same name would return
+	// The sequence advances exactly as it would with those calls, so bulk and single calls can be mixed in any order
+	RANDFS_CONSTEXPR void FillUInt64(uint64_t* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillUInt32(uint32_t* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillFloatC(float* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillFloatH(float* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillFloatO(float* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillFloatBetween(float* values, uint32_t count, float min, float max);
+	RANDFS_CONSTEXPR void FillFloatNormal(float* values, uint32_t count);
+	RANDFS_CONSTEXPR void FillFloatNormal(float* values, uint32_t count, float mean, float stdDev);
+	RANDFS_CONSTEXPR void FillIntBetween(int32_t* values, uint32_t count, int32_t min, int32_t max);
+
+	// Skip the next 'n' values, the same as 'n' calls of UInt64 but without computing them, when the engine allows it
+	RANDFS_CONSTEXPR void Discard(uint64_t n);
+	// Skip as many values as the Jump of the engine does, 2^128 for MT19937-64 and xoshiro256**, or 2^64 for PCG64
+	RANDFS_CONSTEXPR void Jump();
+	// Hand out 'count' generators that draw from parts of the sequence of this one that are one jump apart, such as one per thread
+	// The first one continues from the current state, and this generator ends up 'count' jumps ahead, so it can be split again
+	RANDFS_CONSTEXPR void Split(BasicRandom* streams, uint32_t count);
 
 	// Shuffle the given array
 	template <typename T>
-	void ShuffleArray(T* arr, uint32_t size)
+	RANDFS_CONSTEXPR void ShuffleArray(T* arr, uint32_t size)
 	{
 		// Fisher–Yates shuffle
 		for (; size > 0U; size--)
@@ -187,83 +689,90 @@ public:
 	}
 	// Return a reference to a random element in the given array
 	template <typename T>
-	T& Element(T* arr, uint32_t size)
+	RANDFS_CONSTEXPR T& Element(T* arr, uint32_t size)
 	{
 		return arr[UInt32() % size];
 	}
 
 private:
-	uint64_t m_State[312]; // State array
-	uint32_t m_Index; // Array index counter
+	Engine m_Engine; // Source of the 64-bit values
 
 	uint32_t m_Cache; // Stored value for next 32-bit call
 	bool m_HasCache; // Does m_Cache contain a value that has not been used yet?
 
-#ifdef RANDFS_NO_STD
-	// Manual implementation of memcpy
-	static void memcpy(void* dst, const void* src, uint32_t size);
-#endif // RANDFS_NO_STD
-
-};
-
-#pragma endregion
+	// Conversions shared by the single and the bulk functions, so that both return exactly the same values
+	static RANDFS_CONSTEXPR float ToFloatC(uint32_t n) { return (n >> 8) * (1.0f / 16777215.0f); }
+	static RANDFS_CONSTEXPR float ToFloatH(uint32_t n) { return (n >> 8) * (1.0f / 16777216.0f); }
+	static RANDFS_CONSTEXPR float ToFloatO(uint32_t n) { return ((n >> 9) + 0.5f) * (1.0f / 8388608.0f); }
+	static RANDFS_CONSTEXPR float ToFloatNormal(uint32_t n)
+	{
+		// See comment above BasicRandom::FloatNormal implementation for an explanation of the algorithm
+		float u1 = ToFloatO(n);
+		float u2 = 1.0f - u1;
+		return 5.0003944e-8f * float(FloatBits(u1) - FloatBits(u2));
+	}
+	// Bit copy of a float, with std::bit_cast when it is available so that it also works at compile time
+	static RANDFS_CONSTEXPR int32_t FloatBits(float x)
+	{
+#ifdef RANDFS_BIT_CAST
+		return std::bit_cast<int32_t>(x);
+#else
+		int32_t bits = 0;
+		memcpy(&bits, &x, sizeof(float));
+		return bits;
+#endif // RANDFS_BIT_CAST
+	}
 
-#ifdef RANDFS_IMPLEMENTATION
+	// Values converted at a time by the bulk functions, from a buffer on the stack
+	static constexpr uint32_t FillChunk = 128U;
 
-#pragma region Random implementation
+	// Fill 'values' with the result of 'convert' for each value that FillUInt32 returns
+	template <typename T, typename F>
+	RANDFS_CONSTEXPR void FillFromUInt32(T* values, uint32_t count, F convert)
+	{
+		uint32_t chunk[FillChunk];
+		while (count > 0U)
+		{
+			const uint32_t n = count < FillChunk ? count : FillChunk;
+			FillUInt32(chunk, n);
+			for (uint32_t i = 0U; i < n; i++)
+				values[i] = convert(chunk[i]);
 
-Random::Random(uint64_t seed)
-	: m_Cache(0U), m_HasCache(false)
-{
-	// From Takuji Nishimura and Makoto Matsumoto's MT19937-64 implementation (see license at the end of file)
+			values += n;
+			count -= n;
+		}
+	}
 
-	m_State[0] = seed;
-	for (m_Index = 1U; m_Index < 312U; m_Index++)
+#ifdef RANDFS_NO_STD
+	// Manual implementation of memcpy, defined here since the class is a template
+	static void memcpy(void* dst, const void* src, uint32_t size)
 	{
-		m_State[m_Index] = 0x5851f42d4c957f2dULL * (m_State[m_Index - 1U] ^ (m_State[m_Index - 1U] >> 62)) + m_Index;
+		// The C++ standard specifically allows any type to be
+		// accessed as char without invoking undefined behavior
+		const char* srcBytes = reinterpret_cast<const char*>(src);
+		char* dstBytes = reinterpret_cast<char*>(dst);
+		for (uint32_t i = 0U; i < size; i++)
+			dstBytes[i] = srcBytes[i];
 	}
-}
-
-uint64_t Random::UInt64  ()
-{
-	// From Takuji Nishimura and Makoto Matsumoto's MT19937-64 implementation (see license at the end of file)
+#endif // RANDFS_NO_STD
 
-	uint64_t x;
+};
 
-	if (m_Index > 311U) // Generate 312 words at one time
-	{
-		static constexpr uint64_t MS = 0xffffffff80000000ULL; // Most significant 33 bits
-		static constexpr uint64_t LS = 0x7fffffffULL; // Least significant 31 bits
+// The generator with the MT19937-64 engine, which all versions of this library used before the engines could be chosen
+using Random = BasicRandom<MersenneTwister64>;
 
-		uint32_t i = 0U;
-		for (; i < 156U; i++)
-		{
-			x = (m_State[i] & MS) | (m_State[i + 1U] & LS);
-			m_State[i] = m_State[i + 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
-		}
-		for (; i < 311U; i++)
-		{
-			x = (m_State[i] & MS) | (m_State[i + 1U] & LS);
-			m_State[i] = m_State[i - 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
-		}
-		x = (m_State[311] & MS) | (m_State[0] & LS);
-		m_State[311] = m_State[155] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
-		m_Index = 0U;
-	}
+#pragma endregion
 
-	x = m_State[m_Index++];
+#pragma region Random implementation
 
-	x ^= (x >> 29) & 0x5555555555555555ULL;
-	x ^= (x << 17) & 0x71d67fffeda60000ULL;
-	x ^= (x << 37) & 0xfff7eee000000000ULL;
-	x ^= (x >> 43);
+// The members of a class template have to be defined wherever they are used, so this part is not in RANDFS_IMPLEMENTATION
 
-	return x;
-}
-int64_t  Random::Int64   () { return int64_t(UInt64()); }
-int64_t  Random::PosInt64() { return int64_t(UInt64() >> 1); }
+template <typename Engine> RANDFS_CONSTEXPR uint64_t BasicRandom<Engine>::UInt64  () { return m_Engine.Next(); }
+template <typename Engine> RANDFS_CONSTEXPR int64_t  BasicRandom<Engine>::Int64   () { return int64_t(UInt64()); }
+template <typename Engine> RANDFS_CONSTEXPR int64_t  BasicRandom<Engine>::PosInt64() { return int64_t(UInt64() >> 1); }
 
-uint32_t Random::UInt32  ()
+template <typename Engine>
+RANDFS_CONSTEXPR uint32_t BasicRandom<Engine>::UInt32()
 {
 	// If m_Cache contains a value that can still be used, return the cached value
 	if (m_HasCache)
@@ -278,21 +787,21 @@ uint32_t Random::UInt32  ()
 	m_HasCache = true;
 	return uint32_t(x);
 }
-int32_t  Random::Int32   () { return int32_t(UInt32()); }
-int32_t  Random::PosInt32() { return int32_t(UInt32() >> 1); }
+template <typename Engine> RANDFS_CONSTEXPR int32_t BasicRandom<Engine>::Int32   () { return int32_t(UInt32()); }
+template <typename Engine> RANDFS_CONSTEXPR int32_t BasicRandom<Engine>::PosInt32() { return int32_t(UInt32() >> 1); }
 
-double Random::DoubleC() { return (UInt64() >> 11) * (1.0 / 9007199254740991.0); }
-double Random::DoubleH() { return (UInt64() >> 11) * (1.0 / 9007199254740992.0); }
-double Random::DoubleO() { return ((UInt64() >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
-float  Random::FloatC () { return (UInt32() >> 8) * (1.0f / 16777215.0f); }
-float  Random::FloatH () { return (UInt32() >> 8) * (1.0f / 16777216.0f); }
-float  Random::FloatO () { return ((UInt32() >> 9) + 0.5f) * (1.0f / 8388608.0f); }
+template <typename Engine> RANDFS_CONSTEXPR double BasicRandom<Engine>::DoubleC() { return (UInt64() >> 11) * (1.0 / 9007199254740991.0); }
+template <typename Engine> RANDFS_CONSTEXPR double BasicRandom<Engine>::DoubleH() { return (UInt64() >> 11) * (1.0 / 9007199254740992.0); }
+template <typename Engine> RANDFS_CONSTEXPR double BasicRandom<Engine>::DoubleO() { return ((UInt64() >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
+template <typename Engine> RANDFS_CONSTEXPR float  BasicRandom<Engine>::FloatC () { return ToFloatC(UInt32()); }
+template <typename Engine> RANDFS_CONSTEXPR float  BasicRandom<Engine>::FloatH () { return ToFloatH(UInt32()); }
+template <typename Engine> RANDFS_CONSTEXPR float  BasicRandom<Engine>::FloatO () { return ToFloatO(UInt32()); }
 
-uint8_t Random::UInt8() { return uint8_t(UInt32()); }
-bool    Random::Bool () { return UInt32() & 1U; }
+template <typename Engine> RANDFS_CONSTEXPR uint8_t BasicRandom<Engine>::UInt8() { return uint8_t(UInt32()); }
+template <typename Engine> RANDFS_CONSTEXPR bool    BasicRandom<Engine>::Bool () { return UInt32() & 1U; }
 
-int32_t Random::IntBetween  (int32_t min, int32_t max) { return PosInt32() % (max - min) + min; }
-float   Random::FloatBetween(  float min,   float max) { return FloatC  () * (max - min) + min; }
+template <typename Engine> RANDFS_CONSTEXPR int32_t BasicRandom<Engine>::IntBetween  (int32_t min, int32_t max) { return PosInt32() % (max - min) + min; }
+template <typename Engine> RANDFS_CONSTEXPR float   BasicRandom<Engine>::FloatBetween(  float min,   float max) { return FloatC  () * (max - min) + min; }
 
 /*
 	Fast quantile algorithm, by Quintanilha, Diego T. P. (2022) (see license at the end of this file)
@@ -310,30 +819,346 @@ float   Random::FloatBetween(  float min,   float max) { return FloatC  () * (ma
 	The final formula is sqrt(2) * t * ln(2) * 2^(-23) * (r(x) - r(1-x)),
 	which can be simplified to C * (r(x) - r(1-x)), where C = 5.0003944e-8.
 */
-float Random::FloatNormal()
+template <typename Engine> RANDFS_CONSTEXPR float BasicRandom<Engine>::FloatNormal() { return ToFloatNormal(UInt32()); }
+template <typename Engine> RANDFS_CONSTEXPR float BasicRandom<Engine>::FloatNormal(float mean, float stdDev) { return FloatNormal() * stdDev + mean; }
+
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::FillUInt64(uint64_t* values, uint32_t count) { m_Engine.Fill(values, count); }
+
+template <typename Engine>
+RANDFS_CONSTEXPR void BasicRandom<Engine>::FillUInt32(uint32_t* values, uint32_t count)
 {
-	float u1 = FloatO();
-	float u2 = 1.0f - u1;
-	int32_t r1, r2;
-	memcpy(&r1, &u1, sizeof(float));
-	memcpy(&r2, &u2, sizeof(float));
-	return 5.0003944e-8f * float(r1 - r2);
+	// The first value is the half cached by an earlier call, if there is one
+	if (count > 0U && m_HasCache)
+	{
+		*values++ = m_Cache;
+		m_HasCache = false;
+		count--;
+	}
+
+	// Then each 64-bit value gives two, the lower half first, like UInt32 does
+	uint64_t chunk[FillChunk];
+	while (count >= 2U)
+	{
+		const uint32_t n = count / 2U < FillChunk ? count / 2U : FillChunk;
+		FillUInt64(chunk, n);
+		for (uint32_t i = 0U; i < n; i++)
+		{
+			values[2U * i] = uint32_t(chunk[i]);
+			values[2U * i + 1U] = uint32_t(chunk[i] >> 32);
+		}
+
+		values += 2U * n;
+		count -= 2U * n;
+	}
+
+	// An odd count leaves the upper half of the last value cached
+	if (count == 1U)
+		*values = UInt32();
 }
-float Random::FloatNormal(float mean, float stdDev) { return FloatNormal() * stdDev + mean; }
 
-#ifdef RANDFS_NO_STD
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatC(float* values, uint32_t count) { FillFromUInt32(values, count, ToFloatC); }
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatH(float* values, uint32_t count) { FillFromUInt32(values, count, ToFloatH); }
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatO(float* values, uint32_t count) { FillFromUInt32(values, count, ToFloatO); }
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatNormal(float* values, uint32_t count) { FillFromUInt32(values, count, ToFloatNormal); }
 
-void Random::memcpy(void* dst, const void* src, uint32_t size)
+template <typename Engine>
+RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatBetween(float* values, uint32_t count, float min, float max)
 {
-	// The C++ standard specifically allows any type to be
-	// accessed as char without invoking undefined behavior
-	const char* srcBytes = reinterpret_cast<const char*>(src);
-    char* dstBytes = reinterpret_cast<char*>(dst);
-    for (uint32_t i = 0U; i < size; i++)
-		dstBytes[i] = srcBytes[i];
+	FillFromUInt32(values, count, [min, max](uint32_t n) { return ToFloatC(n) * (max - min) + min; });
+}
+template <typename Engine>
+RANDFS_CONSTEXPR void BasicRandom<Engine>::FillFloatNormal(float* values, uint32_t count, float mean, float stdDev)
+{
+	FillFromUInt32(values, count, [mean, stdDev](uint32_t n) { return ToFloatNormal(n) * stdDev + mean; });
+}
+template <typename Engine>
+RANDFS_CONSTEXPR void BasicRandom<Engine>::FillIntBetween(int32_t* values, uint32_t count, int32_t min, int32_t max)
+{
+	FillFromUInt32(values, count, [min, max](uint32_t n) { return int32_t(n >> 1) % (max - min) + min; });
 }
 
-#endif // RANDFS_NO_STD
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::Discard(uint64_t n) { m_Engine.Discard(n); }
+template <typename Engine> RANDFS_CONSTEXPR void BasicRandom<Engine>::Jump() { m_Engine.Jump(); }
+
+template <typename Engine>
+RANDFS_CONSTEXPR void BasicRandom<Engine>::Split(BasicRandom* streams, uint32_t count)
+{
+	// A cached upper half would otherwise be returned by all the streams
+	m_HasCache = false;
+	for (uint32_t i = 0U; i < count; i++)
+	{
+		streams[i] = *this;
+		Jump();
+	}
+}
+
+#pragma endregion
+
+#ifdef RANDFS_IMPLEMENTATION
+
+#pragma region Random engines implementation
+
+void MersenneTwister64::Regenerate()
+{
+	// From Takuji Nishimura and Makoto Matsumoto's MT19937-64 implementation (see license at the end of file)
+
+	static constexpr uint64_t MS = 0xffffffff80000000ULL; // Most significant 33 bits
+	static constexpr uint64_t LS = 0x7fffffffULL; // Least significant 31 bits
+
+	uint64_t x;
+	uint32_t i = 0U;
+
+#ifdef RANDFS_SIMD_WIDTH
+	// Words that do not fill a whole group at the end of each half are regenerated one at a time
+	static constexpr uint32_t firstGroupsEnd = 156U - 156U % RANDFS_SIMD_WIDTH;
+	static constexpr uint32_t secondGroupsEnd = 311U - 155U % RANDFS_SIMD_WIDTH;
+
+	for (; i < firstGroupsEnd; i += RANDFS_SIMD_WIDTH)
+		TwistLanes(&m_State[i], &m_State[i + 156U]);
+#endif // RANDFS_SIMD_WIDTH
+	for (; i < 156U; i++)
+	{
+		x = (m_State[i] & MS) | (m_State[i + 1U] & LS);
+		m_State[i] = m_State[i + 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+	}
+#ifdef RANDFS_SIMD_WIDTH
+	for (; i < secondGroupsEnd; i += RANDFS_SIMD_WIDTH)
+		TwistLanes(&m_State[i], &m_State[i - 156U]);
+#endif // RANDFS_SIMD_WIDTH
+	for (; i < 311U; i++)
+	{
+		x = (m_State[i] & MS) | (m_State[i + 1U] & LS);
+		m_State[i] = m_State[i - 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+	}
+	x = (m_State[311] & MS) | (m_State[0] & LS);
+	m_State[311] = m_State[155] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+	m_Index = 0U;
+}
+
+#ifdef RANDFS_SIMD_WIDTH
+
+// Same as one step of the scalar loops in Refill for each lane, where the word after the last lane is loaded by the unaligned load of words + 1
+void MersenneTwister64::TwistLanes(uint64_t* words, const uint64_t* far)
+{
+#if RANDFS_SIMD_WIDTH == 8U
+	const __m512i x = _mm512_or_si512(_mm512_and_si512(_mm512_loadu_si512(words), _mm512_set1_epi64(int64_t(0xffffffff80000000ULL))),
+		_mm512_and_si512(_mm512_loadu_si512(words + 1), _mm512_set1_epi64(0x7fffffffLL)));
+	const __m512i odd = _mm512_sub_epi64(_mm512_setzero_si512(), _mm512_and_si512(x, _mm512_set1_epi64(1LL)));
+	// The zero-masked shift is the same as the unmasked one, which some compilers warn about for its undefined pass-through lanes
+	const __m512i y = _mm512_xor_si512(_mm512_loadu_si512(far),
+		_mm512_xor_si512(_mm512_maskz_srli_epi64(__mmask8(0xff), x, 1), _mm512_and_si512(odd, _mm512_set1_epi64(int64_t(0xb5026f5aa96619e9ULL)))));
+	_mm512_storeu_si512(words, y);
+#elif RANDFS_SIMD_WIDTH == 4U
+	const __m256i x = _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)), _mm256_set1_epi64x(int64_t(0xffffffff80000000ULL))),
+		_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + 1)), _mm256_set1_epi64x(0x7fffffffLL)));
+	const __m256i odd = _mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(x, _mm256_set1_epi64x(1LL)));
+	const __m256i y = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(far)),
+		_mm256_xor_si256(_mm256_srli_epi64(x, 1), _mm256_and_si256(odd, _mm256_set1_epi64x(int64_t(0xb5026f5aa96619e9ULL)))));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(words), y);
+#else
+	const __m128i x = _mm_or_si128(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words)), _mm_set1_epi64x(int64_t(0xffffffff80000000ULL))),
+		_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + 1)), _mm_set1_epi64x(0x7fffffffLL)));
+	const __m128i odd = _mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(x, _mm_set1_epi64x(1LL)));
+	const __m128i y = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(far)),
+		_mm_xor_si128(_mm_srli_epi64(x, 1), _mm_and_si128(odd, _mm_set1_epi64x(int64_t(0xb5026f5aa96619e9ULL)))));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(words), y);
+#endif
+}
+
+// Same as Temper for each lane
+void MersenneTwister64::TemperLanes(const uint64_t* words, uint64_t* values)
+{
+#if RANDFS_SIMD_WIDTH == 8U
+	__m512i x = _mm512_loadu_si512(words);
+	x = _mm512_xor_si512(x, _mm512_and_si512(_mm512_maskz_srli_epi64(__mmask8(0xff), x, 29), _mm512_set1_epi64(0x5555555555555555LL)));
+	x = _mm512_xor_si512(x, _mm512_and_si512(_mm512_maskz_slli_epi64(__mmask8(0xff), x, 17), _mm512_set1_epi64(0x71d67fffeda60000LL)));
+	x = _mm512_xor_si512(x, _mm512_and_si512(_mm512_maskz_slli_epi64(__mmask8(0xff), x, 37), _mm512_set1_epi64(int64_t(0xfff7eee000000000ULL))));
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi64(__mmask8(0xff), x, 43));
+	_mm512_storeu_si512(values, x);
+#elif RANDFS_SIMD_WIDTH == 4U
+	__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+	x = _mm256_xor_si256(x, _mm256_and_si256(_mm256_srli_epi64(x, 29), _mm256_set1_epi64x(0x5555555555555555LL)));
+	x = _mm256_xor_si256(x, _mm256_and_si256(_mm256_slli_epi64(x, 17), _mm256_set1_epi64x(0x71d67fffeda60000LL)));
+	x = _mm256_xor_si256(x, _mm256_and_si256(_mm256_slli_epi64(x, 37), _mm256_set1_epi64x(int64_t(0xfff7eee000000000ULL))));
+	x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 43));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(values), x);
+#else
+	__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+	x = _mm_xor_si128(x, _mm_and_si128(_mm_srli_epi64(x, 29), _mm_set1_epi64x(0x5555555555555555LL)));
+	x = _mm_xor_si128(x, _mm_and_si128(_mm_slli_epi64(x, 17), _mm_set1_epi64x(0x71d67fffeda60000LL)));
+	x = _mm_xor_si128(x, _mm_and_si128(_mm_slli_epi64(x, 37), _mm_set1_epi64x(int64_t(0xfff7eee000000000ULL))));
+	x = _mm_xor_si128(x, _mm_srli_epi64(x, 43));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(values), x);
+#endif
+}
+
+#endif // RANDFS_SIMD_WIDTH
+
+void MersenneTwister64::FillTempered(uint64_t* values, uint32_t count)
+{
+	// Temper the words left in the state, as many at a time as possible, and refill it as often as needed
+	while (count > 0U)
+	{
+		if (m_Index >= m_End)
+			Refill();
+
+		const uint32_t n = count < m_End - m_Index ? count : m_End - m_Index;
+		const uint64_t* words = &m_State[m_Index];
+
+		uint32_t i = 0U;
+#ifdef RANDFS_SIMD_WIDTH
+		for (; i + RANDFS_SIMD_WIDTH <= n; i += RANDFS_SIMD_WIDTH)
+			TemperLanes(&words[i], &values[i]);
+#endif // RANDFS_SIMD_WIDTH
+		for (; i < n; i++)
+			values[i] = Temper(words[i]);
+
+		m_Index += n;
+		values += n;
+		count -= n;
+	}
+}
+
+/*
+	Every word of the sequence is a linear function of the 19937 bits
+	of state before it, over the field of two elements (where adding is
+	XOR), so moving the state ahead by one word is a matrix product A.
+	Then moving it J words ahead is A^J, which is the same as r(A) * A,
+	where r(x) = x^(J-1) modulo the characteristic polynomial of A: a
+	sum of the states 1 to 19937 words ahead, for each bit of r that is
+	set. The polynomial for J = 2^128 was computed once, by finding the
+	characteristic polynomial with the Berlekamp-Massey algorithm on
+	the output and raising x to J - 1 by repeated squaring.
+*/
+void MersenneTwister64::Jump()
+{
+	static constexpr uint64_t polynomial[312] =
+	{
+		0x0a9fde11a04d8f18ULL, 0xdc6ac5177e0e63dfULL, 0x026646fb5eaab9f0ULL, 0xc70dcceb751913aaULL,
+		0x3fd2e45588d3c767ULL, 0xd1f80cc97c3cee13ULL, 0x3ba80731494eba68ULL, 0x2632f7a1cf96e595ULL,
+		0x398d9de9a9c77623ULL, 0x8a66ab262064f1d7ULL, 0xb7fb2b3bba91345bULL, 0x5df50826247645c6ULL,
+		0x0469ab2cb92b4752ULL, 0x2e5bced8fbb9caf9ULL, 0xca7ae1a451967656ULL, 0x25ac661c5b091f6bULL,
+		0xb268c8d0059f1b16ULL, 0x3d828b0ade082b2cULL, 0x15688f16c0970ae9ULL, 0xe92a8e8ae4a2790cULL,
+		0xb41ba12a68fa3442ULL, 0x3952febb807461a7ULL, 0x7205a5630f0a1bb6ULL, 0x5d883e68548ac660ULL,
+		0xa8145151ea671473ULL, 0xe840af759748d502ULL, 0x94dd1c37b184f3eeULL, 0x50cdf894048efb21ULL,
+		0x526ed1f52d7923fcULL, 0x4a87f9645e46cf98ULL, 0x620ad0438f78d7a7ULL, 0x7442cebd2d619326ULL,
+		0x26ac735f6839cff1ULL, 0xd8396a3a71fcb016ULL, 0xc9d88901ae78719eULL, 0xc86a57ab2105051eULL,
+		0x65c9866ffe84dd43ULL, 0xc1182a09e3b5d025ULL, 0x4476b0dd3efe483aULL, 0xef7e3ad3c34e0a2eULL,
+		0x860b48b34b3bab2cULL, 0xca523df85ae9c34dULL, 0x8136223b712a8bccULL, 0x95916c8013feeba3ULL,
+		0x7223d7bb8c3223bbULL, 0x5dc1f8e018c8707dULL, 0xc997d5e38bd988a6ULL, 0xf01c2020edeaf57eULL,
+		0xb4c654d11827d44aULL, 0xddd9377fa717b313ULL, 0xa29e55cb3d238322ULL, 0x153577d5e68cea74ULL,
+		0xc047c6999207b5c8ULL, 0xc8dfa3649d25c295ULL, 0xba5b542cb880734bULL, 0x5e9527791cab2044ULL,
+		0xcc8bb8c70476127dULL, 0x564e73286e662eb0ULL, 0x296da6bb5162aa36ULL, 0x8091f07e1e5c8575ULL,
+		0xff3c78f41ddc9b1aULL, 0xa7adb9ceadd02428ULL, 0x525fbfcb74b42544ULL, 0x2a325d9bbd4bfb17ULL,
+		0x994499f803670a5fULL, 0x21f2ac5beb1572ebULL, 0x6ed8799f90f3ec6eULL, 0xa9693bcef4999069ULL,
+		0xab8c8e39567e2849ULL, 0x0bbc9c240ce50074ULL, 0x3d7e7ddf15655342ULL, 0xc8118eabc4253aa2ULL,
+		0xee9fff56a7f76371ULL, 0x939ac252178d3caeULL, 0xb48b0099c6963a24ULL, 0x464720ce50294fe1ULL,
+		0x9b9f1bee828fc5c3ULL, 0x13d16b8b0fb6835eULL, 0x4aa120038239188dULL, 0xa38ab2db0549e972ULL,
+		0xa7da56cb1619409aULL, 0xbd8d1d496200f49dULL, 0x7930e1fe641578a0ULL, 0xab920d7844bc79f6ULL,
+		0x163cd551b868dea7ULL, 0xf9abc8504bc09bebULL, 0x9c63931e4b11a11cULL, 0x70509d0eeafc295aULL,
+		0x839a7b64b17c3401ULL, 0x65292b27b9789f88ULL, 0x525e954ee34d0924ULL, 0x37a0c50276da2f4cULL,
+		0xbb25abd002cd538dULL, 0x4937b7af9aa1336fULL, 0x30620a8009e64a09ULL, 0x9d0a4c064ea666cbULL,
+		0x272ed19ca211cec5ULL, 0x91f9f7b7421e394eULL, 0x1c4d88116f0563e4ULL, 0x9b4d94ebe942c11fULL,
+		0xfaab10a56b1f166cULL, 0x48721dca9b5e0ad5ULL, 0xd21b02003f11fec2ULL, 0x387715ec6cf36157ULL,
+		0x8745b63d3bfea135ULL, 0xf684a0be706b9e6fULL, 0x51f49af1640d2010ULL, 0xbe7970459441cc7dULL,
+		0x8f499e6f4b51888aULL, 0xedb00a61d3c062b0ULL, 0x95f8aca85a3307ceULL, 0xa867b177e4051e2aULL,
+		0xa2476f017503c1e2ULL, 0x4bef868a7b2600e3ULL, 0x09a99abeaa19b468ULL, 0xcde8a24b2966e54eULL,
+		0xb368ad77d3d12190ULL, 0x92eebafe3a495d4eULL, 0xa34674d0d1c3a709ULL, 0xa055cf476b3d2568ULL,
+		0x85d7da6991e8133bULL, 0x7cf9e80e0fa1adb4ULL, 0x062507d237d632b5ULL, 0xded61d5ee9bf26feULL,
+		0xefcd837782ed98efULL, 0x76802f8079bed53dULL, 0xc925f17232d84a08ULL, 0x4c84c9bb7543df2bULL,
+		0x9816c53e24e25f35ULL, 0xf477fe382a0e03d2ULL, 0x372308d68cb53771ULL, 0x5ea1658ad2965914ULL,
+		0x671a1f7249e6f610ULL, 0xbfa118f1e9074739ULL, 0x51093e976c0f27c4ULL, 0x13dd9957d0e377a6ULL,
+		0x4e9becfa65c3e249ULL, 0xd35bf4a58af1143eULL, 0x04c5a698170b6b74ULL, 0x0968ed47fdf9d6d9ULL,
+		0xeadf0aade17e00efULL, 0x487b185cf184b8adULL, 0x5ed884587c6d109eULL, 0x4c76a906b8fa4e8dULL,
+		0x4124ad5668cf5ceeULL, 0x8926ba3c50a812d9ULL, 0x5075b03f62043bbaULL, 0xe5a3caaf755f0448ULL,
+		0x39b051e8705b45c4ULL, 0x92fadf732b0acec9ULL, 0x757421a709fcc2f6ULL, 0x027f9c3915688543ULL,
+		0x56384b90ada1a140ULL, 0x9b20574ee8343d8dULL, 0xd92104d2674fb01dULL, 0xf81f37eb7bd20b6eULL,
+		0xe98f2de6f2433957ULL, 0x9382673075c214d3ULL, 0x7bd75c0fc7e68061ULL, 0x2a126dd505b1b51eULL,
+		0x79a97f1286b12d32ULL, 0xce6092ab611147c3ULL, 0xf6d606ddca74a7a8ULL, 0xeec7958f933b17e8ULL,
+		0xaf7a4403b63f4abfULL, 0x95b9a6e452361e30ULL, 0x29088ac4f5951171ULL, 0x7d08e4ddc21efa5eULL,
+		0x2c4b5617679b7ce9ULL, 0xb360cbd3f24edd05ULL, 0xf0f6d166a3d77e87ULL, 0xa6570567aeafd316ULL,
+		0x659f10f1fc6be4a1ULL, 0x9a8ac0693dbaff22ULL, 0xb65ea5ab0c65d5cdULL, 0xc723f782a174528eULL,
+		0x892d6fb5a5acd977ULL, 0x1394ee19a6567eadULL, 0xc41a19539bc9bc10ULL, 0x30780160ee76d255ULL,
+		0xd7f68df2373fe95eULL, 0x7951e8e65fc3888aULL, 0x7c2f2e28285738b0ULL, 0x3bbe6e222aa736baULL,
+		0x05e7ba909f12cca3ULL, 0xce838a5a6dce514dULL, 0x1b87ee2033993536ULL, 0x7ff5b89c03d0e754ULL,
+		0xbfd854b3a529f3c9ULL, 0xb15820002fce73ddULL, 0x4481fb59415b3e55ULL, 0x9aa27f8ac01375a9ULL,
+		0x6b32c812456fc978ULL, 0x2aef0e43d175efa4ULL, 0x20581c1143933d5dULL, 0x3efd2b537d930c07ULL,
+		0xa2e196bee3358ce7ULL, 0x7af6876fb3281a63ULL, 0x7a63d6df3af0aed0ULL, 0xcaedc29af05ec891ULL,
+		0xe2b8d84b106c1389ULL, 0xce10f6873c7810fcULL, 0x6865a854fcd546f7ULL, 0xde599b46274ffadbULL,
+		0x036c7b24b8249cd1ULL, 0x2f554f70c368a52aULL, 0xc368fcb97ea441e8ULL, 0xb1d8a917a6a86c43ULL,
+		0x4c1597dd0d4c3ad3ULL, 0x392c5feb11ac9875ULL, 0x72666471e1787b87ULL, 0x4df9c8688cbb49b1ULL,
+		0x0de7514ede96015fULL, 0x6ce0c4eda099cc60ULL, 0x4c455222b27c2a1aULL, 0x003f68f5777af105ULL,
+		0x50342ff6f07762cbULL, 0xff78bbf059ad3f87ULL, 0x28032cb78c8f5e30ULL, 0xe5d43e1f30dede45ULL,
+		0xff90ba024834dfe5ULL, 0xebd29b6ed962799fULL, 0x7bd766f10fe16cbbULL, 0xe090ee51ff77bc00ULL,
+		0x54856c93e812e0b5ULL, 0x9f537f729902c74bULL, 0xcfa9086f98566f5cULL, 0xa9074a444c1bde7fULL,
+		0x4636350806d5edadULL, 0xb69080f9fe2983baULL, 0xa8ea9af36e322f24ULL, 0xf2f3b1076b524a0dULL,
+		0x57c011e083823121ULL, 0xb1737207a750cb00ULL, 0xa331cb670d5c749cULL, 0x2387e1a2680d1534ULL,
+		0x911808fc0b2a4f87ULL, 0x4d85200b9994ce2bULL, 0x3710a291d730599aULL, 0x426265f22d4db353ULL,
+		0x31869cfc915a605aULL, 0x7dfd3cf616070809ULL, 0x74ca0242f6406ae0ULL, 0x8ee0e37dad00f995ULL,
+		0x4e685bf9d2bc72bfULL, 0xa05b674ea8749602ULL, 0xac45c579cd5c8ec0ULL, 0xc02c6e13c1d816f1ULL,
+		0xdd9081e2821c964eULL, 0x393234911038b108ULL, 0xedc027e6f5cc3dddULL, 0xd5d5e995249cc343ULL,
+		0xf1ef71baada6d43aULL, 0x0b6f399d6dc5db90ULL, 0xcca3b689881fff19ULL, 0xc3696b14b336582dULL,
+		0xce273155ba067322ULL, 0xdacb41132dba8cffULL, 0x2a6fb49874f6a1fdULL, 0x19fc10c430fcc5b4ULL,
+		0x90de3a4aa178328bULL, 0x6af4b315a2c36fbfULL, 0xa32ab4f5075ae672ULL, 0x9b5242649c78573aULL,
+		0x60446628c4fc01ccULL, 0x25f668d45114066fULL, 0x8c979053a6d60378ULL, 0xd73b3545943d0ab2ULL,
+		0x81b602dd355ffaf9ULL, 0x2ff224249ec7d7b4ULL, 0xd440547fca5c8754ULL, 0xe8763e31a1695bbdULL,
+		0xe8c3eb8345167c87ULL, 0x19291fcd6c173349ULL, 0x87c3a10743dc8393ULL, 0x1d3a2fca9ec7061aULL,
+		0x00cccc9e2d1e8edaULL, 0x19f22dabb36658d0ULL, 0xe955d560b1370586ULL, 0x56ae1811d830fefdULL,
+		0x7b3e7b2a0e5b3729ULL, 0x74ec841e31ad10c8ULL, 0x14d081f061da6d64ULL, 0x3afb956daf3d3f23ULL,
+		0xee64a1d597614b6dULL, 0x9cb503cf89bff8a5ULL, 0x33c29f9e948c1760ULL, 0x1aee9f3d3d38e3c0ULL,
+		0xfdfc1537d13ad2a3ULL, 0x9ce62c53ac1fb913ULL, 0x458d8d76f7f54ff6ULL, 0x484fa2bed6d38a28ULL,
+		0xe0155fe5ff1f1c3dULL, 0xeb438f0c5bcd71e0ULL, 0xcfb5d6231a278d07ULL, 0x99b366bc100d5e76ULL,
+		0x54ed2529038ba94cULL, 0x0183215d78d6a811ULL, 0xad7090334d422558ULL, 0x6c7e09643b5aeddbULL,
+		0x17c95a09d37e371aULL, 0x1795ad35879857faULL, 0x44b19d8b0fd63abdULL, 0xaf25f90e5159cce1ULL,
+		0xaf6c1a7caaee7b55ULL, 0xeafee406b7d47366ULL, 0x66f84f6ccaa2034fULL, 0xfd4d6e42af2994beULL,
+		0x1c7d18a6ae2355a9ULL, 0x4a284602eed13503ULL, 0x3ef16d715520ae96ULL, 0x00000000a1f6b797ULL
+	};
+	Jump(polynomial);
+}
+
+void MersenneTwister64::Jump(const uint64_t* polynomial)
+{
+	static constexpr uint64_t MS = 0xffffffff80000000ULL; // Most significant 33 bits
+	static constexpr uint64_t LS = 0x7fffffffULL; // Least significant 31 bits
+
+	// The whole state is needed, even if it is seeded lazily
+	RefillSeeded(312U);
+
+	// The state is moved one word at a time in a circular buffer, where the oldest word is at 'first'
+	// Every word is stored twice, 312 positions apart, so that the state is always in one piece, from 'first' on
+	uint64_t words[624];
+	uint64_t sum[312] = { 0 };
+	for (uint32_t i = 0U; i < 312U; i++)
+	{
+		words[i] = m_State[i];
+		words[i + 312U] = m_State[i];
+	}
+	uint32_t first = 0U;
+	auto step = [&]()
+	{
+		const uint64_t x = (words[first] & MS) | (words[first + 1U] & LS);
+		const uint64_t next = words[first + 156U] ^ (x >> 1) ^ ((x & 1ULL) * 0xb5026f5aa96619e9ULL);
+		words[first] = next;
+		words[first + 312U] = next;
+		first = first == 311U ? 0U : first + 1U;
+	};
+
+	step();
+	for (uint32_t bit = 0U; bit < 19937U; bit++)
+	{
+		if ((polynomial[bit / 64U] >> (bit % 64U)) & 1ULL)
+		{
+			const uint64_t* state = &words[first];
+			for (uint32_t i = 0U; i < 312U; i++)
+				sum[i] ^= state[i];
+		}
+		step();
+	}
+
+	// The index is left as it is, so the next value is the one J words after the one it was before
+	for (uint32_t i = 0U; i < 312U; i++)
+		m_State[i] = sum[i];
+}
 
 #pragma endregion
 
@@ -357,35 +1182,35 @@ private:
 	// An in-detail explanation can be found at https://mathworld.wolfram.com/PairingFunction.html
 
 	// Pairing function base case for 64-bit integers
-	static uint64_t Pair(uint64_t k0, uint64_t k1) { uint64_t sum = k0 + k1; return ((sum * sum + sum) >> 1) + k1; }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1) { uint64_t sum = k0 + k1; return ((sum * sum + sum) >> 1) + k1; }
 
 	// Compose pairing functions in such a way to keep results as small as possible
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2)                                                                  { return Pair(Pair(k0, k1), k2); }
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3)                                                     { return Pair(k0, k1, Pair(k2, k3)); }
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4)                                        { return Pair(k0, k1, k2, Pair(k3, k4)); }
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5)                           { return Pair(k0, k1, Pair(k2, k3), k4, k5); }
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6)              { return Pair(k0, Pair(k1, k2), k3, k4, k5, k6); }
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6, uint64_t k7) { return Pair(Pair(k0, k1), k2, k3, k4, k5, k6, k7); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2)                                                                  { return Pair(Pair(k0, k1), k2); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3)                                                     { return Pair(k0, k1, Pair(k2, k3)); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4)                                        { return Pair(k0, k1, k2, Pair(k3, k4)); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5)                           { return Pair(k0, k1, Pair(k2, k3), k4, k5); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6)              { return Pair(k0, Pair(k1, k2), k3, k4, k5, k6); }
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6, uint64_t k7) { return Pair(Pair(k0, k1), k2, k3, k4, k5, k6, k7); }
 
 	// Pairing function general case for composing 8 or more 64-bit integers
 	template <typename... OtherT>
-	static uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6, uint64_t k7, uint64_t k8, OtherT... kn)
+	static RANDFS_CONSTEXPR uint64_t Pair(uint64_t k0, uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4, uint64_t k5, uint64_t k6, uint64_t k7, uint64_t k8, OtherT... kn)
 	{ return Pair(k0, k1, k2, k3, k4, k5, k6, Pair(k7, k8, kn...)); }
 
 	// Pairing function base case for 32-bit integers
-	static uint32_t Pair(uint32_t k0, uint32_t k1) { uint32_t sum = k0 + k1; return ((sum * sum + sum) >> 1) + k1; }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1) { uint32_t sum = k0 + k1; return ((sum * sum + sum) >> 1) + k1; }
 
 	// Compose pairing functions in such a way to keep results as small as possible
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2)                                                                  { return Pair(Pair(k0, k1), k2); }
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3)                                                     { return Pair(k0, k1, Pair(k2, k3)); }
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4)                                        { return Pair(k0, k1, k2, Pair(k3, k4)); }
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5)                           { return Pair(k0, k1, Pair(k2, k3), k4, k5); }
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6)              { return Pair(k0, Pair(k1, k2), k3, k4, k5, k6); }
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6, uint32_t k7) { return Pair(Pair(k0, k1), k2, k3, k4, k5, k6, k7); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2)                                                                  { return Pair(Pair(k0, k1), k2); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3)                                                     { return Pair(k0, k1, Pair(k2, k3)); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4)                                        { return Pair(k0, k1, k2, Pair(k3, k4)); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5)                           { return Pair(k0, k1, Pair(k2, k3), k4, k5); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6)              { return Pair(k0, Pair(k1, k2), k3, k4, k5, k6); }
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6, uint32_t k7) { return Pair(Pair(k0, k1), k2, k3, k4, k5, k6, k7); }
 
 	// Pairing function general case for composing 8 or more 32-bit integers
 	template <typename... OtherT>
-	static uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6, uint32_t k7, uint32_t k8, OtherT... kn)
+	static RANDFS_CONSTEXPR uint32_t Pair(uint32_t k0, uint32_t k1, uint32_t k2, uint32_t k3, uint32_t k4, uint32_t k5, uint32_t k6, uint32_t k7, uint32_t k8, OtherT... kn)
 	{ return Pair(k0, k1, k2, k3, k4, k5, k6, Pair(k7, k8, kn...)); }
 
 #ifdef RANDFS_NO_STD
@@ -395,59 +1220,116 @@ private:
 
 #pragma endregion
 
+	// Bit copy of a float, with std::bit_cast when it is available so that it also works at compile time
+	static RANDFS_CONSTEXPR int32_t FloatBits(float x)
+	{
+#ifdef RANDFS_BIT_CAST
+		return std::bit_cast<int32_t>(x);
+#else
+		int32_t bits = 0;
+		memcpy(&bits, &x, sizeof(float));
+		return bits;
+#endif // RANDFS_BIT_CAST
+	}
+
+#ifdef RANDFS_BIT_CAST
+	// Whole number of words, which std::bit_cast can copy a value of the same size into
+	template <typename W, uint32_t N>
+	struct Words
+	{
+		W words[N];
+	};
+#endif // RANDFS_BIT_CAST
+
+	// Copy the bytes of 'n' into the first bytes of 'contents', which is at least as large and starts at zero
+	// A type whose size is a whole number of words is copied with std::bit_cast when it is available, so that it can be hashed at compile time
+	template <typename W, uint32_t N, typename T>
+	static RANDFS_CONSTEXPR void CopyWords(W (&contents)[N], const T& n)
+	{
+#ifdef RANDFS_BIT_CAST
+		if constexpr (sizeof(T) == sizeof(Words<W, N>) && std::is_trivially_copyable_v<T>)
+		{
+			const Words<W, N> copy = std::bit_cast<Words<W, N>>(n);
+			for (uint32_t i = 0U; i < N; i++)
+				contents[i] = copy.words[i];
+			return;
+		}
+#endif // RANDFS_BIT_CAST
+		memcpy(contents, &n, sizeof(T));
+	}
+
+	// Keys hashed at a time by the float batch functions, from a buffer on the stack
+	static constexpr uint32_t BatchChunk = 256U;
+
+	// Turn 'count' results of UInt32 into the results of FloatO or FloatNormal for the same keys
+	static void HashesToFloatO(const uint32_t* hashes, float* values, uint32_t count);
+	static void HashesToFloatNormal(const uint32_t* hashes, float* values, uint32_t count);
+
+#ifdef RANDFS_SIMD_MUL64
+	// Same as UInt64 for RANDFS_SIMD_WIDTH consecutive keys
+	static void UInt64Lanes(const uint64_t* n, uint64_t* values);
+#endif // RANDFS_SIMD_MUL64
+#ifdef RANDFS_SIMD_WIDTH
+	// Same as UInt32 for 2 * RANDFS_SIMD_WIDTH consecutive keys
+	static void UInt32Lanes(const uint32_t* n, uint32_t* values);
+	// Same as HashesToFloatO and HashesToFloatNormal for 2 * RANDFS_SIMD_WIDTH consecutive hashes
+	static void FloatOLanes(const uint32_t* hashes, float* values);
+	static void FloatNormalLanes(const uint32_t* hashes, float* values);
+#endif // RANDFS_SIMD_WIDTH
+
 public:
 
 #pragma region Hash declaration (no seed)
 
 	// Hash a 64-bit integer to another 64-bit integer on the interval [0, 2^64-1]
-	static uint64_t UInt64(uint64_t n);
+	static RANDFS_CONSTEXPR uint64_t UInt64(uint64_t n);
 	// Hash a 64-bit integer to another 64-bit integer on the interval [-2^63, 2^63-1]
-	static int64_t Int64(uint64_t n);
+	static RANDFS_CONSTEXPR int64_t Int64(uint64_t n);
 	// Hash a 64-bit integer to another 64-bit integer on the interval [0, 2^63-1]
-	static int64_t PosInt64(uint64_t n);
+	static RANDFS_CONSTEXPR int64_t PosInt64(uint64_t n);
 	// Hash a 32-bit integer to another 32-bit integer on the interval [0, 2^32-1]
-	static uint32_t UInt32(uint32_t n);
+	static RANDFS_CONSTEXPR uint32_t UInt32(uint32_t n);
 	// Hash a 32-bit integer to another 32-bit integer on the interval [-2^31, 2^31-1]
-	static int32_t Int32(uint32_t n);
+	static RANDFS_CONSTEXPR int32_t Int32(uint32_t n);
 	// Hash a 32-bit integer to another 32-bit integer on the interval [0, 2^31-1]
-	static int32_t PosInt32(uint32_t n);
+	static RANDFS_CONSTEXPR int32_t PosInt32(uint32_t n);
 
 	// Hash a 64-bit integer to a double (64-bit floating-point value) on the closed interval [0, 1]
-	static double DoubleC(uint64_t n);
+	static RANDFS_CONSTEXPR double DoubleC(uint64_t n);
 	// Hash a 64-bit integer to a double (64-bit floating-point value) on the half-closed interval [0, 1)
-	static double DoubleH(uint64_t n);
+	static RANDFS_CONSTEXPR double DoubleH(uint64_t n);
 	// Hash a 64-bit integer to a double (64-bit floating-point value) on the open interval (0, 1)
-	static double DoubleO(uint64_t n);
+	static RANDFS_CONSTEXPR double DoubleO(uint64_t n);
 	// Hash a 32-bit integer to a 32-bit float on the closed interval [0, 1]
-	static float FloatC(uint32_t n);
+	static RANDFS_CONSTEXPR float FloatC(uint32_t n);
 	// Hash a 32-bit integer to a 32-bit float on the half-closed interval [0, 1)
-	static float FloatH(uint32_t n);
+	static RANDFS_CONSTEXPR float FloatH(uint32_t n);
 	// Hash a 32-bit integer to a 32-bit float on the open interval (0, 1)
-	static float FloatO(uint32_t n);
+	static RANDFS_CONSTEXPR float FloatO(uint32_t n);
 
 	// Hash a 32-bit integer to an 8-bit value
-	static uint8_t UInt8(uint32_t n);
+	static RANDFS_CONSTEXPR uint8_t UInt8(uint32_t n);
 	// Hash a 32-bit integer to a boolean
-	static bool Bool(uint32_t n);
+	static RANDFS_CONSTEXPR bool Bool(uint32_t n);
 
 	// Hash a 32-bit integer to another 32-bit integer on the half-closed interval [min, max)
-	static int32_t IntBetween(uint32_t n, int32_t min, int32_t max);
+	static RANDFS_CONSTEXPR int32_t IntBetween(uint32_t n, int32_t min, int32_t max);
 	// Hash a 32-bit integer to a 32-bit float on the closed interval [min, max]
-	static float FloatBetween(uint32_t n, float min, float max);
+	static RANDFS_CONSTEXPR float FloatBetween(uint32_t n, float min, float max);
 
 	// Hash a 32-bit integer to a 32-bit float with normal distribution, with mean 0 and standard deviation 1
-	static float FloatNormal(uint32_t n);
+	static RANDFS_CONSTEXPR float FloatNormal(uint32_t n);
 	// Hash a 32-bit integer to a 32-bit float with normal distribution, with the given mean and standard deviation (stdDev)
-	static float FloatNormal(uint32_t n, float mean, float stdDev);
+	static RANDFS_CONSTEXPR float FloatNormal(uint32_t n, float mean, float stdDev);
 
 	// Hash an arbitrary type to a 64-bit integer on [0, 2^64-1]-interval
 	template <typename T>
-	static uint64_t Type64(T n)
+	static RANDFS_CONSTEXPR uint64_t Type64(T n)
 	{
 		// Copy contents of n into a uint64_t array
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
 		uint64_t contents[contentSize] = { 0 };
-		memcpy(contents, &n, sizeof(T));
+		CopyWords(contents, n);
 
 		uint64_t x = contents[0];
 
@@ -460,12 +1342,12 @@ public:
 	}
 	// Hash an arbitrary type to a 32-bit integer on [0, 2^32-1]-interval
 	template <typename T>
-	static uint32_t Type32(T n)
+	static RANDFS_CONSTEXPR uint32_t Type32(T n)
 	{
 		// Copy contents of n into a uint32_t array
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
 		uint32_t contents[contentSize] = { 0 };
-		memcpy(contents, &n, sizeof(T));
+		CopyWords(contents, n);
 
 		uint32_t x = contents[0];
 
@@ -479,9 +1361,9 @@ public:
 	
 	// Hash the given arbitrary type array to a single 64-bit integer on [0, 2^64-1]-interval
 	template <typename T>
-	static uint64_t Array64(T* arr, uint32_t size)
+	static RANDFS_CONSTEXPR uint64_t Array64(T* arr, uint32_t size)
 	{
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
 		uint64_t contents[contentSize] = { 0 };
 
 		uint64_t x = 0ULL;
@@ -489,7 +1371,7 @@ public:
 		// Copy contents of each element of arr into a uint64_t array and pair them into x
 		for (uint32_t i = 0U; i < size; i++)
 		{
-			memcpy(contents, &arr[i], sizeof(T));
+			CopyWords(contents, arr[i]);
 
 			for (uint32_t j = 0U; j < contentSize; j++)
 			{
@@ -501,9 +1383,9 @@ public:
 	}
 	// Hash the given arbitrary type array to a single 32-bit integer on [0, 2^32-1]-interval
 	template <typename T>
-	static uint32_t Array32(T* arr, uint32_t size)
+	static RANDFS_CONSTEXPR uint32_t Array32(T* arr, uint32_t size)
 	{
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
 		uint32_t contents[contentSize] = { 0 };
 
 		uint32_t x = 0U;
@@ -511,7 +1393,7 @@ public:
 		// Copy contents of each element of arr into a uint32_t array and pair them into x
 		for (uint32_t i = 0U; i < size; i++)
 		{
-			memcpy(contents, &arr[i], sizeof(T));
+			CopyWords(contents, arr[i]);
 
 			for (uint32_t j = 0U; j < contentSize; j++)
 			{
@@ -523,70 +1405,87 @@ public:
 	}
 
 	// Hash the given string of characters to a 64-bit integer on [0, 2^64-1]-interval
-	static uint64_t String64(const char* string);
+	static RANDFS_CONSTEXPR uint64_t String64(const char* string);
 	// Hash the given string of characters to a 32-bit integer on [0, 2^32-1]-interval
-	static uint32_t String32(const char* string);
+	static RANDFS_CONSTEXPR uint32_t String32(const char* string);
+
+	// Hash the 'size' bytes at 'data' to a 64-bit integer on [0, 2^64-1]-interval, 16 bytes at a time
+	// Much faster than String64 and Array64 on long buffers, such as whole source files, but it gives different values from them
+	static uint64_t Bytes64(const void* data, uint64_t size);
+
+	// Hash each of the 'count' integers in 'n' into 'values', with the same result as the function without "Batch" in its name
+	// 'n' and 'values' may be the same array, to hash it in place
+	static void BatchUInt64(const uint64_t* n, uint64_t* values, uint32_t count);
+	static void BatchUInt32(const uint32_t* n, uint32_t* values, uint32_t count);
+	static void BatchFloatO(const uint32_t* n, float* values, uint32_t count);
+	static void BatchFloatNormal(const uint32_t* n, float* values, uint32_t count);
+
+	// Hash the 'count' integers first, first + stride, first + 2 * stride... into 'values', such as the indices of the pixels of a row
+	static void BatchUInt64(uint64_t first, uint64_t stride, uint64_t* values, uint32_t count);
+	static void BatchUInt32(uint32_t first, uint32_t stride, uint32_t* values, uint32_t count);
+	static void BatchFloatO(uint32_t first, uint32_t stride, float* values, uint32_t count);
+	static void BatchFloatNormal(uint32_t first, uint32_t stride, float* values, uint32_t count);
 
 #pragma endregion
 
 #pragma region Hash declaration (with seed)
 
 	// Hash a 64-bit integer and a 64-bit seed to a 64-bit integer on the interval [0, 2^64-1]
-	static uint64_t UInt64(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR uint64_t UInt64(uint64_t n, uint64_t seed);
 	// Hash a 64-bit integer and a 64-bit seed to a 64-bit integer on the interval [-2^63, 2^63-1]
-	static int64_t Int64(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR int64_t Int64(uint64_t n, uint64_t seed);
 	// Hash a 64-bit integer and a 64-bit seed to a 64-bit integer on the interval [0, 2^63-1]
-	static int64_t PosInt64(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR int64_t PosInt64(uint64_t n, uint64_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit integer on the interval [0, 2^32-1]
-	static uint32_t UInt32(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR uint32_t UInt32(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit integer on the interval [-2^31, 2^31-1]
-	static int32_t Int32(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR int32_t Int32(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit integer on the interval [0, 2^31-1]
-	static int32_t PosInt32(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR int32_t PosInt32(uint32_t n, uint32_t seed);
 
 	// Hash a 64-bit integer and a 64-bit seed to a double (64-bit floating-point value) on the closed interval [0, 1]
-	static double DoubleC(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR double DoubleC(uint64_t n, uint64_t seed);
 	// Hash a 64-bit integer and a 64-bit seed to a double (64-bit floating-point value) on the half-closed interval [0, 1)
-	static double DoubleH(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR double DoubleH(uint64_t n, uint64_t seed);
 	// Hash a 64-bit integer and a 64-bit seed to a double (64-bit floating-point value) on the open interval (0, 1)
-	static double DoubleO(uint64_t n, uint64_t seed);
+	static RANDFS_CONSTEXPR double DoubleO(uint64_t n, uint64_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float on the closed interval [0, 1]
-	static float FloatC(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR float FloatC(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float on the half-closed interval [0, 1)
-	static float FloatH(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR float FloatH(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float on the open interval (0, 1)
-	static float FloatO(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR float FloatO(uint32_t n, uint32_t seed);
 
 	// Hash a 32-bit integer and a 32-bit seed to an 8-bit value
-	static uint8_t UInt8(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR uint8_t UInt8(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a boolean
-	static bool Bool(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR bool Bool(uint32_t n, uint32_t seed);
 
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit integer on the half-closed interval [min, max)
-	static int32_t IntBetween(uint32_t n, uint32_t seed, int32_t min, int32_t max);
+	static RANDFS_CONSTEXPR int32_t IntBetween(uint32_t n, uint32_t seed, int32_t min, int32_t max);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float on the closed interval [min, max]
-	static float FloatBetween(uint32_t n, uint32_t seed, float min, float max);
+	static RANDFS_CONSTEXPR float FloatBetween(uint32_t n, uint32_t seed, float min, float max);
 	
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float with normal distribution, with mean 0 and standard deviation 1
-	static float FloatNormal(uint32_t n, uint32_t seed);
+	static RANDFS_CONSTEXPR float FloatNormal(uint32_t n, uint32_t seed);
 	// Hash a 32-bit integer and a 32-bit seed to a 32-bit float with normal distribution, with the given mean and standard deviation (stdDev)
-	static float FloatNormal(uint32_t n, uint32_t seed, float mean, float stdDev);
+	static RANDFS_CONSTEXPR float FloatNormal(uint32_t n, uint32_t seed, float mean, float stdDev);
 
 	// Hash multiple 64-bit integers to a single 64-bit integer on [0, 2^64-1]-interval
 	template <typename... Args>
-	static uint64_t UInt64(uint64_t n1, uint64_t n2, Args... n) { return UInt64(Pair(n1, n2, n...)); }
+	static RANDFS_CONSTEXPR uint64_t UInt64(uint64_t n1, uint64_t n2, Args... n) { return UInt64(Pair(n1, n2, n...)); }
 	// Hash multiple 32-bit integers to a single 32-bit integer on [0, 2^32-1]-interval
 	template <typename... Args>
-	static uint32_t UInt32(uint32_t n1, uint32_t n2, Args... n) { return UInt32(Pair(n1, n2, n...)); }
+	static RANDFS_CONSTEXPR uint32_t UInt32(uint32_t n1, uint32_t n2, Args... n) { return UInt32(Pair(n1, n2, n...)); }
 
 	// Hash an arbitrary type and a 64-bit seed to a 64-bit integer on [0, 2^64-1]-interval
 	template <typename T>
-	static uint64_t Type64(T n, uint64_t seed)
+	static RANDFS_CONSTEXPR uint64_t Type64(T n, uint64_t seed)
 	{
 		// Copy contents of n into a uint64_t array
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
 		uint64_t contents[contentSize] = { 0 };
-		memcpy(contents, &n, sizeof(T));
+		CopyWords(contents, n);
 
 		uint64_t x = contents[0];
 
@@ -599,12 +1498,12 @@ public:
 	}
 	// Hash an arbitrary type and a 32-bit seed to a 32-bit integer on [0, 2^32-1]-interval
 	template <typename T>
-	static uint32_t Type32(T n, uint32_t seed)
+	static RANDFS_CONSTEXPR uint32_t Type32(T n, uint32_t seed)
 	{
 		// Copy contents of n into a uint32_t array
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
 		uint32_t contents[contentSize] = { 0 };
-		memcpy(contents, &n, sizeof(T));
+		CopyWords(contents, n);
 
 		uint32_t x = contents[0];
 
@@ -618,9 +1517,9 @@ public:
 	
 	// Hash the given arbitrary type array and a 64-bit seed to a single 64-bit integer on [0, 2^64-1]-interval
 	template <typename T>
-	static uint64_t Array64(T* arr, uint32_t size, uint64_t seed)
+	static RANDFS_CONSTEXPR uint64_t Array64(T* arr, uint32_t size, uint64_t seed)
 	{
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint64_t) - 1U) / sizeof(uint64_t); // Same as sizeof(T) / sizeof(uint64_t) but rounded up
 		uint64_t contents[contentSize] = { 0 };
 
 		uint64_t x = 0ULL;
@@ -628,7 +1527,7 @@ public:
 		// Copy contents of each element of arr into a uint64_t array and pair them into x
 		for (uint32_t i = 0U; i < size; i++)
 		{
-			memcpy(contents, &arr[i], sizeof(T));
+			CopyWords(contents, arr[i]);
 
 			for (uint32_t j = 0U; j < contentSize; j++)
 			{
@@ -640,9 +1539,9 @@ public:
 	}
 	// Hash the given arbitrary type array and a 32-bit seed to a single 32-bit integer on [0, 2^32-1]-interval
 	template <typename T>
-	static uint32_t Array32(T* arr, uint32_t size, uint32_t seed)
+	static RANDFS_CONSTEXPR uint32_t Array32(T* arr, uint32_t size, uint32_t seed)
 	{
-		static constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
+		constexpr uint32_t contentSize = (sizeof(T) + sizeof(uint32_t) - 1U) / sizeof(uint32_t); // Same as sizeof(T) / sizeof(uint32_t) but rounded up
 		uint32_t contents[contentSize] = { 0 };
 
 		uint32_t x = 0U;
@@ -650,7 +1549,7 @@ public:
 		// Copy contents of each element of arr into a uint32_t array and pair them into x
 		for (uint32_t i = 0U; i < size; i++)
 		{
-			memcpy(contents, &arr[i], sizeof(T));
+			CopyWords(contents, arr[i]);
 
 			for (uint32_t j = 0U; j < contentSize; j++)
 			{
@@ -662,13 +1561,16 @@ public:
 	}
 
 	// Hash the given string of characters and a 64-bit seed to a 64-bit integer on [0, 2^64-1]-interval
-	static uint64_t String64(const char* string, uint64_t seed);
+	static RANDFS_CONSTEXPR uint64_t String64(const char* string, uint64_t seed);
 	// Hash the given string of characters and a 32-bit seed to a 32-bit integer on [0, 2^32-1]-interval
-	static uint32_t String32(const char* string, uint32_t seed);
+	static RANDFS_CONSTEXPR uint32_t String32(const char* string, uint32_t seed);
+
+	// Hash the 'size' bytes at 'data' and a 64-bit seed to a 64-bit integer on [0, 2^64-1]-interval, 16 bytes at a time
+	static uint64_t Bytes64(const void* data, uint64_t size, uint64_t seed);
 
 	// Shuffle the given array from a 64-bit hash seed
 	template <typename T>
-	static void ShuffleArray64(T* arr, uint64_t size, uint64_t seed)
+	static RANDFS_CONSTEXPR void ShuffleArray64(T* arr, uint64_t size, uint64_t seed)
 	{
 		// Fisher–Yates shuffle
 		for (; size > 0ULL; size--)
@@ -682,7 +1584,7 @@ public:
 	}
 	// Shuffle the given array from a 32-bit hash seed
 	template <typename T>
-	static void ShuffleArray32(T* arr, uint32_t size, uint32_t seed)
+	static RANDFS_CONSTEXPR void ShuffleArray32(T* arr, uint32_t size, uint32_t seed)
 	{
 		// Fisher–Yates shuffle
 		for (; size > 0U; size--)
@@ -696,26 +1598,61 @@ public:
 	}
 	// Return a reference to an element in the given array selected from a 64-bit hash seed
 	template <typename T>
-	static T& Element64(T* arr, uint64_t size, uint64_t seed)
+	static RANDFS_CONSTEXPR T& Element64(T* arr, uint64_t size, uint64_t seed)
 	{
 		return arr[UInt64(seed) % size];
 	}
 	// Return a reference to an element in the given array selected from a 32-bit hash seed
 	template <typename T>
-	static T& Element32(T* arr, uint32_t size, uint32_t seed)
+	static RANDFS_CONSTEXPR T& Element32(T* arr, uint32_t size, uint32_t seed)
 	{
 		return arr[UInt32(seed) % size];
 	}
 
 #pragma endregion
 
-};
+#pragma region Hash declaration (streaming)
 
-#ifdef RANDFS_IMPLEMENTATION
+	// Incremental version of Bytes64, for data that arrives in pieces, such as a file read in chunks
+	// Any split of the same bytes into calls of Update gives the same Digest as a single call of Bytes64
+	class Stream64
+	{
+	public:
+		Stream64(uint64_t seed = 0ULL);
+
+		// Append the 'size' bytes at 'data' to the hashed bytes
+		void Update(const void* data, uint64_t size);
+		// Hash of all the bytes appended so far, which may still be followed by more calls of Update
+		uint64_t Digest() const;
+
+	private:
+		uint64_t m_Lanes[2]; // Accumulators of the 8-byte words at even and odd positions of each 16-byte block
+		uint64_t m_Seed;
+		uint64_t m_Size; // Number of bytes appended so far, the last (m_Size % 16) of which are still in m_Buffer
+		uint8_t m_Buffer[16];
+
+		static constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+		static constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+		static constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+		static constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+		static constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+		static uint64_t RotateLeft(uint64_t x, uint32_t k) { return (x << k) | (x >> (64U - k)); }
+		static uint64_t Round(uint64_t lane, uint64_t word) { return RotateLeft(lane + word * Prime2, 31U) * Prime1; }
+
+		// Mix 'count' whole blocks of 16 bytes into the lanes
+		void Blocks(const uint8_t* bytes, uint64_t count);
+	};
+
+#pragma endregion
+
+};
 
 #pragma region Hash implementation (no seed)
 
-uint64_t Hash::UInt64  (uint64_t n)
+// The functions that do not use SIMD instructions are defined in the header, since constexpr functions have to be defined wherever they are used
+
+RANDFS_CONSTEXPR uint64_t Hash::UInt64  (uint64_t n)
 {
 	// Google's implementation of Murmur3 hash (see license at the end of file)
 	uint64_t x = n;
@@ -727,10 +1664,10 @@ uint64_t Hash::UInt64  (uint64_t n)
 	x *= 0x9ddfea08eb382d69ULL;
 	return x;
 }
-int64_t  Hash::Int64   (uint64_t n) { return int64_t(UInt64(n)); }
-int64_t  Hash::PosInt64(uint64_t n) { return int64_t(UInt64(n) >> 1); }
+RANDFS_CONSTEXPR int64_t  Hash::Int64   (uint64_t n) { return int64_t(UInt64(n)); }
+RANDFS_CONSTEXPR int64_t  Hash::PosInt64(uint64_t n) { return int64_t(UInt64(n) >> 1); }
 
-uint32_t Hash::UInt32  (uint32_t n)
+RANDFS_CONSTEXPR uint32_t Hash::UInt32  (uint32_t n)
 {
 	// Google's implementation of Murmur3 hash (see license at the end of file)
 	n ^= (n >> 16);
@@ -740,37 +1677,34 @@ uint32_t Hash::UInt32  (uint32_t n)
 	n ^= (n >> 16);
 	return n;
 }
-int32_t  Hash::Int32   (uint32_t n) { return int32_t(UInt32(n)); }
-int32_t  Hash::PosInt32(uint32_t n) { return int32_t(UInt32(n) >> 1); }
+RANDFS_CONSTEXPR int32_t  Hash::Int32   (uint32_t n) { return int32_t(UInt32(n)); }
+RANDFS_CONSTEXPR int32_t  Hash::PosInt32(uint32_t n) { return int32_t(UInt32(n) >> 1); }
 
-double Hash::DoubleC(uint64_t n) { return (UInt64(n) >> 11) * (1.0 / 9007199254740991.0); }
-double Hash::DoubleH(uint64_t n) { return (UInt64(n) >> 11) * (1.0 / 9007199254740992.0); }
-double Hash::DoubleO(uint64_t n) { return ((UInt64(n) >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
-float  Hash::FloatC (uint32_t n) { return (UInt32(n) >> 8) * (1.0f / 16777215.0f); }
-float  Hash::FloatH (uint32_t n) { return (UInt32(n) >> 8) * (1.0f / 16777216.0f); }
-float  Hash::FloatO (uint32_t n) { return ((UInt32(n) >> 9) + 0.5f) * (1.0f / 8388608.0f); }
+RANDFS_CONSTEXPR double Hash::DoubleC(uint64_t n) { return (UInt64(n) >> 11) * (1.0 / 9007199254740991.0); }
+RANDFS_CONSTEXPR double Hash::DoubleH(uint64_t n) { return (UInt64(n) >> 11) * (1.0 / 9007199254740992.0); }
+RANDFS_CONSTEXPR double Hash::DoubleO(uint64_t n) { return ((UInt64(n) >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
+RANDFS_CONSTEXPR float  Hash::FloatC (uint32_t n) { return (UInt32(n) >> 8) * (1.0f / 16777215.0f); }
+RANDFS_CONSTEXPR float  Hash::FloatH (uint32_t n) { return (UInt32(n) >> 8) * (1.0f / 16777216.0f); }
+RANDFS_CONSTEXPR float  Hash::FloatO (uint32_t n) { return ((UInt32(n) >> 9) + 0.5f) * (1.0f / 8388608.0f); }
 
-uint8_t Hash::UInt8(uint32_t n) { return uint8_t(UInt32(n)); }
-bool    Hash::Bool (uint32_t n) { return UInt32(n) & 1U; }
+RANDFS_CONSTEXPR uint8_t Hash::UInt8(uint32_t n) { return uint8_t(UInt32(n)); }
+RANDFS_CONSTEXPR bool    Hash::Bool (uint32_t n) { return UInt32(n) & 1U; }
 
-int32_t Hash::IntBetween  (uint32_t n, int32_t min, int32_t max) { return PosInt32(n) % (max - min) + min; }
-float   Hash::FloatBetween(uint32_t n,   float min,   float max) { return FloatC  (n) * (max - min) + min; }
+RANDFS_CONSTEXPR int32_t Hash::IntBetween  (uint32_t n, int32_t min, int32_t max) { return PosInt32(n) % (max - min) + min; }
+RANDFS_CONSTEXPR float   Hash::FloatBetween(uint32_t n,   float min,   float max) { return FloatC  (n) * (max - min) + min; }
 
 // See comment above Random::FloatNormal implementation for an explanation of the algorithm
-float Hash::FloatNormal(uint32_t n)
+RANDFS_CONSTEXPR float Hash::FloatNormal(uint32_t n)
 {
 	float u1 = FloatO(n);
 	float u2 = 1.0f - u1;
-	int32_t r1, r2;
-	memcpy(&r1, &u1, sizeof(float));
-	memcpy(&r2, &u2, sizeof(float));
-	return 5.0003944e-8f * (r1 - r2);
+	return 5.0003944e-8f * (FloatBits(u1) - FloatBits(u2));
 }
-float Hash::FloatNormal(uint32_t n, float mean, float stdDev) { return FloatNormal(n) * stdDev + mean; }
+RANDFS_CONSTEXPR float Hash::FloatNormal(uint32_t n, float mean, float stdDev) { return FloatNormal(n) * stdDev + mean; }
 
 // Hash the given array of 64-bit integers to a single 64-bit integer on [0, 2^64-1]-interval
 template <>
-uint64_t Hash::Array64(uint64_t* arr, uint32_t size)
+RANDFS_CONSTEXPR uint64_t Hash::Array64(uint64_t* arr, uint32_t size)
 {
 	uint64_t x = arr[0];
 
@@ -783,7 +1717,7 @@ uint64_t Hash::Array64(uint64_t* arr, uint32_t size)
 }
 // Hash the given array of 32-bit integers to a single 32-bit integer on [0, 2^32-1]-interval
 template <>
-uint32_t Hash::Array32(uint32_t* arr, uint32_t size)
+RANDFS_CONSTEXPR uint32_t Hash::Array32(uint32_t* arr, uint32_t size)
 {
 	uint32_t x = arr[0];
 
@@ -795,7 +1729,7 @@ uint32_t Hash::Array32(uint32_t* arr, uint32_t size)
 	return UInt32(x);
 }
 
-uint64_t Hash::String64(const char* string)
+RANDFS_CONSTEXPR uint64_t Hash::String64(const char* string)
 {
 	uint64_t x = 0ULL;
 	
@@ -806,7 +1740,7 @@ uint64_t Hash::String64(const char* string)
 	
 	return UInt64(x);
 }
-uint32_t Hash::String32(const char* string)
+RANDFS_CONSTEXPR uint32_t Hash::String32(const char* string)
 {
 	uint32_t x = 0U;
 
@@ -822,42 +1756,39 @@ uint32_t Hash::String32(const char* string)
 
 #pragma region Hash implementation (with seed)
 
-uint64_t Hash::UInt64  (uint64_t n, uint64_t seed) { return UInt64(Pair(n, seed)); }
-int64_t  Hash::Int64   (uint64_t n, uint64_t seed) { return int64_t(UInt64(n, seed)); }
-int64_t  Hash::PosInt64(uint64_t n, uint64_t seed) { return int64_t(UInt64(n, seed) >> 1); }
+RANDFS_CONSTEXPR uint64_t Hash::UInt64  (uint64_t n, uint64_t seed) { return UInt64(Pair(n, seed)); }
+RANDFS_CONSTEXPR int64_t  Hash::Int64   (uint64_t n, uint64_t seed) { return int64_t(UInt64(n, seed)); }
+RANDFS_CONSTEXPR int64_t  Hash::PosInt64(uint64_t n, uint64_t seed) { return int64_t(UInt64(n, seed) >> 1); }
 
-uint32_t Hash::UInt32  (uint32_t n, uint32_t seed) { return UInt32(Pair(n, seed)); }
-int32_t  Hash::Int32   (uint32_t n, uint32_t seed) { return int32_t(UInt32(n, seed)); }
-int32_t  Hash::PosInt32(uint32_t n, uint32_t seed) { return int32_t(UInt32(n, seed) >> 1); }
+RANDFS_CONSTEXPR uint32_t Hash::UInt32  (uint32_t n, uint32_t seed) { return UInt32(Pair(n, seed)); }
+RANDFS_CONSTEXPR int32_t  Hash::Int32   (uint32_t n, uint32_t seed) { return int32_t(UInt32(n, seed)); }
+RANDFS_CONSTEXPR int32_t  Hash::PosInt32(uint32_t n, uint32_t seed) { return int32_t(UInt32(n, seed) >> 1); }
 
-double Hash::DoubleC(uint64_t n, uint64_t seed) { return (UInt64(n, seed) >> 11) * (1.0 / 9007199254740991.0); }
-double Hash::DoubleH(uint64_t n, uint64_t seed) { return (UInt64(n, seed) >> 11) * (1.0 / 9007199254740992.0); }
-double Hash::DoubleO(uint64_t n, uint64_t seed) { return ((UInt64(n, seed) >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
-float  Hash::FloatC (uint32_t n, uint32_t seed) { return (UInt32(n, seed) >> 8) * (1.0f / 16777215.0f); }
-float  Hash::FloatH (uint32_t n, uint32_t seed) { return (UInt32(n, seed) >> 8) * (1.0f / 16777216.0f); }
-float  Hash::FloatO (uint32_t n, uint32_t seed) { return ((UInt32(n, seed) >> 9) + 0.5f) * (1.0f / 8388608.0f); }
+RANDFS_CONSTEXPR double Hash::DoubleC(uint64_t n, uint64_t seed) { return (UInt64(n, seed) >> 11) * (1.0 / 9007199254740991.0); }
+RANDFS_CONSTEXPR double Hash::DoubleH(uint64_t n, uint64_t seed) { return (UInt64(n, seed) >> 11) * (1.0 / 9007199254740992.0); }
+RANDFS_CONSTEXPR double Hash::DoubleO(uint64_t n, uint64_t seed) { return ((UInt64(n, seed) >> 12) + 0.5) * (1.0 / 4503599627370496.0); }
+RANDFS_CONSTEXPR float  Hash::FloatC (uint32_t n, uint32_t seed) { return (UInt32(n, seed) >> 8) * (1.0f / 16777215.0f); }
+RANDFS_CONSTEXPR float  Hash::FloatH (uint32_t n, uint32_t seed) { return (UInt32(n, seed) >> 8) * (1.0f / 16777216.0f); }
+RANDFS_CONSTEXPR float  Hash::FloatO (uint32_t n, uint32_t seed) { return ((UInt32(n, seed) >> 9) + 0.5f) * (1.0f / 8388608.0f); }
 
-uint8_t Hash::UInt8(uint32_t n, uint32_t seed) { return uint8_t(UInt32(n, seed)); }
-bool    Hash::Bool (uint32_t n, uint32_t seed) { return UInt32(n, seed) & 1U; }
+RANDFS_CONSTEXPR uint8_t Hash::UInt8(uint32_t n, uint32_t seed) { return uint8_t(UInt32(n, seed)); }
+RANDFS_CONSTEXPR bool    Hash::Bool (uint32_t n, uint32_t seed) { return UInt32(n, seed) & 1U; }
 
-int32_t Hash::IntBetween  (uint32_t n, uint32_t seed, int32_t min, int32_t max) { return PosInt32(n, seed) % (max - min) + min; }
-float   Hash::FloatBetween(uint32_t n, uint32_t seed,   float min,   float max) { return FloatC  (n, seed) * (max - min) + min; }
+RANDFS_CONSTEXPR int32_t Hash::IntBetween  (uint32_t n, uint32_t seed, int32_t min, int32_t max) { return PosInt32(n, seed) % (max - min) + min; }
+RANDFS_CONSTEXPR float   Hash::FloatBetween(uint32_t n, uint32_t seed,   float min,   float max) { return FloatC  (n, seed) * (max - min) + min; }
 
 // See comment above Random::FloatNormal implementation for an explanation of the algorithm
-float Hash::FloatNormal(uint32_t n, uint32_t seed)
+RANDFS_CONSTEXPR float Hash::FloatNormal(uint32_t n, uint32_t seed)
 {
 	float u1 = FloatO(n, seed);
 	float u2 = 1.0f - u1;
-	int32_t r1, r2;
-	memcpy(&r1, &u1, sizeof(float));
-	memcpy(&r2, &u2, sizeof(float));
-	return 5.0003944e-8f * (r1 - r2);
+	return 5.0003944e-8f * (FloatBits(u1) - FloatBits(u2));
 }
-float Hash::FloatNormal(uint32_t n, uint32_t seed, float mean, float stdDev) { return FloatNormal(n, seed) * stdDev + mean; }
+RANDFS_CONSTEXPR float Hash::FloatNormal(uint32_t n, uint32_t seed, float mean, float stdDev) { return FloatNormal(n, seed) * stdDev + mean; }
 
 // Hash the given array of 64-bit integers and a 64-bit seed to a single 64-bit integer on [0, 2^64-1]-interval
 template <>
-uint64_t Hash::Array64(uint64_t* arr, uint32_t size, uint64_t seed)
+RANDFS_CONSTEXPR uint64_t Hash::Array64(uint64_t* arr, uint32_t size, uint64_t seed)
 {
 	uint64_t x = arr[0];
 
@@ -870,7 +1801,7 @@ uint64_t Hash::Array64(uint64_t* arr, uint32_t size, uint64_t seed)
 }
 // Hash the given array of 32-bit integers and a 32-bit seed to a single 32-bit integer on [0, 2^32-1]-interval
 template <>
-uint32_t Hash::Array32(uint32_t* arr, uint32_t size, uint32_t seed)
+RANDFS_CONSTEXPR uint32_t Hash::Array32(uint32_t* arr, uint32_t size, uint32_t seed)
 {
 	uint32_t x = arr[0];
 
@@ -882,7 +1813,7 @@ uint32_t Hash::Array32(uint32_t* arr, uint32_t size, uint32_t seed)
 	return UInt32(x, seed);
 }
 
-uint64_t Hash::String64(const char* string, uint64_t seed)
+RANDFS_CONSTEXPR uint64_t Hash::String64(const char* string, uint64_t seed)
 {
 	uint64_t x = 0ULL;
 	
@@ -893,7 +1824,7 @@ uint64_t Hash::String64(const char* string, uint64_t seed)
 	
 	return UInt64(x, seed);
 }
-uint32_t Hash::String32(const char* string, uint32_t seed)
+RANDFS_CONSTEXPR uint32_t Hash::String32(const char* string, uint32_t seed)
 {
 	uint32_t x = 0U;
 
@@ -905,6 +1836,214 @@ uint32_t Hash::String32(const char* string, uint32_t seed)
 	return UInt32(x, seed);
 }
 
+#pragma endregion
+
+#ifdef RANDFS_IMPLEMENTATION
+
+#pragma region Hash implementation (batch)
+
+void Hash::BatchUInt64(const uint64_t* n, uint64_t* values, uint32_t count)
+{
+	uint32_t i = 0U;
+#ifdef RANDFS_SIMD_MUL64
+	for (; i + RANDFS_SIMD_WIDTH <= count; i += RANDFS_SIMD_WIDTH)
+		UInt64Lanes(&n[i], &values[i]);
+#endif // RANDFS_SIMD_MUL64
+	for (; i < count; i++)
+		values[i] = UInt64(n[i]);
+}
+void Hash::BatchUInt32(const uint32_t* n, uint32_t* values, uint32_t count)
+{
+	uint32_t i = 0U;
+#ifdef RANDFS_SIMD_WIDTH
+	for (; i + 2U * RANDFS_SIMD_WIDTH <= count; i += 2U * RANDFS_SIMD_WIDTH)
+		UInt32Lanes(&n[i], &values[i]);
+#endif // RANDFS_SIMD_WIDTH
+	for (; i < count; i++)
+		values[i] = UInt32(n[i]);
+}
+
+void Hash::HashesToFloatO(const uint32_t* hashes, float* values, uint32_t count)
+{
+	uint32_t i = 0U;
+#ifdef RANDFS_SIMD_WIDTH
+	for (; i + 2U * RANDFS_SIMD_WIDTH <= count; i += 2U * RANDFS_SIMD_WIDTH)
+		FloatOLanes(&hashes[i], &values[i]);
+#endif // RANDFS_SIMD_WIDTH
+	for (; i < count; i++)
+		values[i] = ((hashes[i] >> 9) + 0.5f) * (1.0f / 8388608.0f);
+}
+void Hash::HashesToFloatNormal(const uint32_t* hashes, float* values, uint32_t count)
+{
+	uint32_t i = 0U;
+#ifdef RANDFS_SIMD_WIDTH
+	for (; i + 2U * RANDFS_SIMD_WIDTH <= count; i += 2U * RANDFS_SIMD_WIDTH)
+		FloatNormalLanes(&hashes[i], &values[i]);
+#endif // RANDFS_SIMD_WIDTH
+	for (; i < count; i++)
+	{
+		float u1 = ((hashes[i] >> 9) + 0.5f) * (1.0f / 8388608.0f);
+		float u2 = 1.0f - u1;
+		int32_t r1, r2;
+		memcpy(&r1, &u1, sizeof(float));
+		memcpy(&r2, &u2, sizeof(float));
+		values[i] = 5.0003944e-8f * (r1 - r2);
+	}
+}
+
+void Hash::BatchFloatO(const uint32_t* n, float* values, uint32_t count)
+{
+	uint32_t hashes[BatchChunk];
+	for (uint32_t i = 0U; i < count; i += BatchChunk)
+	{
+		const uint32_t size = count - i < BatchChunk ? count - i : BatchChunk;
+		BatchUInt32(&n[i], hashes, size);
+		HashesToFloatO(hashes, &values[i], size);
+	}
+}
+void Hash::BatchFloatNormal(const uint32_t* n, float* values, uint32_t count)
+{
+	uint32_t hashes[BatchChunk];
+	for (uint32_t i = 0U; i < count; i += BatchChunk)
+	{
+		const uint32_t size = count - i < BatchChunk ? count - i : BatchChunk;
+		BatchUInt32(&n[i], hashes, size);
+		HashesToFloatNormal(hashes, &values[i], size);
+	}
+}
+
+// The keys are written to the output and hashed in place, or to a buffer on the stack for the floats
+void Hash::BatchUInt64(uint64_t first, uint64_t stride, uint64_t* values, uint32_t count)
+{
+	for (uint32_t i = 0U; i < count; i++)
+		values[i] = first + stride * i;
+	BatchUInt64(values, values, count);
+}
+void Hash::BatchUInt32(uint32_t first, uint32_t stride, uint32_t* values, uint32_t count)
+{
+	for (uint32_t i = 0U; i < count; i++)
+		values[i] = first + stride * i;
+	BatchUInt32(values, values, count);
+}
+void Hash::BatchFloatO(uint32_t first, uint32_t stride, float* values, uint32_t count)
+{
+	uint32_t hashes[BatchChunk];
+	for (uint32_t i = 0U; i < count; i += BatchChunk)
+	{
+		const uint32_t size = count - i < BatchChunk ? count - i : BatchChunk;
+		for (uint32_t j = 0U; j < size; j++)
+			hashes[j] = first + stride * (i + j);
+		BatchUInt32(hashes, hashes, size);
+		HashesToFloatO(hashes, &values[i], size);
+	}
+}
+void Hash::BatchFloatNormal(uint32_t first, uint32_t stride, float* values, uint32_t count)
+{
+	uint32_t hashes[BatchChunk];
+	for (uint32_t i = 0U; i < count; i += BatchChunk)
+	{
+		const uint32_t size = count - i < BatchChunk ? count - i : BatchChunk;
+		for (uint32_t j = 0U; j < size; j++)
+			hashes[j] = first + stride * (i + j);
+		BatchUInt32(hashes, hashes, size);
+		HashesToFloatNormal(hashes, &values[i], size);
+	}
+}
+
+#ifdef RANDFS_SIMD_WIDTH
+
+#ifdef RANDFS_SIMD_MUL64
+
+void Hash::UInt64Lanes(const uint64_t* n, uint64_t* values)
+{
+	// Zero-masked instructions are used for the same reason as in MersenneTwister64::TwistLanes
+	const __m512i k = _mm512_set1_epi64(int64_t(0x9ddfea08eb382d69ULL));
+	const __m512i key = _mm512_loadu_si512(n);
+	__m512i x = _mm512_maskz_mullo_epi64(__mmask8(0xff), key, k);
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi64(__mmask8(0xff), x, 47));
+	x = _mm512_xor_si512(x, key);
+	x = _mm512_maskz_mullo_epi64(__mmask8(0xff), x, k);
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi64(__mmask8(0xff), x, 47));
+	x = _mm512_maskz_mullo_epi64(__mmask8(0xff), x, k);
+	_mm512_storeu_si512(values, x);
+}
+
+#endif // RANDFS_SIMD_MUL64
+
+void Hash::UInt32Lanes(const uint32_t* n, uint32_t* values)
+{
+#if RANDFS_SIMD_WIDTH == 8U
+	__m512i x = _mm512_loadu_si512(n);
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi32(__mmask16(0xffff), x, 16));
+	x = _mm512_mullo_epi32(x, _mm512_set1_epi32(int32_t(0x85ebca6bU)));
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi32(__mmask16(0xffff), x, 13));
+	x = _mm512_mullo_epi32(x, _mm512_set1_epi32(int32_t(0xc2b2ae35U)));
+	x = _mm512_xor_si512(x, _mm512_maskz_srli_epi32(__mmask16(0xffff), x, 16));
+	_mm512_storeu_si512(values, x);
+#elif RANDFS_SIMD_WIDTH == 4U
+	__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(n));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(int32_t(0x85ebca6bU)));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 13));
+	x = _mm256_mullo_epi32(x, _mm256_set1_epi32(int32_t(0xc2b2ae35U)));
+	x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(values), x);
+#else
+	// SSE2 only multiplies the even 32-bit lanes into 64 bits, so the odd lanes are shifted down and multiplied separately
+	auto multiply = [](__m128i x, uint32_t k)
+	{
+		const __m128i constant = _mm_set1_epi32(int32_t(k));
+		const __m128i even = _mm_mul_epu32(x, constant);
+		const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), constant);
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	};
+	__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(n));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	x = multiply(x, 0x85ebca6bU);
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 13));
+	x = multiply(x, 0xc2b2ae35U);
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(values), x);
+#endif
+}
+
+// The top 23 bits of the hash convert to float exactly, so the rounding of the rest is the same as in FloatO
+void Hash::FloatOLanes(const uint32_t* hashes, float* values)
+{
+#if RANDFS_SIMD_WIDTH == 8U
+	const __m512 u = _mm512_maskz_cvtepi32_ps(__mmask16(0xffff), _mm512_maskz_srli_epi32(__mmask16(0xffff), _mm512_loadu_si512(hashes), 9));
+	_mm512_storeu_ps(values, _mm512_mul_ps(_mm512_add_ps(u, _mm512_set1_ps(0.5f)), _mm512_set1_ps(1.0f / 8388608.0f)));
+#elif RANDFS_SIMD_WIDTH == 4U
+	const __m256 u = _mm256_cvtepi32_ps(_mm256_srli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hashes)), 9));
+	_mm256_storeu_ps(values, _mm256_mul_ps(_mm256_add_ps(u, _mm256_set1_ps(0.5f)), _mm256_set1_ps(1.0f / 8388608.0f)));
+#else
+	const __m128 u = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hashes)), 9));
+	_mm_storeu_ps(values, _mm_mul_ps(_mm_add_ps(u, _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f / 8388608.0f)));
+#endif
+}
+
+void Hash::FloatNormalLanes(const uint32_t* hashes, float* values)
+{
+#if RANDFS_SIMD_WIDTH == 8U
+	const __m512 u0 = _mm512_maskz_cvtepi32_ps(__mmask16(0xffff), _mm512_maskz_srli_epi32(__mmask16(0xffff), _mm512_loadu_si512(hashes), 9));
+	const __m512 u = _mm512_mul_ps(_mm512_add_ps(u0, _mm512_set1_ps(0.5f)), _mm512_set1_ps(1.0f / 8388608.0f));
+	const __m512i r = _mm512_sub_epi32(_mm512_castps_si512(u), _mm512_castps_si512(_mm512_sub_ps(_mm512_set1_ps(1.0f), u)));
+	_mm512_storeu_ps(values, _mm512_mul_ps(_mm512_set1_ps(5.0003944e-8f), _mm512_maskz_cvtepi32_ps(__mmask16(0xffff), r)));
+#elif RANDFS_SIMD_WIDTH == 4U
+	const __m256 u0 = _mm256_cvtepi32_ps(_mm256_srli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hashes)), 9));
+	const __m256 u = _mm256_mul_ps(_mm256_add_ps(u0, _mm256_set1_ps(0.5f)), _mm256_set1_ps(1.0f / 8388608.0f));
+	const __m256i r = _mm256_sub_epi32(_mm256_castps_si256(u), _mm256_castps_si256(_mm256_sub_ps(_mm256_set1_ps(1.0f), u)));
+	_mm256_storeu_ps(values, _mm256_mul_ps(_mm256_set1_ps(5.0003944e-8f), _mm256_cvtepi32_ps(r)));
+#else
+	const __m128 u0 = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hashes)), 9));
+	const __m128 u = _mm_mul_ps(_mm_add_ps(u0, _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f / 8388608.0f));
+	const __m128i r = _mm_sub_epi32(_mm_castps_si128(u), _mm_castps_si128(_mm_sub_ps(_mm_set1_ps(1.0f), u)));
+	_mm_storeu_ps(values, _mm_mul_ps(_mm_set1_ps(5.0003944e-8f), _mm_cvtepi32_ps(r)));
+#endif
+}
+
+#endif // RANDFS_SIMD_WIDTH
+
 #ifdef RANDFS_NO_STD
 
 void Hash::memcpy(void* dst, const void* src, uint32_t size)
@@ -921,6 +2060,125 @@ void Hash::memcpy(void* dst, const void* src, uint32_t size)
 
 #pragma endregion
 
+#pragma region Hash implementation (streaming)
+
+// Two lanes of XXH64, so that every step reads 16 bytes with two independent multiply chains
+
+uint64_t Hash::Bytes64(const void* data, uint64_t size)
+{
+	return Bytes64(data, size, 0ULL);
+}
+uint64_t Hash::Bytes64(const void* data, uint64_t size, uint64_t seed)
+{
+	Stream64 stream(seed);
+	stream.Update(data, size);
+	return stream.Digest();
+}
+
+Hash::Stream64::Stream64(uint64_t seed)
+	: m_Lanes{ seed + Prime1 + Prime2, seed + Prime2 }, m_Seed(seed), m_Size(0ULL), m_Buffer{ 0 }
+{
+}
+
+void Hash::Stream64::Update(const void* data, uint64_t size)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint32_t buffered = uint32_t(m_Size & 15ULL);
+	m_Size += size;
+
+	// Complete the block left open by the previous calls first
+	if (buffered > 0U)
+	{
+		const uint32_t count = size < uint64_t(16U - buffered) ? uint32_t(size) : 16U - buffered;
+		memcpy(m_Buffer + buffered, bytes, count);
+		bytes += count;
+		size -= count;
+		if (buffered + count < 16U)
+			return;
+		Blocks(m_Buffer, 1ULL);
+	}
+
+	// Whole blocks are read straight from the input, and only the remainder is kept
+	Blocks(bytes, size >> 4);
+	memcpy(m_Buffer, bytes + (size & ~15ULL), uint32_t(size & 15ULL));
+}
+
+uint64_t Hash::Stream64::Digest() const
+{
+	uint64_t h;
+	if (m_Size >= 16ULL)
+	{
+		h = RotateLeft(m_Lanes[0], 1U) + RotateLeft(m_Lanes[1], 7U);
+		for (uint32_t i = 0U; i < 2U; i++)
+		{
+			h ^= Round(0ULL, m_Lanes[i]);
+			h = h * Prime1 + Prime4;
+		}
+	}
+	else
+		h = m_Seed + Prime5;
+
+	h += m_Size;
+
+	// The remaining bytes are mixed 8, then 4, then 1 at a time
+	const uint8_t* tail = m_Buffer;
+	uint32_t left = uint32_t(m_Size & 15ULL);
+	if (left >= 8U)
+	{
+		uint64_t word;
+		memcpy(&word, tail, 8U);
+		h ^= Round(0ULL, word);
+		h = RotateLeft(h, 27U) * Prime1 + Prime4;
+		tail += 8;
+		left -= 8U;
+	}
+	if (left >= 4U)
+	{
+		uint32_t word;
+		memcpy(&word, tail, 4U);
+		h ^= uint64_t(word) * Prime1;
+		h = RotateLeft(h, 23U) * Prime2 + Prime3;
+		tail += 4;
+		left -= 4U;
+	}
+	for (; left > 0U; left--)
+	{
+		h ^= uint64_t(*tail++) * Prime5;
+		h = RotateLeft(h, 11U) * Prime1;
+	}
+
+	// Final avalanche
+	h ^= h >> 33;
+	h *= Prime2;
+	h ^= h >> 29;
+	h *= Prime3;
+	h ^= h >> 32;
+	return h;
+}
+
+void Hash::Stream64::Blocks(const uint8_t* bytes, uint64_t count)
+{
+	// Local copies let the compiler keep both lanes in registers across the loop
+	uint64_t lane0 = m_Lanes[0];
+	uint64_t lane1 = m_Lanes[1];
+	for (; count > 0ULL; count--, bytes += 16)
+	{
+		uint64_t words[2];
+		memcpy(words, bytes, 16U);
+		lane0 = Round(lane0, words[0]);
+		lane1 = Round(lane1, words[1]);
+#if defined(__GNUC__)
+		// Keep the lanes in general registers, as GCC and Clang would otherwise pair them into one vector
+		// with a 64-bit vector multiply, which has several times the latency of the scalar one
+		__asm__("" : "+r"(lane0), "+r"(lane1));
+#endif
+	}
+	m_Lanes[0] = lane0;
+	m_Lanes[1] = lane1;
+}
+
+#pragma endregion
+
 #endif // RANDFS_IMPLEMENTATION
 
 #endif // RANDFS_NO_HASH
@@ -941,8 +2199,8 @@ VENDOR LICENSES:
 	The license can be found at https://github.com/google/cityhash/?tab=MIT-1-ov-file
 
 	The core PRNG implemented in the functions
-		Random::Random(uint64_t seed)
-		Random::UInt64()
+		MersenneTwister64::MersenneTwister64(uint64_t seed, Seeding seeding)
+		MersenneTwister64::Next()
 	is an implementation of Mersenne Twister by Takuji Nishimura and Makoto Matsumoto.
 	The license below was copied from the source:
 	
@@ -989,5 +2247,25 @@ VENDOR LICENSES:
 	Any feedback is very welcome.
 	http://www.math.hiroshima-u.ac.jp/~m-mat/MT/emt.html
 	email: m-mat@math.sci.hiroshima-u.ac.jp
+
+	The alternative PRNG implemented in the functions
+		Xoshiro256::Next()
+		Xoshiro256::Jump()
+	is an implementation of xoshiro256** by David Blackman and Sebastiano Vigna, which is in the public domain.
+	The reference implementation can be found at https://prng.di.unimi.it/xoshiro256starstar.c
+
+	The alternative PRNG implemented in the functions
+		Pcg64::Pcg64(uint64_t seed, uint64_t stream)
+		Pcg64::Next()
+		Pcg64::Advance(UInt128 delta)
+	is an implementation of PCG-XSL-RR 128/64 by Melissa O'Neill, which is under MIT or Apache 2.0 license, at your option.
+	The license can be found at https://github.com/imneme/pcg-cpp/blob/master/LICENSE-MIT.txt
+
+	The buffer hash implemented in the functions
+		Hash::Bytes64(const void* data, uint64_t size, uint64_t seed)
+		Hash::Stream64::Update(const void* data, uint64_t size)
+		Hash::Stream64::Digest()
+	is a two-lane variant of XXH64 by Yann Collet, which is under BSD 2-Clause license.
+	The license can be found at https://github.com/Cyan4973/xxHash/blob/dev/LICENSE
 */
 
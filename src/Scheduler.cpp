@@ -0,0 +1,256 @@
+#include "Scheduler.h"
+
+#include <chrono>
+#include <algorithm>
+
+#pragma region Tile order
+
+const char* GetTileOrderName(TileOrder order)
+{
+	switch (order)
+	{
+		case TileOrder::Rows:    return "rows";
+		case TileOrder::Morton:  return "morton";
+		case TileOrder::Hilbert: return "hilbert";
+		default:                 return "unknown";
+	}
+}
+
+// Interleave the bits of x and y, with x in the even bits
+static uint64_t MortonKey(uint32_t x, uint32_t y)
+{
+	uint64_t key = 0ULL;
+	for (int bit = 0; bit < 32; bit++)
+	{
+		key |= uint64_t((x >> bit) & 1U) << (2 * bit);
+		key |= uint64_t((y >> bit) & 1U) << (2 * bit + 1);
+	}
+	return key;
+}
+
+// Distance of (x, y) along the Hilbert curve that fills an n by n square, n being a power of 2
+static uint64_t HilbertKey(uint32_t n, uint32_t x, uint32_t y)
+{
+	uint64_t key = 0ULL;
+	for (uint32_t s = n / 2U; s > 0U; s /= 2U)
+	{
+		const uint32_t rx = (x & s) ? 1U : 0U;
+		const uint32_t ry = (y & s) ? 1U : 0U;
+		key += uint64_t(s) * uint64_t(s) * uint64_t((3U * rx) ^ ry);
+
+		// Rotate the quadrant so the curve continues from where the previous one ended
+		if (ry == 0U)
+		{
+			if (rx == 1U)
+			{
+				x = s - 1U - (x & (s - 1U));
+				y = s - 1U - (y & (s - 1U));
+			}
+			std::swap(x, y);
+		}
+	}
+	return key;
+}
+
+std::vector<uint32_t> BuildTileOrder(int tilesX, int tilesY, TileOrder order)
+{
+	std::vector<uint32_t> tiles(size_t(tilesX) * size_t(tilesY));
+	for (size_t i = 0; i < tiles.size(); i++)
+		tiles[i] = uint32_t(i);
+
+	if (order == TileOrder::Rows)
+		return tiles;
+
+	// The curves are defined on a power of 2 square, and tiles outside the frame are skipped
+	uint32_t n = 1U;
+	while (n < uint32_t(tilesX) || n < uint32_t(tilesY))
+		n *= 2U;
+
+	std::vector<uint64_t> keys(tiles.size());
+	for (size_t i = 0; i < tiles.size(); i++)
+	{
+		const uint32_t x = uint32_t(i % size_t(tilesX));
+		const uint32_t y = uint32_t(i / size_t(tilesX));
+		keys[i] = order == TileOrder::Morton ? MortonKey(x, y) : HilbertKey(n, x, y);
+	}
+
+	std::sort(tiles.begin(), tiles.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+	return tiles;
+}
+
+#pragma endregion
+
+#pragma region Thread pool
+
+static uint64_t MakeRange(uint32_t begin, uint32_t end)
+{
+	return uint64_t(begin) | (uint64_t(end) << 32);
+}
+
+ThreadPool::ThreadPool(int threadCount)
+{
+	if (threadCount <= 0)
+		threadCount = int(std::thread::hardware_concurrency());
+	if (threadCount <= 0)
+		threadCount = 1;
+
+	m_Workers = std::vector<Worker>(size_t(threadCount));
+	m_Stats.resize(size_t(threadCount));
+
+	for (int t = 1; t < threadCount; t++)
+		m_Threads.emplace_back(&ThreadPool::ThreadMain, this, t);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_Wake.notify_all();
+
+	for (std::thread& thread : m_Threads)
+		thread.join();
+}
+
+void ThreadPool::Run(uint32_t taskCount, const std::function<void(uint32_t task, int thread)>& task)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	const uint32_t threadCount = uint32_t(m_Workers.size());
+	for (uint32_t t = 0U; t < threadCount; t++)
+	{
+		const uint32_t begin = uint32_t(uint64_t(taskCount) * t / threadCount);
+		const uint32_t end = uint32_t(uint64_t(taskCount) * (t + 1U) / threadCount);
+		m_Workers[t].range.store(MakeRange(begin, end));
+		m_Stats[t] = ThreadStats();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Task = &task;
+		m_Running = int(m_Threads.size());
+		m_Generation++;
+	}
+	m_Wake.notify_all();
+
+	Work(0);
+
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Done.wait(lock, [&]() { return m_Running == 0; });
+		m_Task = nullptr;
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	m_LastRunMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double ThreadPool::Utilization(int thread) const
+{
+	return m_LastRunMilliseconds > 0.0 ? m_Stats[thread].busyMilliseconds / m_LastRunMilliseconds : 0.0;
+}
+
+void ThreadPool::ThreadMain(int thread)
+{
+	uint64_t generation = 0ULL;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Wake.wait(lock, [&]() { return m_Stop || m_Generation != generation; });
+			if (m_Stop)
+				return;
+			generation = m_Generation;
+		}
+
+		Work(thread);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (--m_Running == 0)
+				m_Done.notify_all();
+		}
+	}
+}
+
+void ThreadPool::Work(int thread)
+{
+	ThreadStats& stats = m_Stats[thread];
+	uint32_t task;
+
+	for (;;)
+	{
+		const bool own = Pop(thread, task);
+		if (!own && !Steal(thread, task))
+			break;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		(*m_Task)(task, thread);
+		auto end = std::chrono::high_resolution_clock::now();
+
+		stats.busyMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+		stats.tasks++;
+		if (!own)
+			stats.stolenTasks++;
+	}
+}
+
+// Take the first task of the thread's own share
+bool ThreadPool::Pop(int thread, uint32_t& task)
+{
+	std::atomic<uint64_t>& range = m_Workers[thread].range;
+	uint64_t current = range.load();
+	for (;;)
+	{
+		const uint32_t begin = uint32_t(current);
+		const uint32_t end = uint32_t(current >> 32);
+		if (begin >= end)
+			return false;
+
+		if (range.compare_exchange_weak(current, MakeRange(begin + 1U, end)))
+		{
+			task = begin;
+			return true;
+		}
+	}
+}
+
+// Take the second half of the largest remaining share of another thread, run its first task now and keep the rest
+bool ThreadPool::Steal(int thread, uint32_t& task)
+{
+	for (;;)
+	{
+		int victim = -1;
+		uint64_t victimRange = 0ULL;
+		uint32_t largest = 0U;
+		for (int t = 0; t < int(m_Workers.size()); t++)
+		{
+			const uint64_t current = m_Workers[t].range.load();
+			const uint32_t begin = uint32_t(current);
+			const uint32_t end = uint32_t(current >> 32);
+			if (t != thread && end > begin && end - begin > largest)
+			{
+				victim = t;
+				victimRange = current;
+				largest = end - begin;
+			}
+		}
+
+		if (victim < 0)
+			return false;
+
+		// The owner may have taken more tasks in the meantime, in which case the largest share is looked for again
+		const uint32_t begin = uint32_t(victimRange);
+		const uint32_t end = uint32_t(victimRange >> 32);
+		const uint32_t split = end - (end - begin + 1U) / 2U;
+		if (m_Workers[victim].range.compare_exchange_strong(victimRange, MakeRange(begin, split)))
+		{
+			task = split;
+			m_Workers[thread].range.store(MakeRange(split + 1U, end));
+			return true;
+		}
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+// Order in which the tiles of a frame are handed out
+enum class TileOrder : uint8_t
+{
+	Rows, // Left to right, then top to bottom
+	Morton, // Z-order curve
+	Hilbert // Hilbert curve, where consecutive tiles are always adjacent
+};
+
+const char* GetTileOrderName(TileOrder order);
+
+// How CpuRenderer splits a frame into tasks
+// Neighboring pixels tend to have similar costs, so tiles that are close together in the order are given to the same thread
+struct TileSettings
+{
+	int width = 64; // Multiples of the block size (64) avoid evaluating pixels past the right edge of each tile
+	int height = 16;
+	TileOrder order = TileOrder::Hilbert;
+};
+
+// Get the tiles of a tilesX by tilesY grid in the given order, as indices ty * tilesX + tx
+std::vector<uint32_t> BuildTileOrder(int tilesX, int tilesY, TileOrder order);
+
+// Time spent by one thread of the pool during the last call to ThreadPool::Run
+struct ThreadStats
+{
+	double busyMilliseconds = 0.0; // Time spent running tasks
+	uint32_t tasks = 0U;
+	uint32_t stolenTasks = 0U; // Tasks taken from another thread after running out of its own
+};
+
+// Persistent worker threads that run batches of tasks with work stealing
+// Each thread starts with a contiguous share of the tasks and runs it in order, and threads that run out take the second half
+// of the largest remaining share, so consecutive tasks mostly run on the same thread while every thread stays busy
+class ThreadPool
+{
+public:
+	// A thread count of 0 uses all available hardware threads
+	// The calling thread of Run is one of the workers, so only threadCount - 1 threads are created
+	explicit ThreadPool(int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Run task(index, thread) for every index in [0, taskCount), and return when all are done
+	// 'thread' is in [0, ThreadCount()), and tasks running on the same thread never overlap
+	// Must not be called from several threads at once
+	void Run(uint32_t taskCount, const std::function<void(uint32_t task, int thread)>& task);
+
+	int ThreadCount() const { return int(m_Workers.size()); }
+
+	// Statistics of the last call to Run, one per thread
+	const std::vector<ThreadStats>& GetStats() const { return m_Stats; }
+	double LastRunMilliseconds() const { return m_LastRunMilliseconds; }
+	// Fraction of the last run that the given thread spent running tasks
+	double Utilization(int thread) const;
+
+private:
+	struct alignas(64) Worker
+	{
+		// Remaining share of the tasks, with the first index in the low 32 bits and the end in the high 32 bits
+		std::atomic<uint64_t> range = 0ULL;
+	};
+
+	std::vector<Worker> m_Workers;
+	std::vector<std::thread> m_Threads;
+	std::vector<ThreadStats> m_Stats;
+	double m_LastRunMilliseconds = 0.0;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::condition_variable m_Done;
+	uint64_t m_Generation = 0ULL;
+	int m_Running = 0;
+	bool m_Stop = false;
+	const std::function<void(uint32_t, int)>* m_Task = nullptr;
+
+	void ThreadMain(int thread);
+	void Work(int thread);
+	bool Pop(int thread, uint32_t& task);
+	bool Steal(int thread, uint32_t& task);
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <condition_variable>
+
+// Prepares the upcoming seeds on background threads, such as generating and compiling their shaders, so that moving on
+// to the next seed only takes a result that is already done instead of stalling the thread that renders
+// Seeds are consecutive, starting at the first one, and at most 'depth' of them are prepared ahead of the one taken last
+template <typename T>
+class SeedPipeline
+{
+public:
+	static constexpr uint64_t Unlimited = ~0ULL;
+
+	// Prepare 'seedCount' seeds (or Unlimited), calling 'prepare' on the worker threads, possibly for several seeds at once
+	SeedPipeline(uint64_t firstSeed, uint64_t seedCount, int depth, int threadCount, std::function<T(uint64_t seed)> prepare)
+		: m_Prepare(std::move(prepare)), m_NextSeed(firstSeed), m_RemainingSeeds(seedCount)
+	{
+		for (int i = 0; i < (depth > 0 ? depth : 1); i++)
+			AddSlot();
+
+		for (int t = 0; t < (threadCount > 0 ? threadCount : 1); t++)
+			m_Threads.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	~SeedPipeline()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_WorkAvailable.notify_all();
+
+		for (std::thread& thread : m_Threads)
+			thread.join();
+	}
+
+	SeedPipeline(const SeedPipeline&) = delete;
+	SeedPipeline& operator=(const SeedPipeline&) = delete;
+
+	// Take the result for the next seed, waiting for it if it is not ready yet, and start preparing one more seed
+	// Must not be called more than 'seedCount' times
+	T Next(uint64_t& seed)
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_ResultReady.wait(lock, [this]() { return m_Slots.front().result.has_value(); });
+
+		seed = m_Slots.front().seed;
+		T result = std::move(*m_Slots.front().result);
+		m_Slots.pop_front();
+		AddSlot();
+
+		lock.unlock();
+		m_WorkAvailable.notify_one();
+		return result;
+	}
+
+	// Whether Next would return without waiting
+	bool IsNextReady() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return !m_Slots.empty() && m_Slots.front().result.has_value();
+	}
+
+	// Seeds whose result is ready, out of the ones being prepared
+	int ReadyCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		int count = 0;
+		for (const Slot& slot : m_Slots)
+			count += slot.result.has_value() ? 1 : 0;
+		return count;
+	}
+
+private:
+	struct Slot
+	{
+		uint64_t seed = 0ULL;
+		bool started = false;
+		std::optional<T> result;
+	};
+
+	std::function<T(uint64_t seed)> m_Prepare;
+	uint64_t m_NextSeed;
+	uint64_t m_RemainingSeeds;
+	std::deque<Slot> m_Slots; // Seeds being prepared, in the order they are taken
+
+	std::vector<std::thread> m_Threads;
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	std::condition_variable m_ResultReady;
+	bool m_Stop = false;
+
+	void AddSlot()
+	{
+		if (m_RemainingSeeds == 0ULL)
+			return;
+		if (m_RemainingSeeds != Unlimited)
+			m_RemainingSeeds--;
+
+		Slot slot;
+		slot.seed = m_NextSeed++;
+		m_Slots.push_back(std::move(slot));
+	}
+
+	void WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		while (true)
+		{
+			// The earliest seed first, since it is the one needed soonest
+			Slot* slot = nullptr;
+			m_WorkAvailable.wait(lock, [&]()
+			{
+				for (Slot& candidate : m_Slots)
+				{
+					if (!candidate.started)
+					{
+						slot = &candidate;
+						return true;
+					}
+				}
+				return m_Stop;
+			});
+
+			if (m_Stop)
+				return;
+
+			slot->started = true;
+			const uint64_t seed = slot->seed;
+			lock.unlock();
+			T result = m_Prepare(seed);
+			lock.lock();
+
+			// Slots are only removed once their result is taken, so the slot of this seed is still there
+			for (Slot& candidate : m_Slots)
+			{
+				if (candidate.seed == seed && candidate.started && !candidate.result)
+				{
+					candidate.result.emplace(std::move(result));
+					break;
+				}
+			}
+			m_ResultReady.notify_all();
+		}
+	}
+};
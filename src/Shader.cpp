@@ -1,15 +1,64 @@
 #include "Shader.h"
 
 #include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
 
 #define RANDFS_IMPLEMENTATION
 #include "RandFS.h"
 
+#include "Program.h"
+
 // Comment the line below to generate static images
 #define ANIMATE
 
-std::string GenerateShaderCode(uint64_t seed)
+// Parse each entry of a template table into its own expression
+static std::vector<Expression> ParseTemplates(const char* const* sources, int count)
 {
+	std::vector<Expression> templates;
+	templates.reserve(count);
+	for (int i = 0; i < count; i++)
+		templates.push_back(ParseTemplate(sources[i]));
+	return templates;
+}
+
+// Replace '#' tokens with random constants, in the same order they appear in the source text
+static void AssignConstants(Expression& expression, uint32_t index, Random& rand)
+{
+	Node& node = expression.nodes[index];
+
+	// The color channels come before the mask in the source text, so they are visited separately
+	if (node.op == Op::Rgb)
+		return;
+
+	if (node.op == Op::Const)
+	{
+		// Round the constant the same way it is written into the shader source
+		node.value = std::strtof(std::to_string(rand.FloatO()).c_str(), nullptr);
+		return;
+	}
+
+	for (int a = 0; a < GetOpInfo(node.op).arity; a++)
+		AssignConstants(expression, node.args[a], rand);
+}
+
+// Nanoseconds since the given time, which is then moved to now, to time consecutive phases
+static double LapNanoseconds(std::chrono::high_resolution_clock::time_point& since)
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+	const double nanoseconds = std::chrono::duration<double, std::nano>(now - since).count();
+	since = now;
+	return nanoseconds;
+}
+
+// Generate the expression of a seed without any limit on its cost
+// A forced depth replaces the one drawn from the seed, after drawing it so that the rest of the generation is unchanged
+// Each phase is timed if a profile is given
+static Expression GenerateTree(uint64_t seed, int forcedDepth = 0, GenerationProfile* profile = nullptr)
+{
+	auto lap = std::chrono::high_resolution_clock::now();
 
 	seed = Hash::UInt64(seed);
 
@@ -25,11 +74,178 @@ std::string GenerateShaderCode(uint64_t seed)
 	// This generates very interesting images, but some computers can't handle it
 	// Uncomment at your own risk
 	//maxDepth = 12;
+	if (forcedDepth > 0)
+		maxDepth = forcedDepth;
 
-	#pragma region Function definitions
+	static const char* values[] =
+	{
+		"uv.x", // Normalized x coordinate
+		"uv.y", // Normalized y coordinate
+		"invX", // 1.0f - uv.x
+		"invY", // 1.0f - uv.y
+#ifdef ANIMATE
+		"sinTime", // sin(time)
+		"cosTime", // cos(time)
+#endif
+		"#", // Random constant
+		"#" // Double the chance
+	};
+	const int valuesSize = sizeof(values) / sizeof(const char*);
+	static const std::vector<Expression> valueTemplates = ParseTemplates(values, valuesSize);
+	
+	static const char* functions[] =
+	{
+		"fInv(@)",
+		"fSqr(@)",
+		"fSqrt(@)",
+		"fSmooth(@)",
+		"fSharp(@)",
+		"fAdd(@, @)",
+		"fSub(@, @)",
+		"fMul(@, @)",
+		"fInv(fMul(@, @))", // Compensate for bias
+		"fDiv(@, @)",
+		"fAvg(@, @)",
+		"fGeom(@, @)",
+		"fHarm(@, @)",
+		"fHypo(@, @)",
+		"fMin(@, @)",
+		"fMax(@, @)",
+		"fPow(@, @)",
+		"fBell(@, @)",
+		"fInv(fBell(@, @))", // Compensate for bias
+		"fWave(@, @)",
+		"fWave(@, @)", // Double the chance
+		"fWaveDamp(@, @)",
+		"fInv(fWaveDamp(@, @))",
+		"fLerp(@, @, @)",
+		"fSmoothLerp(@, @, @)",
+		"fMlerp(@, @, @)",
+//		"fClamp(@, @, @)", // This generates ugly discontinuities
+		"fDist(@, @, @, @)", // Compare variables to variables
+		"fDist(@, @, #, #)", // Compare variables to fixed point
+		"fDist(uv.x, uv.y, @, @)", // Compare pixel coords to variables
+		"fDist(uv.x, uv.y, #, #)", // Compare pixel coords to fixed point
+		"fInv(fDist(@, @, @, @))", // Compensate for bias
+		"fInv(fDist(@, @, #, #))", // Compensate for bias
+		"fInv(fDist(uv.x, uv.y, @, @))", // Compensate for bias
+		"fInv(fDist(uv.x, uv.y, #, #))", // Compensate for bias
+		"fDistLine(@, @, @, @)", // Compare variables to variables
+		"fDistLine(@, @, #, #)", // Compare variables to fixed line
+		"fDistLine(uv.x, uv.y, @, @)", // Compare pixel coords to variable line
+		"fDistLine(uv.x, uv.y, #, #)", // Compare pixel coords to fixed line
+		"fInv(fDistLine(@, @, @, @))", // Compensate for bias
+		"fInv(fDistLine(@, @, #, #))", // Compensate for bias
+		"fInv(fDistLine(uv.x, uv.y, @, @))", // Compensate for bias
+		"fInv(fDistLine(uv.x, uv.y, #, #))" // Compensate for bias
+	};
+	const int functionsSize = sizeof(functions) / sizeof(const char*);
+	static const std::vector<Expression> functionTemplates = ParseTemplates(functions, functionsSize);
 
-	static constexpr char functionDefinitions[] =
-	R"(
+	static const char* masks[] =
+	{
+		"rgb",
+		"rgb", // Repeat to increase the chance of no mask
+		"rgb", // Repeat to increase the chance of no mask
+		"fAdd3(rgb, @)",
+		"fSub3(rgb, @)",
+		"fAdd3(fSub3(rgb, @), @)",
+		"fSub3(fAdd3(rgb, @), @)",
+		"fInv3(fAdd3(rgb, @))",
+		"fInv3(fSub3(rgb, @))",
+		"fInv3(fAdd3(fSub3(rgb, @), @))",
+		"fInv3(fSub3(fAdd3(rgb, @), @))"
+	};
+	const int masksSize = sizeof(masks) / sizeof(const char*);
+	static const std::vector<Expression> maskTemplates = ParseTemplates(masks, masksSize);
+
+	Expression expression;
+	expression.seed = seed;
+	expression.maxDepth = maxDepth;
+
+	// The root starts as a single token, which is replaced by one of the masks selected randomly
+	std::vector<uint32_t> holes;
+	std::vector<uint32_t> maskHoles;
+	expression.root = expression.AddNode(Node());
+	const Expression& mask = rand.Element(maskTemplates.data(), masksSize);
+	expression.Instantiate(mask, expression.root, maskHoles);
+
+	// The three color channels come before the mask tokens in the source text
+	const uint32_t rgb = expression.RgbNode();
+	for (int c = 0; c < 3; c++)
+	{
+		uint32_t hole = expression.AddNode(Node());
+		expression.nodes[rgb].args[c] = hole;
+		holes.push_back(hole);
+	}
+	holes.insert(holes.end(), maskHoles.begin(), maskHoles.end());
+
+	if (profile)
+		profile->maskNanoseconds += LapNanoseconds(lap);
+
+	// Run until maxDepth because at maxDepth all tokens must be replaced by constants
+	// Each iteration expands every token created by the previous one, in the order they appear in the source text
+	std::vector<uint32_t> nextHoles;
+	for (int i = 0; i <= maxDepth; i++)
+	{
+		nextHoles.clear();
+		for (uint32_t hole : holes)
+		{
+			// Decide whether to replace the token with a function or a fixed value
+			// At depth 0, it is guaranteed to use a function, and at MAX_DEPTH it is guaranteed to use a fixed value
+			// The progression is quadratic, which makes it more likely to choose functions over values than if the chance progressed linearly
+			const Expression& replacement = rand.IntBetween(1, maxDepth * maxDepth) > i * i
+				? rand.Element(functionTemplates.data(), functionsSize)
+				: rand.Element(valueTemplates.data(), valuesSize);
+
+			expression.Instantiate(replacement, hole, nextHoles);
+		}
+		holes.swap(nextHoles);
+	}
+
+	if (profile)
+		profile->expansionNanoseconds += LapNanoseconds(lap);
+
+	// Replace '#' tokens with random constants
+	for (int c = 0; c < 3; c++)
+		AssignConstants(expression, expression.nodes[rgb].args[c], rand);
+	AssignConstants(expression, expression.root, rand);
+
+	if (profile)
+		profile->constantNanoseconds += LapNanoseconds(lap);
+
+	return expression;
+}
+
+Expression GenerateExpression(uint64_t seed, float maxCost)
+{
+	Expression expression = GenerateTree(seed);
+	if (maxCost <= 0.0f)
+		return expression;
+
+	// Expressions over the budget are replaced by those of seeds derived from this one, always tried in the same order,
+	// so that a seed and a budget always give the same image, and seeds already within the budget do not change
+	float cost = EstimateCost(BuildProgram(expression));
+	for (uint64_t attempt = 1ULL; cost > maxCost && attempt < MaxCostAttempts; attempt++)
+	{
+		Expression candidate = GenerateTree(Hash::UInt64(seed, attempt));
+		const float candidateCost = EstimateCost(BuildProgram(candidate));
+		if (candidateCost < cost)
+		{
+			expression = std::move(candidate);
+			cost = candidateCost;
+		}
+	}
+
+	return expression;
+}
+
+#pragma region Function definitions
+
+// Primitive functions shared by every generated shader
+// They are written in the subset of HLSL that also compiles as C++, given a few helper definitions (see Jit.cpp)
+static constexpr char functionDefinitions[] =
+R"(
 	
 	// 1 input
 	
@@ -262,12 +478,18 @@ std::string GenerateShaderCode(uint64_t seed)
 
 	)";
 
-	#pragma endregion
+#pragma endregion
+
+const char* GetFunctionDefinitions()
+{
+	return functionDefinitions;
+}
 
-	#pragma region Main function
+#pragma region Main functions
 
-	std::string mainFunction =
-	R"(
+// Evaluates the whole expression
+static constexpr char mainFunction[] =
+R"(
 
 	cbuffer ConstantBuffer
 	{
@@ -280,8 +502,8 @@ std::string GenerateShaderCode(uint64_t seed)
 		float invY = 1.0f - uv.y;
 		float sinTime = buf.x;
 		float cosTime = buf.y;
-
-		float3 rgb = float3(@, @, @);
+@LOCALS@
+		float3 rgb = float3(@RGB@);
 		rgb = @MASK@;
 
 		return float4(rgb, 1.0f);
@@ -289,131 +511,223 @@ std::string GenerateShaderCode(uint64_t seed)
 	
 	)";
 
-	#pragma endregion
+// Evaluates the values that do not depend on time, and writes them to the cache textures
+static constexpr char cacheFunction[] =
+R"(
 
-	static const char* values[] =
+	struct CacheOutput
 	{
-		"uv.x", // Normalized x coordinate
-		"uv.y", // Normalized y coordinate
-		"invX", // 1.0f - uv.x
-		"invY", // 1.0f - uv.y
-#ifdef ANIMATE
-		"sinTime", // sin(time)
-		"cosTime", // cos(time)
-#endif
-		"#", // Random constant
-		"#" // Double the chance
+@TARGETS@
 	};
-	const int valuesSize = sizeof(values) / sizeof(const char*);
+
+	CacheOutput main(float2 uv : TEXCOORD)
+	{
+		float invX = 1.0f - uv.x;
+		float invY = 1.0f - uv.y;
+@LOCALS@
+		CacheOutput o;
+@OUTPUTS@
+		return o;
+	}
 	
-	static const char* functions[] =
+	)";
+
+// Evaluates the part of the expression that depends on time, reading everything else from the cache textures
+// The cache is drawn with the same viewport, so the position of each pixel is also its position in the cache
+static constexpr char frameFunction[] =
+R"(
+
+	cbuffer ConstantBuffer
 	{
-		"fInv(@)",
-		"fSqr(@)",
-		"fSqrt(@)",
-		"fSmooth(@)",
-		"fSharp(@)",
-		"fAdd(@, @)",
-		"fSub(@, @)",
-		"fMul(@, @)",
-		"fInv(fMul(@, @))", // Compensate for bias
-		"fDiv(@, @)",
-		"fAvg(@, @)",
-		"fGeom(@, @)",
-		"fHarm(@, @)",
-		"fHypo(@, @)",
-		"fMin(@, @)",
-		"fMax(@, @)",
-		"fPow(@, @)",
-		"fBell(@, @)",
-		"fInv(fBell(@, @))", // Compensate for bias
-		"fWave(@, @)",
-		"fWave(@, @)", // Double the chance
-		"fWaveDamp(@, @)",
-		"fInv(fWaveDamp(@, @))",
-		"fLerp(@, @, @)",
-		"fSmoothLerp(@, @, @)",
-		"fMlerp(@, @, @)",
-//		"fClamp(@, @, @)", // This generates ugly discontinuities
-		"fDist(@, @, @, @)", // Compare variables to variables
-		"fDist(@, @, #, #)", // Compare variables to fixed point
-		"fDist(uv.x, uv.y, @, @)", // Compare pixel coords to variables
-		"fDist(uv.x, uv.y, #, #)", // Compare pixel coords to fixed point
-		"fInv(fDist(@, @, @, @))", // Compensate for bias
-		"fInv(fDist(@, @, #, #))", // Compensate for bias
-		"fInv(fDist(uv.x, uv.y, @, @))", // Compensate for bias
-		"fInv(fDist(uv.x, uv.y, #, #))", // Compensate for bias
-		"fDistLine(@, @, @, @)", // Compare variables to variables
-		"fDistLine(@, @, #, #)", // Compare variables to fixed line
-		"fDistLine(uv.x, uv.y, @, @)", // Compare pixel coords to variable line
-		"fDistLine(uv.x, uv.y, #, #)", // Compare pixel coords to fixed line
-		"fInv(fDistLine(@, @, @, @))", // Compensate for bias
-		"fInv(fDistLine(@, @, #, #))", // Compensate for bias
-		"fInv(fDistLine(uv.x, uv.y, @, @))", // Compensate for bias
-		"fInv(fDistLine(uv.x, uv.y, #, #))" // Compensate for bias
+		float4 buf;
 	};
-	const int functionsSize = sizeof(functions) / sizeof(const char*);
 
-	static const char* masks[] =
+@TEXTURES@
+	float4 main(float2 uv : TEXCOORD, float4 pos : SV_POSITION) : SV_TARGET
 	{
-		"rgb",
-		"rgb", // Repeat to increase the chance of no mask
-		"rgb", // Repeat to increase the chance of no mask
-		"fAdd3(rgb, @)",
-		"fSub3(rgb, @)",
-		"fAdd3(fSub3(rgb, @), @)",
-		"fSub3(fAdd3(rgb, @), @)",
-		"fInv3(fAdd3(rgb, @))",
-		"fInv3(fSub3(rgb, @))",
-		"fInv3(fAdd3(fSub3(rgb, @), @))",
-		"fInv3(fSub3(fAdd3(rgb, @), @))"
-	};
-	const int masksSize = sizeof(masks) / sizeof(const char*);
+		float invX = 1.0f - uv.x;
+		float invY = 1.0f - uv.y;
+		float sinTime = buf.x;
+		float cosTime = buf.y;
+@LOADS@
+@LOCALS@
+		float3 rgb = float3(@RGB@);
+		rgb = @MASK@;
 
-	// Replace mask token for one of the masks selected randomly
-	std::string maskToken("@MASK@");
-	size_t maskPos = mainFunction.find(maskToken);
-	const char* mask = rand.Element(masks, masksSize);
-	mainFunction.replace(maskPos, maskToken.length(), mask);
+		return float4(rgb, 1.0f);
+	}
+	
+	)";
 
-	// Run until maxDepth because at maxDepth all tokens must be replaced by constants
-	for (int i = 0; i <= maxDepth; i++)
-	{
-		// Find all '@' tokens and replace for '$' tokens
-		// This marks all tokens for replacement in this iteration
-		for (char& c : mainFunction)
+#pragma endregion
+
+// Replace the first occurrence of 'token' in 'text'
+static void ReplaceToken(std::string& text, const char* token, const std::string& value)
+{
+	text.replace(text.find(token), std::char_traits<char>::length(token), value);
+}
+
+// Write the shared values, the mask and the three color channels into a main function
+static std::string WriteMainFunction(const char* function, const ProgramSource& source)
+{
+	std::string main = function;
+	ReplaceToken(main, "@MASK@", source.mask);
+	ReplaceToken(main, "@RGB@", source.channels);
+	ReplaceToken(main, "@LOCALS@", source.locals);
+	return main;
+}
+
+std::string GenerateShaderCode(uint64_t seed, float maxCost)
+{
+	Expression expression = GenerateExpression(seed, maxCost);
+	const Program program = BuildProgram(expression);
+
+	const std::string main = WriteMainFunction(mainFunction, GenerateProgramSource(program, "\t\t"));
+
+//	std::cout << main << std::endl;
+	std::cout << "Shader seed: " << expression.seed << " (cost " << int(EstimateCost(program) + 0.5f) << ")" << std::endl;
+
+	return functionDefinitions + main;
+}
+
+std::string GenerateShaderCodeProfiled(uint64_t seed, int maxDepth, GenerationProfile& profile, Expression* expression)
+{
+	Expression generated = GenerateTree(seed, maxDepth, &profile);
+
+	auto lap = std::chrono::high_resolution_clock::now();
+	const Program program = BuildProgram(generated);
+	profile.programNanoseconds += LapNanoseconds(lap);
+
+	const std::string code = functionDefinitions + WriteMainFunction(mainFunction, GenerateProgramSource(program, "\t\t"));
+	profile.sourceNanoseconds += LapNanoseconds(lap);
+
+	if (expression)
+		*expression = std::move(generated);
+	return code;
+}
+
+SplitShaderCode GenerateSplitShaderCode(uint64_t seed, float maxCost)
+{
+	Expression expression = GenerateExpression(seed, maxCost);
+	const Program program = BuildProgram(expression);
+	const std::vector<uint8_t> inputs = FindInputs(program);
+
+	SplitShaderCode code;
+	code.seed = expression.seed;
+	code.cost = EstimateCost(program);
+	code.programHash = HashProgram(program);
+
+	// The image only changes over time if a channel or a mask does
+	uint8_t colorInputs = inputs[program.channels[0]] | inputs[program.channels[1]] | inputs[program.channels[2]];
+	for (const MaskStep& step : program.mask)
+		if (step.op != Op::Inv3)
+			colorInputs |= inputs[step.arg];
+	code.animated = (colorInputs & InputTime) != 0;
+
+	if (!code.animated)
+	{
+		code.cache = functionDefinitions + WriteMainFunction(mainFunction, GenerateProgramSource(program, "\t\t"));
+		code.cacheTargets = 1;
+		return code;
+	}
+
+	// Cache the values that do not depend on time but are used by the animated part, or directly by the color
+	// Values without inputs are cheaper to compute again than to read, and values beyond what fits in the targets are computed every frame
+	const uint32_t size = uint32_t(program.code.size());
+	std::vector<uint8_t> boundary(size);
+	for (uint32_t i = 0U; i < size; i++)
+		if (inputs[i] & InputTime)
+			for (int a = 0; a < GetOpInfo(program.code[i].op).arity; a++)
+				boundary[program.code[i].args[a]] = 1;
+	for (int c = 0; c < 3; c++)
+		boundary[program.channels[c]] = 1;
+	for (const MaskStep& step : program.mask)
+		if (step.op != Op::Inv3)
+			boundary[step.arg] = 1;
+
+	std::vector<uint32_t> cached;
+	for (uint32_t i = 0U; i < size; i++)
+		if (boundary[i] && (inputs[i] & (InputX | InputY)) && !(inputs[i] & InputTime) && GetOpInfo(program.code[i].op).arity > 0)
+			cached.push_back(i);
+
+	if (cached.size() > 4 * MaxCacheTargets)
+	{
+		// Keep the values with the largest subtrees, which save the most work per frame
+		std::vector<uint32_t> nodeCounts(size);
+		for (uint32_t i = 0U; i < size; i++)
 		{
-			if (c == '@')
-				c = '$';
+			const Instruction& in = program.code[i];
+			nodeCounts[i] = 1U;
+			for (int a = 0; a < GetOpInfo(in.op).arity; a++)
+				nodeCounts[i] += nodeCounts[in.args[a]];
 		}
 
-		// Replace all '$' tokens for either a function or a value
-		size_t pos = mainFunction.find('$');
-		while (pos != std::string::npos)
-		{
-			// Decide whether to replace the token with a function or a fixed value
-			// At depth 0, it is guaranteed to use a function, and at MAX_DEPTH it is guaranteed to use a fixed value
-			// The progression is quadratic, which makes it more likely to choose functions over values than if the chance progressed linearly
-			std::string replacement = rand.IntBetween(1, maxDepth * maxDepth) > i * i
-				? rand.Element(functions, functionsSize)
-				: rand.Element(values, valuesSize);
+		std::stable_sort(cached.begin(), cached.end(), [&](uint32_t a, uint32_t b) { return nodeCounts[a] > nodeCounts[b]; });
+		cached.resize(4 * MaxCacheTargets);
+		std::sort(cached.begin(), cached.end());
+	}
 
-			mainFunction.replace(pos, 1, replacement);
-			pos = mainFunction.find('$');
-		}
+	// Each cached value is a component of one of the targets, in order
+	static const char components[] = "xyzw";
+	std::vector<std::string> names(cached.empty() ? 0 : size);
+	for (size_t v = 0; v < cached.size(); v++)
+	{
+		std::string& name = names[cached[v]];
+		name = 'c' + std::to_string(v / 4);
+		name += '.';
+		name += components[v % 4];
 	}
 
-	// Replace '#' tokens with random constants
-	size_t pos = mainFunction.find('#');
-	while (pos != std::string::npos)
+	code.cacheTargets = int((cached.size() + 3) / 4);
+
+	std::string textures, loads;
+	for (int t = 0; t < code.cacheTargets; t++)
+	{
+		const std::string index = std::to_string(t);
+		textures += "\tTexture2D<float4> cache" + index + " : register(t" + index + ");\n";
+		loads += "\t\tfloat4 c" + index + " = cache" + index + ".Load(int3(pos.xy, 0));\n";
+	}
+
+	if (!loads.empty())
+		loads.pop_back();
+
+	std::string frame = WriteMainFunction(frameFunction, GenerateProgramSource(program, "\t\t", names));
+	ReplaceToken(frame, "@TEXTURES@", textures);
+	ReplaceToken(frame, "@LOADS@", loads);
+	code.frame = functionDefinitions + frame;
+
+	if (cached.empty())
+		return code;
+
+	const RegisterSource values = GenerateRegisterSource(program, cached, "\t\t");
+
+	std::string targets, outputs;
+	for (int t = 0; t < code.cacheTargets; t++)
 	{
-		mainFunction.replace(pos, 1, std::to_string(rand.FloatO()) + 'f');
-		pos = mainFunction.find('#');
+		const std::string index = std::to_string(t);
+		targets += "\t\tfloat4 c" + index + " : SV_TARGET" + index + ";\n";
+
+		outputs += "\t\to.c" + index + " = float4(";
+		for (size_t v = 4 * size_t(t); v < 4 * size_t(t) + 4; v++)
+		{
+			outputs += v < cached.size() ? values.values[v] : "0.0f";
+			outputs += v % 4 < 3 ? ", " : ");\n";
+		}
 	}
 
-//	std::cout << mainFunction << std::endl;
-	std::cout << "Shader seed: " << seed << std::endl;
+	targets.pop_back();
+	outputs.pop_back();
+
+	std::string cache = cacheFunction;
+	ReplaceToken(cache, "@TARGETS@", targets);
+	ReplaceToken(cache, "@LOCALS@", values.locals);
+	ReplaceToken(cache, "@OUTPUTS@", outputs);
+	code.cache = functionDefinitions + cache;
 
-	return functionDefinitions + mainFunction;
+	return code;
 }
 
+void PrintShaderSeed(const SplitShaderCode& shaders)
+{
+	std::cout << "Shader seed: " << shaders.seed << " (cost " << int(shaders.cost + 0.5f) << (shaders.animated ? ")" : ", static)") << std::endl;
+}
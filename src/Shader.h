@@ -3,5 +3,62 @@
 #include <string>
 #include <cstdint>
 
-std::string GenerateShaderCode(uint64_t seed);
+#include "Expression.h"
 
+// Expressions tried for a seed before giving up on the budget, after which the cheapest one is used
+static constexpr uint64_t MaxCostAttempts = 64ULL;
+
+// Procedurally generate the expression tree for the given seed
+// With a budget, expressions whose estimated cost (see EstimateCost) is over 'maxCost' are generated again from seeds
+// derived from this one, until one fits, so the image of a seed only depends on the seed and the budget
+// The default of 0 means no budget, and seeds whose expression fits the budget give the same image either way
+Expression GenerateExpression(uint64_t seed, float maxCost = 0.0f);
+
+// Time spent in each phase of generating a shader, in nanoseconds, added up over every shader it was passed to
+struct GenerationProfile
+{
+	double maskNanoseconds = 0.0; // Hashing the seed, drawing the depth and picking the mask
+	double expansionNanoseconds = 0.0; // Replacing tokens with functions and values, level by level
+	double constantNanoseconds = 0.0; // Replacing '#' tokens with random constants
+	double programNanoseconds = 0.0; // Flattening, sharing and simplifying the expression (see BuildProgram)
+	double sourceNanoseconds = 0.0; // Writing the source of the shader
+
+	double TotalNanoseconds() const { return maskNanoseconds + expansionNanoseconds + constantNanoseconds + programNanoseconds + sourceNanoseconds; }
+};
+
+// Most render targets written by the cache pass of a split shader, with 4 values each
+static constexpr int MaxCacheTargets = 8;
+
+// Pixel shaders of a seed split in two passes, so that animated images only evaluate the part of the expression that depends on time
+struct SplitShaderCode
+{
+	// Drawn once per seed, writing the values that do not depend on time into 'cacheTargets' float4 render targets
+	// For images that do not depend on time at all, this draws the final color instead, and 'cacheTargets' is 1
+	// Empty if the animated part of the expression does not use any value worth caching
+	std::string cache;
+	// Drawn every frame, reading the cached values from textures t0 onwards at the position of the pixel
+	// Empty if the image does not depend on time
+	std::string frame;
+	int cacheTargets = 0;
+	bool animated = true;
+	// Seed of the expression, as printed with "Shader seed:" (see PrintShaderSeed)
+	uint64_t seed = 0ULL;
+	// Estimated cost of one pixel of the whole expression (see EstimateCost)
+	float cost = 0.0f;
+	// Structural hash of the program (see HashProgram), under which the compiled shaders are kept in a KernelCache
+	uint64_t programHash = 0ULL;
+};
+
+// Procedurally generate the full pixel shader source for the given seed
+std::string GenerateShaderCode(uint64_t seed, float maxCost = 0.0f);
+// Same as GenerateShaderCode without a budget, timing each phase and without printing the seed, to measure the generator
+// A 'maxDepth' above 0 replaces the depth drawn from the seed, which otherwise stays as random as in GenerateExpression
+// The generated expression is also returned if 'expression' is not null
+std::string GenerateShaderCodeProfiled(uint64_t seed, int maxDepth, GenerationProfile& profile, Expression* expression = nullptr);
+// Procedurally generate the pixel shaders for the given seed, split into a cache pass and a frame pass
+// Unlike GenerateShaderCode, this does not print the seed, since the shaders may be generated ahead of time on another thread
+SplitShaderCode GenerateSplitShaderCode(uint64_t seed, float maxCost = 0.0f);
+// Print the seed and cost of split shaders once they are shown, marking images that do not change over time
+void PrintShaderSeed(const SplitShaderCode& shaders);
+// Source of the primitive functions used by every generated shader
+const char* GetFunctionDefinitions();
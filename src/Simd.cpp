@@ -0,0 +1,338 @@
+#include "Simd.h"
+
+#include "Primitives.h"
+
+#if SIMD_X64 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if SIMD_X64
+// Defined in SimdSSE42.cpp, SimdAVX2.cpp and SimdAVX512.cpp, each compiled for its own instruction set
+void EvaluateBlockSSE42(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb);
+void EvaluateBlockAVX2(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb);
+void EvaluateBlockAVX512(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb);
+#endif
+
+SimdLevel DetectSimdLevel()
+{
+#if SIMD_X64 && defined(_MSC_VER)
+
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse42 = info[2] & (1 << 20);
+	const bool osxsave = info[2] & (1 << 27);
+	const bool avx = info[2] & (1 << 28);
+
+	__cpuidex(info, 7, 0);
+	const bool avx2 = info[1] & (1 << 5);
+	const bool avx512 = info[1] & (1 << 16);
+
+	// The OS must also save the extended registers on context switches
+	const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0ULL;
+	if (avx512 && (xcr0 & 0xe6) == 0xe6)
+		return SimdLevel::AVX512;
+	if (avx && avx2 && (xcr0 & 0x6) == 0x6)
+		return SimdLevel::AVX2;
+	if (sse42)
+		return SimdLevel::SSE42;
+
+#elif SIMD_X64
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return SimdLevel::AVX512;
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse4.2"))
+		return SimdLevel::SSE42;
+
+#endif
+
+	return SimdLevel::Scalar;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+		case SimdLevel::SSE42:  return "sse4.2";
+		case SimdLevel::AVX2:   return "avx2";
+		case SimdLevel::AVX512: return "avx512";
+		default:                return "scalar";
+	}
+}
+
+// Pack the instructions needed to compute the given registers into slots
+// Pinned registers are not computed, but get slots of their own that are never reused, to be filled before the block function runs
+static BlockProgram AllocateSlots(const Program& program, const std::vector<uint32_t>& outputs, const std::vector<uint8_t>& pinned,
+	std::vector<uint32_t>& slotOf)
+{
+	const uint32_t size = uint32_t(program.code.size());
+	auto isPinned = [&](uint32_t reg) { return !pinned.empty() && pinned[reg]; };
+
+	// Only the instructions that the outputs depend on are computed
+	std::vector<uint8_t> needed(size);
+	for (uint32_t reg : outputs)
+		needed[reg] = 1;
+	for (uint32_t i = size; i-- > 0U;)
+		if (needed[i] && !isPinned(i))
+			for (int a = 0; a < GetOpInfo(program.code[i].op).arity; a++)
+				needed[program.code[i].args[a]] = 1;
+
+	// Find the last instruction that reads each register
+	// Registers that are never read die right after being written
+	std::vector<uint32_t> lastUse(size);
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		if (!needed[i] || isPinned(i))
+			continue;
+
+		lastUse[i] = i;
+		for (int a = 0; a < GetOpInfo(program.code[i].op).arity; a++)
+			lastUse[program.code[i].args[a]] = i;
+	}
+
+	// The outputs are read after all instructions
+	for (uint32_t reg : outputs)
+		lastUse[reg] = size;
+
+	BlockProgram block;
+	block.code.reserve(size);
+
+	slotOf.assign(size, 0U);
+	for (uint32_t i = 0U; i < size; i++)
+		if (needed[i] && isPinned(i))
+			slotOf[i] = block.slotCount++;
+
+	std::vector<uint32_t> freeSlots;
+	std::vector<bool> freed(size, false);
+
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		if (!needed[i] || isPinned(i))
+			continue;
+
+		const Instruction& in = program.code[i];
+		const int arity = GetOpInfo(in.op).arity;
+
+		BlockInstruction out;
+		out.op = in.op;
+		out.value = in.value;
+		for (int a = 0; a < arity; a++)
+			out.args[a] = slotOf[in.args[a]];
+
+		// Inputs read for the last time can hold the result, because every lane reads its inputs before writing
+		for (int a = 0; a < arity; a++)
+		{
+			const uint32_t arg = in.args[a];
+			if (lastUse[arg] == i && !freed[arg] && !isPinned(arg))
+			{
+				freed[arg] = true;
+				freeSlots.push_back(slotOf[arg]);
+			}
+		}
+
+		if (freeSlots.empty())
+		{
+			slotOf[i] = block.slotCount++;
+		}
+		else
+		{
+			slotOf[i] = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		out.dst = slotOf[i];
+		block.code.push_back(out);
+
+		if (lastUse[i] == i)
+		{
+			freed[i] = true;
+			freeSlots.push_back(slotOf[i]);
+		}
+	}
+
+	return block;
+}
+
+// Registers read after all instructions: the three channels, followed by the inputs of the masks
+static std::vector<uint32_t> ColorRegisters(const Program& program)
+{
+	std::vector<uint32_t> registers(program.channels, program.channels + 3);
+	for (const MaskStep& step : program.mask)
+		if (step.op != Op::Inv3)
+			registers.push_back(step.arg);
+	return registers;
+}
+
+// Point the channels and masks of a block program to the slots of the corresponding registers
+static void SetColorSlots(const Program& program, const std::vector<uint32_t>& slotOf, BlockProgram& block)
+{
+	for (int c = 0; c < 3; c++)
+		block.channels[c] = slotOf[program.channels[c]];
+	for (MaskStep step : program.mask)
+	{
+		if (step.op != Op::Inv3)
+			step.arg = slotOf[step.arg];
+		block.mask.push_back(step);
+	}
+}
+
+BlockProgram BuildBlockProgram(const Program& program)
+{
+	std::vector<uint32_t> slotOf;
+	BlockProgram block = AllocateSlots(program, ColorRegisters(program), {}, slotOf);
+	SetColorSlots(program, slotOf, block);
+	return block;
+}
+
+SeparatedBlockProgram BuildSeparatedBlockProgram(const Program& program)
+{
+	const uint32_t size = uint32_t(program.code.size());
+	const std::vector<uint8_t> inputs = FindInputs(program);
+	const std::vector<uint32_t> outputs = ColorRegisters(program);
+
+	// Walk down from the color, and stop at the first value on each path that does not depend on both coordinates
+	// The values themselves (uv.x, sinTime, constants...) are as cheap to compute for every pixel as to copy, so they are never hoisted
+	std::vector<uint8_t> needed(size);
+	std::vector<uint8_t> hoisted(size);
+	for (uint32_t reg : outputs)
+		needed[reg] = 1;
+	for (uint32_t i = size; i-- > 0U;)
+	{
+		if (!needed[i])
+			continue;
+
+		const Instruction& in = program.code[i];
+		if (GetOpInfo(in.op).arity > 0 && (inputs[i] & (InputX | InputY)) != (InputX | InputY))
+		{
+			hoisted[i] = 1;
+			continue;
+		}
+
+		for (int a = 0; a < GetOpInfo(in.op).arity; a++)
+			needed[in.args[a]] = 1;
+	}
+
+	SeparatedBlockProgram separated;
+	std::vector<uint32_t> slotOf;
+	separated.pixels = AllocateSlots(program, outputs, hoisted, slotOf);
+	SetColorSlots(program, slotOf, separated.pixels);
+
+	// Each hoisted value is computed by the program of the coordinate it depends on, if any
+	std::vector<uint32_t> values[3];
+	HoistedBlockProgram* kinds[3] = { &separated.columns, &separated.rows, &separated.frame };
+	for (uint32_t i = 0U; i < size; i++)
+	{
+		if (!hoisted[i])
+			continue;
+
+		const int kind = (inputs[i] & InputX) ? 0 : (inputs[i] & InputY) ? 1 : 2;
+		values[kind].push_back(i);
+		kinds[kind]->targets.push_back(slotOf[i]);
+	}
+
+	for (int kind = 0; kind < 3; kind++)
+	{
+		std::vector<uint32_t> valueSlots;
+		kinds[kind]->program = AllocateSlots(program, values[kind], {}, valueSlots);
+		for (uint32_t reg : values[kind])
+			kinds[kind]->values.push_back(valueSlots[reg]);
+	}
+
+	return separated;
+}
+
+// Reference implementation, one pixel at a time with the same primitives as CpuRenderer::EvaluatePixel
+static void EvaluateBlockScalar(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb)
+{
+	for (const BlockInstruction& in : program.code)
+	{
+		float* d = slots + size_t(in.dst) * BlockSize;
+		const float* a = slots + size_t(in.args[0]) * BlockSize;
+		const float* b = slots + size_t(in.args[1]) * BlockSize;
+		const float* c = slots + size_t(in.args[2]) * BlockSize;
+		const float* w = slots + size_t(in.args[3]) * BlockSize;
+
+		for (int i = 0; i < BlockSize; i++)
+		{
+			switch (in.op)
+			{
+				case Op::X:          d[i] = x[i]; break;
+				case Op::Y:          d[i] = y[i]; break;
+				case Op::InvX:       d[i] = 1.0f - x[i]; break;
+				case Op::InvY:       d[i] = 1.0f - y[i]; break;
+				case Op::SinTime:    d[i] = frame.sinTime; break;
+				case Op::CosTime:    d[i] = frame.cosTime; break;
+				case Op::Const:      d[i] = in.value; break;
+
+				case Op::Inv:        d[i] = fInv(a[i]); break;
+				case Op::Sqr:        d[i] = fSqr(a[i]); break;
+				case Op::Sqrt:       d[i] = fSqrt(a[i]); break;
+				case Op::Smooth:     d[i] = fSmooth(a[i]); break;
+				case Op::Sharp:      d[i] = fSharp(a[i]); break;
+
+				case Op::Add:        d[i] = fAdd(a[i], b[i]); break;
+				case Op::Sub:        d[i] = fSub(a[i], b[i]); break;
+				case Op::Mul:        d[i] = fMul(a[i], b[i]); break;
+				case Op::Div:        d[i] = fDiv(a[i], b[i]); break;
+				case Op::Avg:        d[i] = fAvg(a[i], b[i]); break;
+				case Op::Geom:       d[i] = fGeom(a[i], b[i]); break;
+				case Op::Harm:       d[i] = fHarm(a[i], b[i]); break;
+				case Op::Hypo:       d[i] = fHypo(a[i], b[i]); break;
+				case Op::Min:        d[i] = fMin(a[i], b[i]); break;
+				case Op::Max:        d[i] = fMax(a[i], b[i]); break;
+				case Op::Pow:        d[i] = fPow(a[i], b[i]); break;
+				case Op::Bell:       d[i] = fBell(a[i], b[i]); break;
+				case Op::Wave:       d[i] = fWave(a[i], b[i]); break;
+				case Op::WaveDamp:   d[i] = fWaveDamp(a[i], b[i]); break;
+
+				case Op::Lerp:       d[i] = fLerp(a[i], b[i], c[i]); break;
+				case Op::SmoothLerp: d[i] = fSmoothLerp(a[i], b[i], c[i]); break;
+				case Op::Mlerp:      d[i] = fMlerp(a[i], b[i], c[i]); break;
+				case Op::Clamp:      d[i] = fClamp(a[i], b[i], c[i]); break;
+
+				case Op::Dist:       d[i] = fDist(a[i], b[i], c[i], w[i]); break;
+				case Op::DistLine:   d[i] = fDistLine(a[i], b[i], c[i], w[i]); break;
+
+				default: d[i] = 0.0f; break;
+			}
+		}
+	}
+
+	for (int c = 0; c < 3; c++)
+	{
+		const float* src = slots + size_t(program.channels[c]) * BlockSize;
+		float* dst = rgb + c * BlockSize;
+
+		for (int i = 0; i < BlockSize; i++)
+			dst[i] = src[i];
+
+		for (const MaskStep& step : program.mask)
+		{
+			const float* arg = slots + size_t(step.arg) * BlockSize;
+			for (int i = 0; i < BlockSize; i++)
+			{
+				switch (step.op)
+				{
+					case Op::Inv3: dst[i] = fInv3(dst[i]); break;
+					case Op::Add3: dst[i] = fAdd3(dst[i], arg[i]); break;
+					case Op::Sub3: dst[i] = fSub3(dst[i], arg[i]); break;
+					default: break;
+				}
+			}
+		}
+	}
+}
+
+BlockFunction GetBlockFunction(SimdLevel level)
+{
+	switch (level)
+	{
+#if SIMD_X64
+		case SimdLevel::SSE42:  return EvaluateBlockSSE42;
+		case SimdLevel::AVX2:   return EvaluateBlockAVX2;
+		case SimdLevel::AVX512: return EvaluateBlockAVX512;
+#endif
+		default:                return EvaluateBlockScalar;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Program.h"
+
+// The vectorized block functions are only built for x86-64
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X64 1
+#else
+#define SIMD_X64 0
+#endif
+
+// Instruction sets available for block evaluation, from slowest to fastest
+enum class SimdLevel : uint8_t
+{
+	Scalar,
+	SSE42,
+	AVX2,
+	AVX512
+};
+
+// Get the fastest instruction set supported by both the CPU and the build
+SimdLevel DetectSimdLevel();
+const char* GetSimdLevelName(SimdLevel level);
+
+// Number of pixels evaluated together by each block function
+static constexpr int BlockSize = 64;
+
+struct BlockInstruction
+{
+	Op op = Op::Const;
+	float value = 0.0f; // Only used by Op::Const
+	uint32_t dst = 0U; // Slot that receives the result
+	uint32_t args[4] = {}; // Slots holding the inputs, only the first 'arity' are used
+};
+
+// Program whose registers are packed into a small number of reusable slots
+// Each slot holds BlockSize floats, so the whole working set of a block stays in cache
+struct BlockProgram
+{
+	std::vector<BlockInstruction> code;
+	uint32_t channels[3] = {}; // Slots holding the red, green and blue channels
+	std::vector<MaskStep> mask; // Same as the program mask, with 'arg' referring to a slot
+	uint32_t slotCount = 0U;
+};
+
+BlockProgram BuildBlockProgram(const Program& program);
+
+// Values of a program that depend on a single coordinate, or on neither, evaluated once per column, once per row or once per frame
+struct HoistedBlockProgram
+{
+	BlockProgram program; // Computes the values, with the x coordinate of each lane for columns and the y coordinate for rows
+	std::vector<uint32_t> values; // Slots of 'program' holding each value
+	std::vector<uint32_t> targets; // Slots of the per pixel program that must receive each value
+};
+
+// Program split by the coordinates that its values depend on, so that only the values that depend on both are evaluated for every pixel
+struct SeparatedBlockProgram
+{
+	BlockProgram pixels; // Evaluated for every pixel, reading the hoisted values from slots that are never overwritten
+	HoistedBlockProgram columns; // Values that depend on x but not on y
+	HoistedBlockProgram rows; // Values that depend on y but not on x
+	HoistedBlockProgram frame; // Values that depend only on time and constants
+};
+
+SeparatedBlockProgram BuildSeparatedBlockProgram(const Program& program);
+
+// Evaluate BlockSize pixels at coordinates (x[i], y[i])
+// 'slots' must hold slotCount * BlockSize floats, aligned to 64 bytes
+// 'rgb' receives BlockSize red values, followed by BlockSize green values and BlockSize blue values
+typedef void (*BlockFunction)(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb);
+
+// Get the block function for the given instruction set, which must be supported by the CPU
+BlockFunction GetBlockFunction(SimdLevel level);
+
+// Transcendental functions of the AVX2 block function, applied in place to 'count' vectors of 8 floats at 'v' (aligned to 32 bytes)
+// They are called by the machine code generated in X64Kernel.cpp, which inlines everything else
+// PowAVX2 reads x from the first 8 * count floats and y from the next 8 * count floats, and writes x^y over x
+void Exp2AVX2(float* v, int count);
+void PowAVX2(float* v, int count);
+void CosAVX2(float* v, int count);
+void TanAVX2(float* v, int count);
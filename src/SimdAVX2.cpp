@@ -0,0 +1,86 @@
+#include "Simd.h"
+
+#if SIMD_X64
+
+#include <limits>
+#include <immintrin.h>
+
+// This file must be compiled with AVX2 enabled (see premake5.lua)
+
+namespace
+{
+	constexpr int WIDTH = 8;
+
+	struct F { __m256 v; };
+	struct I { __m256i v; };
+	typedef F M;
+
+	inline F operator+(F a, F b) { return { _mm256_add_ps(a.v, b.v) }; }
+	inline F operator-(F a, F b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	inline F operator*(F a, F b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	inline F operator/(F a, F b) { return { _mm256_div_ps(a.v, b.v) }; }
+	inline F operator-(F a) { return { _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)) }; }
+
+	inline I operator+(I a, I b) { return { _mm256_add_epi32(a.v, b.v) }; }
+	inline I operator-(I a, I b) { return { _mm256_sub_epi32(a.v, b.v) }; }
+	inline I operator&(I a, I b) { return { _mm256_and_si256(a.v, b.v) }; }
+	inline I operator|(I a, I b) { return { _mm256_or_si256(a.v, b.v) }; }
+
+	inline M operator< (F a, F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+	inline M operator> (F a, F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+	inline M operator<=(F a, F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+	inline M operator>=(F a, F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+	inline M operator==(F a, F b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+
+	inline F Set(float x) { return { _mm256_set1_ps(x) }; }
+	inline I SetI(int32_t x) { return { _mm256_set1_epi32(x) }; }
+	inline F Load(const float* p) { return { _mm256_load_ps(p) }; }
+	inline void Store(float* p, F a) { _mm256_store_ps(p, a.v); }
+
+	inline F Select(M m, F a, F b) { return { _mm256_blendv_ps(b.v, a.v, m.v) }; }
+	inline M Or(M a, M b) { return { _mm256_or_ps(a.v, b.v) }; }
+	inline M NonZero(I a) { return { _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(a.v, _mm256_setzero_si256()), _mm256_set1_epi32(-1))) }; }
+
+	inline F Sqrt(F a) { return { _mm256_sqrt_ps(a.v) }; }
+	inline F Abs(F a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+	inline F MinF(F a, F b) { return { _mm256_min_ps(a.v, b.v) }; }
+	inline F MaxF(F a, F b) { return { _mm256_max_ps(a.v, b.v) }; }
+	inline F Round(F a) { return { _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+	inline I ToInt(F a) { return { _mm256_cvttps_epi32(a.v) }; }
+	inline F ToFloat(I a) { return { _mm256_cvtepi32_ps(a.v) }; }
+	inline I AsInt(F a) { return { _mm256_castps_si256(a.v) }; }
+	inline F AsFloat(I a) { return { _mm256_castsi256_ps(a.v) }; }
+
+	template <int N> inline I ShiftLeft(I a) { return { _mm256_slli_epi32(a.v, N) }; }
+	template <int N> inline I ShiftRight(I a) { return { _mm256_srli_epi32(a.v, N) }; }
+}
+
+#define SIMD_BLOCK_FUNCTION EvaluateBlockAVX2
+#include "SimdKernels.inl"
+
+void Exp2AVX2(float* v, int count)
+{
+	for (int i = 0; i < count * WIDTH; i += WIDTH)
+		Store(v + i, Exp2(Load(v + i)));
+}
+
+void PowAVX2(float* v, int count)
+{
+	for (int i = 0; i < count * WIDTH; i += WIDTH)
+		Store(v + i, Pow(Load(v + i), Load(v + count * WIDTH + i)));
+}
+
+void CosAVX2(float* v, int count)
+{
+	for (int i = 0; i < count * WIDTH; i += WIDTH)
+		Store(v + i, Cos(Load(v + i)));
+}
+
+void TanAVX2(float* v, int count)
+{
+	for (int i = 0; i < count * WIDTH; i += WIDTH)
+		Store(v + i, Tan(Load(v + i)));
+}
+
+#endif // SIMD_X64
@@ -0,0 +1,62 @@
+#include "Simd.h"
+
+#if SIMD_X64
+
+#include <limits>
+#include <immintrin.h>
+
+// This file must be compiled with AVX-512F enabled (see premake5.lua)
+
+namespace
+{
+	constexpr int WIDTH = 16;
+
+	struct F { __m512 v; };
+	struct I { __m512i v; };
+	typedef __mmask16 M;
+
+	inline F operator+(F a, F b) { return { _mm512_add_ps(a.v, b.v) }; }
+	inline F operator-(F a, F b) { return { _mm512_sub_ps(a.v, b.v) }; }
+	inline F operator*(F a, F b) { return { _mm512_mul_ps(a.v, b.v) }; }
+	inline F operator/(F a, F b) { return { _mm512_div_ps(a.v, b.v) }; }
+	inline F operator-(F a) { return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(int32_t(0x80000000U)))) }; }
+
+	inline I operator+(I a, I b) { return { _mm512_add_epi32(a.v, b.v) }; }
+	inline I operator-(I a, I b) { return { _mm512_sub_epi32(a.v, b.v) }; }
+	inline I operator&(I a, I b) { return { _mm512_and_si512(a.v, b.v) }; }
+	inline I operator|(I a, I b) { return { _mm512_or_si512(a.v, b.v) }; }
+
+	inline M operator< (F a, F b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+	inline M operator> (F a, F b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ); }
+	inline M operator<=(F a, F b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ); }
+	inline M operator>=(F a, F b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ); }
+	inline M operator==(F a, F b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ); }
+
+	inline F Set(float x) { return { _mm512_set1_ps(x) }; }
+	inline I SetI(int32_t x) { return { _mm512_set1_epi32(x) }; }
+	inline F Load(const float* p) { return { _mm512_load_ps(p) }; }
+	inline void Store(float* p, F a) { _mm512_store_ps(p, a.v); }
+
+	inline F Select(M m, F a, F b) { return { _mm512_mask_blend_ps(m, b.v, a.v) }; }
+	inline M Or(M a, M b) { return M(a | b); }
+	inline M NonZero(I a) { return _mm512_test_epi32_mask(a.v, a.v); }
+
+	inline F Sqrt(F a) { return { _mm512_sqrt_ps(a.v) }; }
+	inline F Abs(F a) { return { _mm512_abs_ps(a.v) }; }
+	inline F MinF(F a, F b) { return { _mm512_min_ps(a.v, b.v) }; }
+	inline F MaxF(F a, F b) { return { _mm512_max_ps(a.v, b.v) }; }
+	inline F Round(F a) { return { _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+	inline I ToInt(F a) { return { _mm512_cvttps_epi32(a.v) }; }
+	inline F ToFloat(I a) { return { _mm512_cvtepi32_ps(a.v) }; }
+	inline I AsInt(F a) { return { _mm512_castps_si512(a.v) }; }
+	inline F AsFloat(I a) { return { _mm512_castsi512_ps(a.v) }; }
+
+	template <int N> inline I ShiftLeft(I a) { return { _mm512_slli_epi32(a.v, N) }; }
+	template <int N> inline I ShiftRight(I a) { return { _mm512_srli_epi32(a.v, N) }; }
+}
+
+#define SIMD_BLOCK_FUNCTION EvaluateBlockAVX512
+#include "SimdKernels.inl"
+
+#endif // SIMD_X64
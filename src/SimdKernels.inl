@@ -0,0 +1,449 @@
+// Vectorized primitives and block evaluator, shared by every instruction set
+// This file is included by SimdSSE42.cpp, SimdAVX2.cpp and SimdAVX512.cpp, which first define in an anonymous namespace:
+//
+//   WIDTH             Number of lanes
+//   F, I, M           Float vector, 32-bit integer vector and lane mask types
+//   + - * / and -x    Lane-wise float arithmetic, and + - & | on integer vectors
+//   < > <= >= ==      Ordered comparisons returning M (false when either side is NaN)
+//   Set, SetI         Broadcast a float or an integer to all lanes
+//   Load, Store       Aligned memory access
+//   Select(m, a, b)   Lane-wise m ? a : b, without branches
+//   Or                Lane-wise mask union
+//   NonZero           Mask of integer lanes that are not zero
+//   Sqrt, Abs
+//   MinF, MaxF        Hardware min and max, which return the second operand if either is NaN
+//   Round             Round to nearest integer
+//   ToInt, ToFloat    Truncating conversion to integer, and back to float
+//   AsInt, AsFloat    Bit casts
+//   ShiftLeft<N>, ShiftRight<N>
+//
+// and define SIMD_BLOCK_FUNCTION to the name of the block function to export
+//
+// All primitives use the same operations in the same order as Primitives.h, so results are identical
+// except for the transcendental functions (exp2, log2, pow, cos, tan), which use polynomial approximations
+// within a few ulps of the standard library (based on the Cephes math library by Stephen L. Moshier)
+
+static_assert(BlockSize % WIDTH == 0, "The block size must be a multiple of the vector width.");
+
+#pragma region Transcendental functions
+
+// 2^x
+static inline F Exp2(F x)
+{
+	// Clamping keeps the exponent in range, and the constant comes first so NaN passes through
+	x = MinF(Set(128.0f), MaxF(Set(-127.0f), x));
+
+	// 2^x = 2^n * 2^f, with n integer and f in [-0.5, 0.5]
+	F n = Round(x);
+	F f = x - n;
+
+	F p = Set(1.535336188319500e-4f);
+	p = p * f + Set(1.339887440266574e-3f);
+	p = p * f + Set(9.618437357674640e-3f);
+	p = p * f + Set(5.550332471162809e-2f);
+	p = p * f + Set(2.402264791363012e-1f);
+	p = p * f + Set(6.931472028550421e-1f);
+	p = p * f + Set(1.0f);
+
+	// Build 2^n directly in the exponent bits (n = -127 gives 0, and n = 128 gives infinity)
+	F scale = AsFloat(ShiftLeft<23>(ToInt(n) + SetI(127)));
+	return p * scale;
+}
+
+// log2(x), for x > 0
+static inline F Log2(F x)
+{
+	// Split x into m * 2^e, with m in [0.5, 1)
+	I bits = AsInt(x);
+	F e = ToFloat((ShiftRight<23>(bits) & SetI(0xff)) - SetI(126));
+	F m = AsFloat((bits & SetI(0x007fffff)) | SetI(0x3f000000));
+
+	// Shift m to [sqrt(0.5), sqrt(2)) and take log(1 + m)
+	M small = m < Set(0.70710678f);
+	e = Select(small, e - Set(1.0f), e);
+	m = Select(small, m + m - Set(1.0f), m - Set(1.0f));
+
+	F z = m * m;
+	F p = Set(7.0376836292e-2f);
+	p = p * m + Set(-1.1514610310e-1f);
+	p = p * m + Set(1.1676998740e-1f);
+	p = p * m + Set(-1.2420140846e-1f);
+	p = p * m + Set(1.4249322787e-1f);
+	p = p * m + Set(-1.6668057665e-1f);
+	p = p * m + Set(2.0000714765e-1f);
+	p = p * m + Set(-2.4999993993e-1f);
+	p = p * m + Set(3.3333331174e-1f);
+	F y = m * (z * p) - Set(0.5f) * z;
+
+	// Convert to base 2 with extra precision
+	const F LOG2EA = Set(0.44269504088896340736f);
+	F r = m * LOG2EA;
+	r = r + y * LOG2EA;
+	r = r + y;
+	r = r + m;
+	r = r + e;
+
+	// Zero gives -infinity, infinity gives itself, and negative numbers or NaN give NaN
+	const F inf = Set(std::numeric_limits<float>::infinity());
+	r = Select(x == inf, inf, r);
+	r = Select(x > Set(0.0f), r, Select(x == Set(0.0f), -inf, Set(std::numeric_limits<float>::quiet_NaN())));
+	return r;
+}
+
+// x^y, for x > 0
+static inline F Pow(F x, F y)
+{
+	return Exp2(y * Log2(x));
+}
+
+// Reduce x >= 0 to z in [-pi/4, pi/4], returning the (even) octant j such that x = j * pi/4 + z
+static inline F ReduceQuarterPi(F x, I& j)
+{
+	const F FOPI = Set(1.27323954473516f); // 4 / pi
+	j = ToInt(x * FOPI);
+	j = (j + SetI(1)) & SetI(~1);
+	F y = ToFloat(j);
+
+	// Extended precision modular arithmetic
+	return ((x - y * Set(0.78515625f)) - y * Set(2.4187564849853515625e-4f)) - y * Set(3.77489497744594108e-8f);
+}
+
+static inline F Cos(F x)
+{
+	I j;
+	F z = ReduceQuarterPi(Abs(x), j);
+	F zz = z * z;
+
+	F s = Set(-1.9515295891e-4f);
+	s = s * zz + Set(8.3321608736e-3f);
+	s = s * zz + Set(-1.6666654611e-1f);
+	s = z + z * zz * s;
+
+	F c = Set(2.443315711809948e-5f);
+	c = c * zz + Set(-1.388731625493765e-3f);
+	c = c * zz + Set(4.166664568298827e-2f);
+	c = Set(1.0f) - Set(0.5f) * zz + zz * zz * c;
+
+	// Octants 2 and 6 use the sine polynomial, and octants 2 and 4 are negated
+	F r = Select(NonZero(j & SetI(2)), s, c);
+	return Select(NonZero((j + SetI(2)) & SetI(4)), -r, r);
+}
+
+static inline F Tan(F x)
+{
+	I j;
+	F z = ReduceQuarterPi(Abs(x), j);
+	F zz = z * z;
+
+	F p = Set(9.38540185543e-3f);
+	p = p * zz + Set(3.11992232697e-3f);
+	p = p * zz + Set(2.44301354525e-2f);
+	p = p * zz + Set(5.34112807005e-2f);
+	p = p * zz + Set(1.33387994085e-1f);
+	p = p * zz + Set(3.33331568548e-1f);
+	F t = Select(zz > Set(1.0e-4f), p * zz * z + z, z);
+
+	// Octants 2 and 6 use the cotangent, and tan is odd
+	t = Select(NonZero(j & SetI(2)), Set(-1.0f) / t, t);
+	return Select(x < Set(0.0f), -t, t);
+}
+
+#pragma endregion
+
+#pragma region Primitives
+
+// Same definitions as Primitives.h and the HLSL in Shader.cpp, with every branch replaced by Select
+
+static inline F fInv(F x)
+{
+	return Set(1.0f) - x;
+}
+
+static inline F fSqr(F x)
+{
+	return x * x;
+}
+
+static inline F fSqrt(F x)
+{
+	return Sqrt(x);
+}
+
+static inline F fSmooth(F x)
+{
+	F x2 = x * x;
+	F x3 = x2 * x;
+	return x2 + x2 + x2 - x3 - x3;
+}
+
+static inline F fSharp(F x)
+{
+	return x * (x * (x + x - Set(3.0f)) + Set(2.0f));
+}
+
+static inline F fAdd(F x, F y)
+{
+	F res = x + y;
+	return Select(res > Set(1.0f), Set(2.0f) - res, res);
+}
+
+static inline F fSub(F x, F y)
+{
+	F res = x - y;
+	return Select(res < Set(0.0f), -res, res);
+}
+
+static inline F fMul(F x, F y)
+{
+	return x * y;
+}
+
+static inline F fDiv(F x, F y)
+{
+	M swap = x > y;
+	F min = Select(swap, y, x);
+	F max = Select(swap, x, y);
+	max = Select(max < Set(0.0001f), Set(0.0001f), max);
+	return min / max;
+}
+
+static inline F fAvg(F x, F y)
+{
+	return (x + y) * Set(0.5f);
+}
+
+static inline F fGeom(F x, F y)
+{
+	return Sqrt(x * y);
+}
+
+static inline F fHarm(F x, F y)
+{
+	F den = x + y;
+	den = Select(den < Set(0.0001f), Set(0.0001f), den);
+	return (Set(2.0f) * x * y) / den;
+}
+
+static inline F fHypo(F x, F y)
+{
+	return Set(0.70710678f) * Sqrt(x * x + y * y);
+}
+
+static inline F fMin(F x, F y)
+{
+	return Select(x < y, x, y);
+}
+
+static inline F fMax(F x, F y)
+{
+	return Select(x > y, x, y);
+}
+
+static inline F fPow(F x, F y)
+{
+	x = Select(x < Set(0.01f), Set(0.01f), x);
+	x = Select(x > Set(0.99f), Set(0.99f), x);
+	F exp = Exp2(Set(4.0f) * y - Set(2.0f));
+	return Pow(x, exp);
+}
+
+static inline F fBell(F x, F y)
+{
+	x = Select(x < Set(0.01f), Set(0.01f), x);
+	x = Select(x > Set(0.99f), Set(0.99f), x);
+	F y2 = y * y;
+	return Pow(Set(4.0f) * x * (Set(1.0f) - x), Set(20.0f) * y2 * y2 + Set(0.3f));
+}
+
+static inline F fWave(F x, F y)
+{
+	const F MAX_FREQUENCY = Set(6.0f * 3.1415927f);
+	return Set(0.5f) + Set(0.5f) * Cos(MAX_FREQUENCY * x * y);
+}
+
+static inline F fWaveDamp(F x, F y)
+{
+	const F FREQUENCY_FACTOR = Set(3.0f * 3.1415927f);
+	const F SHIFT_FACTOR = Set(1.0f / 6.0f);
+	F osc = Cos(FREQUENCY_FACTOR * x * (y + SHIFT_FACTOR)) * Exp2(-x * x);
+	return osc * osc;
+}
+
+static inline F fLerp(F x, F y, F z)
+{
+	return (Set(1.0f) - z) * x + z * y;
+}
+
+static inline F fSmoothLerp(F x, F y, F z)
+{
+	F z2 = z * z;
+	F z3 = z2 * z;
+	F smooth = z2 + z2 + z2 - z3 - z3;
+	return smooth * (y - x) + x;
+}
+
+static inline F fMlerp(F x, F y, F z)
+{
+	x = Select(x < Set(0.0001f), Set(0.0001f), x);
+	y = Select(y < Set(0.0001f), Set(0.0001f), y);
+	return x * Pow(y / x, z);
+}
+
+static inline F fClamp(F x, F y, F z)
+{
+	M swap = x > y;
+	F min = Select(swap, y, x);
+	F max = Select(swap, x, y);
+	return Select(z < min, min, Select(z > max, max, z));
+}
+
+static inline F fDist(F x, F y, F z, F w)
+{
+	F dx = x - z;
+	F dy = y - w;
+	return Set(0.70710678f) * Sqrt(dx * dx + dy * dy);
+}
+
+static inline F fDistLine(F x, F y, F z, F w)
+{
+	// Both slanted cases share the same slope, and only differ in the intercept
+	M below = z < Set(0.499f);
+	F m = Tan(z * Set(3.1415927f));
+	F n = Select(below, (Set(1.0f) - w) * (Set(1.0f) + m) - m, w - m * w);
+	F c = (x + y * m - m * n) / (m * m + Set(1.0f));
+	F dx = c - x;
+	F dy = m * c + n - y;
+	F slanted = Set(0.70710678f) * Sqrt(dx * dx + dy * dy);
+
+	// Nearly vertical lines
+	F vertical = Set(0.70710678f) * Abs(w - x);
+	return Select(Or(below, z > Set(0.501f)), slanted, vertical);
+}
+
+static inline F fInv3(F v)
+{
+	return Set(1.0f) - v;
+}
+
+static inline F fAdd3(F v, F x)
+{
+	F res = v + x;
+	F t = Select(res >= Set(1.0f), Set(1.0f), Set(0.0f));
+	return res + t * ((Set(2.0f) - res) - res);
+}
+
+static inline F fSub3(F v, F x)
+{
+	F res = v - x;
+	F t = Select(res >= Set(0.0f), Set(1.0f), Set(0.0f));
+	return -res + t * (res + res);
+}
+
+#pragma endregion
+
+#pragma region Block evaluation
+
+template <typename Fn>
+static inline void Map(float* d, const float* a, Fn fn)
+{
+	for (int i = 0; i < BlockSize; i += WIDTH)
+		Store(d + i, fn(Load(a + i)));
+}
+template <typename Fn>
+static inline void Map(float* d, const float* a, const float* b, Fn fn)
+{
+	for (int i = 0; i < BlockSize; i += WIDTH)
+		Store(d + i, fn(Load(a + i), Load(b + i)));
+}
+template <typename Fn>
+static inline void Map(float* d, const float* a, const float* b, const float* c, Fn fn)
+{
+	for (int i = 0; i < BlockSize; i += WIDTH)
+		Store(d + i, fn(Load(a + i), Load(b + i), Load(c + i)));
+}
+template <typename Fn>
+static inline void Map(float* d, const float* a, const float* b, const float* c, const float* w, Fn fn)
+{
+	for (int i = 0; i < BlockSize; i += WIDTH)
+		Store(d + i, fn(Load(a + i), Load(b + i), Load(c + i), Load(w + i)));
+}
+
+static inline void Fill(float* d, float value)
+{
+	for (int i = 0; i < BlockSize; i += WIDTH)
+		Store(d + i, Set(value));
+}
+
+void SIMD_BLOCK_FUNCTION(const BlockProgram& program, const float* x, const float* y, FrameInputs frame, float* slots, float* rgb)
+{
+	for (const BlockInstruction& in : program.code)
+	{
+		float* d = slots + size_t(in.dst) * BlockSize;
+		const float* a = slots + size_t(in.args[0]) * BlockSize;
+		const float* b = slots + size_t(in.args[1]) * BlockSize;
+		const float* c = slots + size_t(in.args[2]) * BlockSize;
+		const float* w = slots + size_t(in.args[3]) * BlockSize;
+
+		switch (in.op)
+		{
+			case Op::X:          Map(d, x, [](F v) { return v; }); break;
+			case Op::Y:          Map(d, y, [](F v) { return v; }); break;
+			case Op::InvX:       Map(d, x, fInv); break;
+			case Op::InvY:       Map(d, y, fInv); break;
+			case Op::SinTime:    Fill(d, frame.sinTime); break;
+			case Op::CosTime:    Fill(d, frame.cosTime); break;
+			case Op::Const:      Fill(d, in.value); break;
+
+			case Op::Inv:        Map(d, a, fInv); break;
+			case Op::Sqr:        Map(d, a, fSqr); break;
+			case Op::Sqrt:       Map(d, a, fSqrt); break;
+			case Op::Smooth:     Map(d, a, fSmooth); break;
+			case Op::Sharp:      Map(d, a, fSharp); break;
+
+			case Op::Add:        Map(d, a, b, fAdd); break;
+			case Op::Sub:        Map(d, a, b, fSub); break;
+			case Op::Mul:        Map(d, a, b, fMul); break;
+			case Op::Div:        Map(d, a, b, fDiv); break;
+			case Op::Avg:        Map(d, a, b, fAvg); break;
+			case Op::Geom:       Map(d, a, b, fGeom); break;
+			case Op::Harm:       Map(d, a, b, fHarm); break;
+			case Op::Hypo:       Map(d, a, b, fHypo); break;
+			case Op::Min:        Map(d, a, b, fMin); break;
+			case Op::Max:        Map(d, a, b, fMax); break;
+			case Op::Pow:        Map(d, a, b, fPow); break;
+			case Op::Bell:       Map(d, a, b, fBell); break;
+			case Op::Wave:       Map(d, a, b, fWave); break;
+			case Op::WaveDamp:   Map(d, a, b, fWaveDamp); break;
+
+			case Op::Lerp:       Map(d, a, b, c, fLerp); break;
+			case Op::SmoothLerp: Map(d, a, b, c, fSmoothLerp); break;
+			case Op::Mlerp:      Map(d, a, b, c, fMlerp); break;
+			case Op::Clamp:      Map(d, a, b, c, fClamp); break;
+
+			case Op::Dist:       Map(d, a, b, c, w, fDist); break;
+			case Op::DistLine:   Map(d, a, b, c, w, fDistLine); break;
+
+			default: Fill(d, 0.0f); break;
+		}
+	}
+
+	for (int c = 0; c < 3; c++)
+	{
+		float* d = rgb + c * BlockSize;
+		Map(d, slots + size_t(program.channels[c]) * BlockSize, [](F v) { return v; });
+
+		for (const MaskStep& step : program.mask)
+		{
+			const float* arg = slots + size_t(step.arg) * BlockSize;
+			switch (step.op)
+			{
+				case Op::Inv3: Map(d, d, fInv3); break;
+				case Op::Add3: Map(d, d, arg, fAdd3); break;
+				case Op::Sub3: Map(d, d, arg, fSub3); break;
+				default: break;
+			}
+		}
+	}
+}
+
+#pragma endregion
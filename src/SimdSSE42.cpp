@@ -0,0 +1,62 @@
+#include "Simd.h"
+
+#if SIMD_X64
+
+#include <limits>
+#include <immintrin.h>
+
+// This file must be compiled with SSE4.2 enabled (see premake5.lua)
+
+namespace
+{
+	constexpr int WIDTH = 4;
+
+	struct F { __m128 v; };
+	struct I { __m128i v; };
+	typedef F M;
+
+	inline F operator+(F a, F b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline F operator-(F a, F b) { return { _mm_sub_ps(a.v, b.v) }; }
+	inline F operator*(F a, F b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline F operator/(F a, F b) { return { _mm_div_ps(a.v, b.v) }; }
+	inline F operator-(F a) { return { _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)) }; }
+
+	inline I operator+(I a, I b) { return { _mm_add_epi32(a.v, b.v) }; }
+	inline I operator-(I a, I b) { return { _mm_sub_epi32(a.v, b.v) }; }
+	inline I operator&(I a, I b) { return { _mm_and_si128(a.v, b.v) }; }
+	inline I operator|(I a, I b) { return { _mm_or_si128(a.v, b.v) }; }
+
+	inline M operator< (F a, F b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	inline M operator> (F a, F b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	inline M operator<=(F a, F b) { return { _mm_cmple_ps(a.v, b.v) }; }
+	inline M operator>=(F a, F b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	inline M operator==(F a, F b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+
+	inline F Set(float x) { return { _mm_set1_ps(x) }; }
+	inline I SetI(int32_t x) { return { _mm_set1_epi32(x) }; }
+	inline F Load(const float* p) { return { _mm_load_ps(p) }; }
+	inline void Store(float* p, F a) { _mm_store_ps(p, a.v); }
+
+	inline F Select(M m, F a, F b) { return { _mm_blendv_ps(b.v, a.v, m.v) }; }
+	inline M Or(M a, M b) { return { _mm_or_ps(a.v, b.v) }; }
+	inline M NonZero(I a) { return { _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(a.v, _mm_setzero_si128()), _mm_set1_epi32(-1))) }; }
+
+	inline F Sqrt(F a) { return { _mm_sqrt_ps(a.v) }; }
+	inline F Abs(F a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+	inline F MinF(F a, F b) { return { _mm_min_ps(a.v, b.v) }; }
+	inline F MaxF(F a, F b) { return { _mm_max_ps(a.v, b.v) }; }
+	inline F Round(F a) { return { _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+
+	inline I ToInt(F a) { return { _mm_cvttps_epi32(a.v) }; }
+	inline F ToFloat(I a) { return { _mm_cvtepi32_ps(a.v) }; }
+	inline I AsInt(F a) { return { _mm_castps_si128(a.v) }; }
+	inline F AsFloat(I a) { return { _mm_castsi128_ps(a.v) }; }
+
+	template <int N> inline I ShiftLeft(I a) { return { _mm_slli_epi32(a.v, N) }; }
+	template <int N> inline I ShiftRight(I a) { return { _mm_srli_epi32(a.v, N) }; }
+}
+
+#define SIMD_BLOCK_FUNCTION EvaluateBlockSSE42
+#include "SimdKernels.inl"
+
+#endif // SIMD_X64
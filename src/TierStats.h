@@ -0,0 +1,21 @@
+#pragma once
+
+// Timing of the frames drawn with one tier of the kernels of a seed, such as block evaluation before the jit kernel is compiled,
+// or an unoptimized pixel shader before the optimized one is ready
+struct TierStats
+{
+	double firstPixelMilliseconds = -1.0; // From the moment the seed was requested until the first frame of this tier was done, negative if none was
+	int frames = 0;
+	double frameMilliseconds = 0.0; // Total time of all the frames of this tier
+
+	void AddFrame(double sinceRequest, double milliseconds)
+	{
+		if (frames == 0)
+			firstPixelMilliseconds = sinceRequest;
+		frames++;
+		frameMilliseconds += milliseconds;
+	}
+
+	// Steady state frame time of this tier
+	double AverageFrameMilliseconds() const { return frames > 0 ? frameMilliseconds / frames : 0.0; }
+};
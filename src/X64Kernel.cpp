@@ -0,0 +1,1255 @@
+#include "X64Kernel.h"
+
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+
+#include "Simd.h"
+
+#if SIMD_X64
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+	#pragma region Assembler
+
+	// General purpose registers used by the generated code
+	enum Gpr : uint8_t
+	{
+		RAX = 0,
+		RCX = 1,
+		RBX = 3,
+		RSP = 4,
+		RBP = 5,
+		R12 = 12
+	};
+
+	// A ymm register, memory at [base + disp], or a broadcast constant addressed relative to the instruction pointer
+	struct Operand
+	{
+		int reg = -1;
+		uint8_t base = 0;
+		int32_t disp = 0;
+		int constant = -1;
+	};
+
+	Operand Reg(int reg)
+	{
+		Operand operand;
+		operand.reg = reg;
+		return operand;
+	}
+
+	Operand Mem(uint8_t base, int32_t disp)
+	{
+		Operand operand;
+		operand.base = base;
+		operand.disp = disp;
+		return operand;
+	}
+
+	// VEX opcode maps and prefixes
+	enum : uint8_t
+	{
+		MAP_0F = 1,
+		MAP_0F3A = 3,
+		PP_NONE = 0,
+		PP_66 = 1
+	};
+
+	// Packed single precision opcodes (map 0F, no prefix)
+	enum : uint8_t
+	{
+		LOAD = 0x10,
+		STORE = 0x11,
+		SQRT = 0x51,
+		AND = 0x54,
+		OR = 0x56,
+		XOR = 0x57,
+		ADD = 0x58,
+		MUL = 0x59,
+		SUB = 0x5C,
+		DIV = 0x5E,
+		CMP = 0xC2,
+		BLEND = 0x4A // Map 0F3A, prefix 66
+	};
+
+	// Ordered, non-signaling comparison predicates, same as the _CMP_xx_OQ constants
+	enum : uint8_t
+	{
+		LT = 0x11,
+		GT = 0x1E,
+		GE = 0x1D
+	};
+
+	class Assembler
+	{
+	public:
+		std::vector<uint8_t> code;
+
+		void Bytes(std::initializer_list<uint8_t> bytes)
+		{
+			code.insert(code.end(), bytes.begin(), bytes.end());
+		}
+
+		void Int32(uint32_t value)
+		{
+			for (int i = 0; i < 4; i++)
+				code.push_back(uint8_t(value >> (8 * i)));
+		}
+
+		void Int64(uint64_t value)
+		{
+			for (int i = 0; i < 8; i++)
+				code.push_back(uint8_t(value >> (8 * i)));
+		}
+
+		// Encode an AVX instruction with a 3 byte VEX prefix: reg = src1 op rm, with an optional 8 bit immediate
+		void Vex(uint8_t map, uint8_t pp, bool ymm, uint8_t opcode, int reg, int src1, const Operand& rm, int imm = -1)
+		{
+			const bool memory = rm.reg < 0;
+			const bool relative = memory && rm.constant >= 0;
+			const int rmCode = !memory ? rm.reg : (relative ? int(RBP) : int(rm.base));
+
+			code.push_back(0xC4);
+			code.push_back(uint8_t((((~reg >> 3) & 1) << 7) | (1 << 6) | (((~rmCode >> 3) & 1) << 5) | map));
+			code.push_back(uint8_t(((~src1 & 15) << 3) | (ymm ? 4 : 0) | pp));
+			code.push_back(opcode);
+
+			size_t position = 0;
+			if (!memory)
+			{
+				code.push_back(uint8_t(0xC0 | ((reg & 7) << 3) | (rm.reg & 7)));
+			}
+			else if (relative)
+			{
+				code.push_back(uint8_t(0x05 | ((reg & 7) << 3)));
+				position = code.size();
+				Int32(0);
+			}
+			else
+			{
+				// Always use a 32 bit displacement, and RSP and R12 need a SIB byte
+				code.push_back(uint8_t(0x80 | ((reg & 7) << 3) | (rm.base & 7)));
+				if ((rm.base & 7) == RSP)
+					code.push_back(0x24);
+				Int32(uint32_t(rm.disp));
+			}
+
+			if (imm >= 0)
+				code.push_back(uint8_t(imm));
+
+			// The displacement is relative to the end of the instruction, and the constants are only placed at the end
+			if (relative)
+				m_Fixups.push_back({ position, code.size(), rm.constant });
+		}
+
+		// Get the operand of a constant broadcast to all 8 lanes, given its bits
+		Operand Constant(uint32_t bits)
+		{
+			auto it = m_ConstantIndices.find(bits);
+			if (it == m_ConstantIndices.end())
+			{
+				it = m_ConstantIndices.emplace(bits, int(m_Constants.size())).first;
+				m_Constants.push_back(bits);
+			}
+
+			Operand operand;
+			operand.constant = it->second;
+			return operand;
+		}
+
+		// Append the constants after the code, aligned to 32 bytes, and resolve every reference to them
+		void Finish()
+		{
+			while (code.size() % 32 != 0)
+				code.push_back(0xCC);
+
+			const size_t start = code.size();
+			for (uint32_t bits : m_Constants)
+				for (int i = 0; i < 8; i++)
+					Int32(bits);
+
+			for (const Fixup& fixup : m_Fixups)
+			{
+				const uint32_t disp = uint32_t(start + 32 * size_t(fixup.constant) - fixup.end);
+				for (int i = 0; i < 4; i++)
+					code[fixup.position + i] = uint8_t(disp >> (8 * i));
+			}
+		}
+
+	private:
+		struct Fixup
+		{
+			size_t position;
+			size_t end;
+			int constant;
+		};
+
+		std::vector<uint32_t> m_Constants;
+		std::unordered_map<uint32_t, int> m_ConstantIndices;
+		std::vector<Fixup> m_Fixups;
+	};
+
+	#pragma endregion
+
+	#pragma region Code generator
+
+	// Each call of the generated function evaluates several groups of 8 pixels
+	static constexpr uint32_t GROUP_COUNT = uint32_t(X64Kernel::PixelCount / 8);
+
+	// Frame of the generated function, relative to RSP (aligned to 32 bytes)
+	// The first 32 bytes are the shadow space required by the Windows calling convention
+	// Then come the buffers passed to the transcendental functions, the saved xmm registers (only on Windows), and the spill slots
+	static constexpr int32_t AREA_OFFSET = 32;
+	static constexpr int32_t AREA_SIZE = int32_t(32 * GROUP_COUNT);
+	static constexpr int AREA_COUNT = 3;
+#ifdef _WIN32
+	static constexpr int32_t XMM_OFFSET = AREA_OFFSET + AREA_SIZE * AREA_COUNT;
+	static constexpr int32_t SPILL_OFFSET = XMM_OFFSET + 16 * 10;
+#else
+	static constexpr int32_t SPILL_OFFSET = AREA_OFFSET + AREA_SIZE * AREA_COUNT;
+#endif
+
+	static constexpr int REGISTER_COUNT = 16;
+	static constexpr int TEMPORARY = -2; // Owner of a register holding an intermediate result of the current instruction
+
+	// Translates a program into machine code, one instruction at a time
+	// Program registers live in ymm registers for as long as possible, and when they run out, the one used furthest in the future is spilled
+	class CodeGenerator
+	{
+	public:
+		explicit CodeGenerator(const Program& program)
+			: m_Program(program)
+		{
+			// Every program register has one value per group, and each instruction is emitted once per group
+			const uint32_t size = uint32_t(program.code.size());
+			m_Values.resize(size_t(size) * GROUP_COUNT);
+
+			auto forEachUse = [&](auto&& use)
+			{
+				for (uint32_t i = 0U; i < size; i++)
+					for (int a = 0; a < GetOpInfo(program.code[i].op).arity; a++)
+						for (uint32_t g = 0U; g < GROUP_COUNT; g++)
+							use(program.code[i].args[a] * GROUP_COUNT + g, i * GROUP_COUNT + g);
+
+				// The channels and masks are read after every instruction
+				for (uint32_t g = 0U; g < GROUP_COUNT; g++)
+				{
+					for (int c = 0; c < 3; c++)
+						use(program.channels[c] * GROUP_COUNT + g, size * GROUP_COUNT);
+					for (const MaskStep& step : program.mask)
+						if (step.op != Op::Inv3)
+							use(step.arg * GROUP_COUNT + g, size * GROUP_COUNT);
+				}
+			};
+
+			// The uses of all values share one array, so count them first and give each value its range
+			forEachUse([&](uint32_t value, uint32_t) { m_Values[value].endUse++; });
+			uint32_t useCount = 0U;
+			for (Value& value : m_Values)
+			{
+				value.nextUse = useCount;
+				useCount += value.endUse;
+				value.endUse = value.nextUse;
+			}
+			m_Uses.resize(useCount);
+			forEachUse([&](uint32_t value, uint32_t time) { m_Uses[m_Values[value].endUse++] = time; });
+
+			for (int r = 0; r < REGISTER_COUNT; r++)
+			{
+				m_Owner[r] = -1;
+				m_Locked[r] = false;
+			}
+		}
+
+		std::vector<uint8_t> Generate()
+		{
+			// Each node takes about 240 bytes, for all the groups
+			m_Asm.code.reserve(m_Program.code.size() * 256);
+			EmitPrologue();
+
+			const uint32_t size = uint32_t(m_Program.code.size());
+			// Instructions that call transcendental functions are emitted in two stages, so each function is called once for all groups
+			for (uint32_t i = 0U; i < size; i++)
+			{
+				m_Instruction = &m_Program.code[i];
+				const int stageCount = EmitCalls(false) ? 2 : 1;
+
+				for (m_Stage = 0; m_Stage < stageCount; m_Stage++)
+				{
+					if (m_Stage > 0)
+						EmitCalls(true);
+
+					for (m_Group = 0U; m_Group < GROUP_COUNT; m_Group++)
+					{
+						m_Time = i * GROUP_COUNT + m_Group;
+						EmitInstruction();
+						ReleaseTemps();
+					}
+				}
+
+				for (m_Group = 0U; m_Group < GROUP_COUNT; m_Group++)
+				{
+					m_Time = i * GROUP_COUNT + m_Group;
+					ReleaseInputs();
+				}
+			}
+
+			EmitOutput();
+			EmitEpilogue();
+
+			m_Asm.Finish();
+			return std::move(m_Asm.code);
+		}
+
+	private:
+		struct Value
+		{
+			int reg = -1; // ymm register holding the value, if any
+			bool hasHome = false; // Whether the value can also be read from 'home'
+			Operand home; // Constant, input or spill slot
+			int slot = -1;
+			uint32_t nextUse = 0U; // Range of m_Uses with the instructions that still read the value, in order
+			uint32_t endUse = 0U;
+		};
+
+		const Program& m_Program;
+		Assembler m_Asm;
+
+		std::vector<Value> m_Values;
+		std::vector<uint32_t> m_Uses;
+		int m_Owner[REGISTER_COUNT];
+		bool m_Locked[REGISTER_COUNT];
+
+		std::vector<int> m_FreeSlots;
+		int m_SlotCount = 0;
+		size_t m_FrameSizePosition = 0;
+
+		uint32_t m_Time = 0U; // Index of the value computed by the current instruction and group
+		uint32_t m_Group = 0U;
+		int m_Stage = 0;
+		const Instruction* m_Instruction = nullptr;
+
+		#pragma region Registers
+
+		uint32_t NextUse(uint32_t value) const
+		{
+			const Value& v = m_Values[value];
+			return v.nextUse < v.endUse ? m_Uses[v.nextUse] : UINT32_MAX;
+		}
+
+		// Make sure the value in the given register can be read from memory, and free the register
+		void Evict(int reg)
+		{
+			const int owner = m_Owner[reg];
+			if (owner >= 0)
+			{
+				Value& value = m_Values[owner];
+				if (!value.hasHome)
+				{
+					if (m_FreeSlots.empty())
+					{
+						value.slot = m_SlotCount++;
+					}
+					else
+					{
+						value.slot = m_FreeSlots.back();
+						m_FreeSlots.pop_back();
+					}
+					value.home = Mem(RSP, SPILL_OFFSET + 32 * value.slot);
+					value.hasHome = true;
+					m_Asm.Vex(MAP_0F, PP_NONE, true, STORE, reg, 0, value.home);
+				}
+				value.reg = -1;
+			}
+			m_Owner[reg] = -1;
+			m_Locked[reg] = false;
+		}
+
+		// Find a register that can be overwritten, spilling the value that is needed the latest if all are taken
+		int FindRegister()
+		{
+			int best = -1;
+			uint32_t bestUse = 0U;
+			for (int r = 0; r < REGISTER_COUNT; r++)
+			{
+				if (m_Locked[r])
+					continue;
+				if (m_Owner[r] == -1)
+					return r;
+
+				const uint32_t use = NextUse(uint32_t(m_Owner[r]));
+				if (best < 0 || use > bestUse)
+				{
+					best = r;
+					bestUse = use;
+				}
+			}
+
+			Evict(best);
+			return best;
+		}
+
+		// Register for an intermediate result, which is released at the end of the instruction
+		int Temp()
+		{
+			const int reg = FindRegister();
+			m_Owner[reg] = TEMPORARY;
+			m_Locked[reg] = true;
+			return reg;
+		}
+
+		// Operand holding the given value, from a register if it is in one
+		Operand ValueOperand(uint32_t value)
+		{
+			const Value& v = m_Values[value];
+			if (v.reg >= 0)
+			{
+				m_Locked[v.reg] = true;
+				return Reg(v.reg);
+			}
+			return v.home;
+		}
+
+		// Register holding the given value, loading it if needed
+		int ValueReg(uint32_t value)
+		{
+			Value& v = m_Values[value];
+			if (v.reg < 0)
+			{
+				const int reg = FindRegister();
+				m_Asm.Vex(MAP_0F, PP_NONE, true, LOAD, reg, 0, v.home);
+				m_Owner[reg] = int(value);
+				v.reg = reg;
+			}
+			m_Locked[v.reg] = true;
+			return v.reg;
+		}
+
+		// Inputs of the current instruction
+		Operand A(int index) { return ValueOperand(m_Instruction->args[index] * GROUP_COUNT + m_Group); }
+		int R(int index) { return ValueReg(m_Instruction->args[index] * GROUP_COUNT + m_Group); }
+
+		// Input of the current group, in the order x, y, sinTime, cosTime
+		Operand Input(int index) const
+		{
+			return Mem(RBX, int32_t(32 * (uint32_t(index) * GROUP_COUNT + m_Group)));
+		}
+
+		Operand K(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return m_Asm.Constant(bits);
+		}
+
+		Operand KBits(uint32_t bits)
+		{
+			return m_Asm.Constant(bits);
+		}
+
+		// Buffer of the current group passed to the transcendental functions, which also holds values across calls
+		Operand Area(int index) const
+		{
+			return Mem(RSP, AREA_OFFSET + AREA_SIZE * index + int32_t(32 * m_Group));
+		}
+
+		#pragma endregion
+
+		#pragma region Instructions
+
+		void V(uint8_t opcode, int dst, int src1, const Operand& src2)
+		{
+			m_Asm.Vex(MAP_0F, PP_NONE, true, opcode, dst, src1, src2);
+		}
+
+		void V(uint8_t opcode, int dst, int src1, int src2)
+		{
+			V(opcode, dst, src1, Reg(src2));
+		}
+
+		void Cmp(int dst, int a, const Operand& b, uint8_t predicate)
+		{
+			m_Asm.Vex(MAP_0F, PP_NONE, true, CMP, dst, a, b, predicate);
+		}
+
+		void Sqrt(int dst, const Operand& a)
+		{
+			m_Asm.Vex(MAP_0F, PP_NONE, true, SQRT, dst, 0, a);
+		}
+
+		// dst = mask ? whenTrue : whenFalse
+		void Select(int dst, int mask, const Operand& whenTrue, int whenFalse)
+		{
+			m_Asm.Vex(MAP_0F3A, PP_66, true, BLEND, dst, whenFalse, whenTrue, mask << 4);
+		}
+
+		int Load(const Operand& operand)
+		{
+			const int reg = Temp();
+			m_Asm.Vex(MAP_0F, PP_NONE, true, LOAD, reg, 0, operand);
+			return reg;
+		}
+
+		void Store(const Operand& memory, int reg)
+		{
+			m_Asm.Vex(MAP_0F, PP_NONE, true, STORE, reg, 0, memory);
+		}
+
+		// Call a transcendental function on the given area of every group
+		// Every ymm register is overwritten by the call, so values without a home are spilled, and temporaries are lost
+		void Call(void (*function)(float*, int), int area)
+		{
+			for (int r = 0; r < REGISTER_COUNT; r++)
+				Evict(r);
+
+#ifdef _WIN32
+			m_Asm.Bytes({ 0x48, 0x8D, 0x8C, 0x24 }); // lea rcx, [rsp + disp32]
+#else
+			m_Asm.Bytes({ 0x48, 0x8D, 0xBC, 0x24 }); // lea rdi, [rsp + disp32]
+#endif
+			m_Asm.Int32(uint32_t(AREA_OFFSET + AREA_SIZE * area));
+#ifdef _WIN32
+			m_Asm.Bytes({ 0xBA }); // mov edx, imm32
+#else
+			m_Asm.Bytes({ 0xBE }); // mov esi, imm32
+#endif
+			m_Asm.Int32(GROUP_COUNT);
+			m_Asm.Bytes({ 0x48, 0xB8 }); // mov rax, imm64
+			m_Asm.Int64(uint64_t(reinterpret_cast<uintptr_t>(function)));
+			m_Asm.Bytes({ 0xFF, 0xD0 }); // call rax
+		}
+
+		#pragma endregion
+
+		#pragma region Function body
+
+		void EmitPrologue()
+		{
+			m_Asm.Bytes({ 0x55 }); // push rbp
+			m_Asm.Bytes({ 0x48, 0x89, 0xE5 }); // mov rbp, rsp
+			m_Asm.Bytes({ 0x53 }); // push rbx
+			m_Asm.Bytes({ 0x41, 0x54 }); // push r12
+			m_Asm.Bytes({ 0x48, 0x81, 0xEC }); // sub rsp, imm32
+			m_FrameSizePosition = m_Asm.code.size();
+			m_Asm.Int32(0U);
+			m_Asm.Bytes({ 0x48, 0x83, 0xE4, 0xE0 }); // and rsp, -32
+
+#ifdef _WIN32
+			m_Asm.Bytes({ 0x48, 0x89, 0xCB }); // mov rbx, rcx
+			m_Asm.Bytes({ 0x49, 0x89, 0xD4 }); // mov r12, rdx
+
+			// xmm6 to xmm15 are preserved across calls on Windows
+			for (int i = 0; i < 10; i++)
+				m_Asm.Vex(MAP_0F, PP_NONE, false, STORE, 6 + i, 0, Mem(RSP, XMM_OFFSET + 16 * i));
+#else
+			m_Asm.Bytes({ 0x48, 0x89, 0xFB }); // mov rbx, rdi
+			m_Asm.Bytes({ 0x49, 0x89, 0xF4 }); // mov r12, rsi
+#endif
+		}
+
+		void EmitEpilogue()
+		{
+#ifdef _WIN32
+			for (int i = 0; i < 10; i++)
+				m_Asm.Vex(MAP_0F, PP_NONE, false, LOAD, 6 + i, 0, Mem(RSP, XMM_OFFSET + 16 * i));
+#endif
+			m_Asm.Bytes({ 0xC5, 0xF8, 0x77 }); // vzeroupper
+			m_Asm.Bytes({ 0x48, 0x8D, 0x65, 0xF0 }); // lea rsp, [rbp - 16]
+			m_Asm.Bytes({ 0x41, 0x5C }); // pop r12
+			m_Asm.Bytes({ 0x5B }); // pop rbx
+			m_Asm.Bytes({ 0x5D }); // pop rbp
+			m_Asm.Bytes({ 0xC3 }); // ret
+
+			// Now the number of spill slots is known, with 32 more bytes for the alignment of RSP
+			const uint32_t frameSize = uint32_t(SPILL_OFFSET + 32 * m_SlotCount + 32);
+			for (int i = 0; i < 4; i++)
+				m_Asm.code[m_FrameSizePosition + i] = uint8_t(frameSize >> (8 * i));
+		}
+
+		void ReleaseTemps()
+		{
+			for (int r = 0; r < REGISTER_COUNT; r++)
+			{
+				if (m_Owner[r] == TEMPORARY)
+					m_Owner[r] = -1;
+				m_Locked[r] = false;
+			}
+		}
+
+		// Release the inputs of the current group that are not used anymore, and the result if it is never used
+		void ReleaseInputs()
+		{
+			for (int a = 0; a < GetOpInfo(m_Instruction->op).arity; a++)
+			{
+				Value& value = m_Values[m_Instruction->args[a] * GROUP_COUNT + m_Group];
+				while (value.nextUse < value.endUse && m_Uses[value.nextUse] <= m_Time)
+					value.nextUse++;
+
+				if (value.nextUse == value.endUse)
+				{
+					if (value.reg >= 0)
+						m_Owner[value.reg] = -1;
+					if (value.slot >= 0)
+						m_FreeSlots.push_back(value.slot);
+					value.reg = -1;
+					value.slot = -1;
+				}
+			}
+
+			Value& result = m_Values[m_Time];
+			if (result.nextUse == result.endUse && result.reg >= 0)
+			{
+				m_Owner[result.reg] = -1;
+				result.reg = -1;
+			}
+		}
+
+		// Keep the given temporary as the result of the current instruction
+		void Result(int reg)
+		{
+			m_Owner[reg] = int(m_Time);
+			m_Values[m_Time].reg = reg;
+		}
+
+		// Make the current instruction readable from the given memory, without any code
+		void Home(const Operand& operand)
+		{
+			m_Values[m_Time].home = operand;
+			m_Values[m_Time].hasHome = true;
+		}
+
+		// Clamp x to [0.01, 0.99], like fPow and fBell
+		int ClampUnit()
+		{
+			const int m = Temp();
+			const int x = Temp();
+			Cmp(m, R(0), K(0.01f), LT);
+			Select(x, m, K(0.01f), R(0));
+			Cmp(m, x, K(0.99f), GT);
+			Select(x, m, K(0.99f), x);
+			return x;
+		}
+
+		// Emit the calls of the current instruction between its two stages, returns false if it has none
+		bool EmitCalls(bool emit)
+		{
+			switch (m_Instruction->op)
+			{
+				case Op::Pow:
+					if (emit)
+					{
+						Call(Exp2AVX2, 1);
+						Call(PowAVX2, 0);
+					}
+					return true;
+				case Op::Bell:
+				case Op::Mlerp:
+					if (emit)
+						Call(PowAVX2, 0);
+					return true;
+				case Op::Wave:
+					if (emit)
+						Call(CosAVX2, 0);
+					return true;
+				case Op::WaveDamp:
+					if (emit)
+					{
+						Call(CosAVX2, 0);
+						Call(Exp2AVX2, 1);
+					}
+					return true;
+				case Op::DistLine:
+					if (emit)
+						Call(TanAVX2, 0);
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		// Same operations in the same order as SimdKernels.inl
+		// Instructions with calls emit their inputs to the areas in stage 0, and compute their result from the areas in stage 1
+		void EmitInstruction()
+		{
+			switch (m_Instruction->op)
+			{
+				case Op::X:       Home(Input(0)); return;
+				case Op::Y:       Home(Input(1)); return;
+				case Op::SinTime: Home(Input(2)); return;
+				case Op::CosTime: Home(Input(3)); return;
+				case Op::Const:   Home(K(m_Instruction->value)); return;
+
+				case Op::InvX:
+				case Op::InvY:
+				{
+					const int r = Load(K(1.0f));
+					V(SUB, r, r, Input(m_Instruction->op == Op::InvX ? 0 : 1));
+					Result(r);
+					return;
+				}
+
+				case Op::Inv:
+				{
+					const int r = Load(K(1.0f));
+					V(SUB, r, r, A(0));
+					Result(r);
+					return;
+				}
+				case Op::Sqr:
+				{
+					const int r = Temp();
+					V(MUL, r, R(0), A(0));
+					Result(r);
+					return;
+				}
+				case Op::Sqrt:
+				{
+					const int r = Temp();
+					Sqrt(r, A(0));
+					Result(r);
+					return;
+				}
+				case Op::Smooth:
+				{
+					const int x2 = Temp();
+					const int x3 = Temp();
+					const int r = Temp();
+					V(MUL, x2, R(0), A(0));
+					V(MUL, x3, x2, A(0));
+					V(ADD, r, x2, x2);
+					V(ADD, r, r, x2);
+					V(SUB, r, r, x3);
+					V(SUB, r, r, x3);
+					Result(r);
+					return;
+				}
+				case Op::Sharp:
+				{
+					const int r = Temp();
+					V(ADD, r, R(0), A(0));
+					V(SUB, r, r, K(3.0f));
+					V(MUL, r, r, A(0));
+					V(ADD, r, r, K(2.0f));
+					V(MUL, r, r, A(0));
+					Result(r);
+					return;
+				}
+
+				case Op::Add:
+				{
+					const int r = Temp();
+					const int m = Temp();
+					V(ADD, r, R(0), A(1));
+					Cmp(m, r, K(1.0f), GT);
+					const int t = Load(K(2.0f));
+					V(SUB, t, t, r);
+					Select(r, m, Reg(t), r);
+					Result(r);
+					return;
+				}
+				case Op::Sub:
+				{
+					const int r = Temp();
+					const int m = Temp();
+					const int t = Temp();
+					V(SUB, r, R(0), A(1));
+					Cmp(m, r, K(0.0f), LT);
+					V(XOR, t, r, KBits(0x80000000U));
+					Select(r, m, Reg(t), r);
+					Result(r);
+					return;
+				}
+				case Op::Mul:
+				{
+					const int r = Temp();
+					V(MUL, r, R(0), A(1));
+					Result(r);
+					return;
+				}
+				case Op::Div:
+				{
+					const int m = Temp();
+					const int min = Temp();
+					const int max = Temp();
+					Cmp(m, R(0), A(1), GT);
+					Select(min, m, A(1), R(0));
+					Select(max, m, A(0), R(1));
+					Cmp(m, max, K(0.0001f), LT);
+					Select(max, m, K(0.0001f), max);
+					V(DIV, min, min, max);
+					Result(min);
+					return;
+				}
+				case Op::Avg:
+				{
+					const int r = Temp();
+					V(ADD, r, R(0), A(1));
+					V(MUL, r, r, K(0.5f));
+					Result(r);
+					return;
+				}
+				case Op::Geom:
+				{
+					const int r = Temp();
+					V(MUL, r, R(0), A(1));
+					Sqrt(r, Reg(r));
+					Result(r);
+					return;
+				}
+				case Op::Harm:
+				{
+					const int den = Temp();
+					const int m = Temp();
+					V(ADD, den, R(0), A(1));
+					Cmp(m, den, K(0.0001f), LT);
+					Select(den, m, K(0.0001f), den);
+					const int r = Load(K(2.0f));
+					V(MUL, r, r, A(0));
+					V(MUL, r, r, A(1));
+					V(DIV, r, r, den);
+					Result(r);
+					return;
+				}
+				case Op::Hypo:
+				{
+					const int r = Temp();
+					const int t = Temp();
+					V(MUL, r, R(0), A(0));
+					V(MUL, t, R(1), A(1));
+					V(ADD, r, r, t);
+					Sqrt(r, Reg(r));
+					V(MUL, r, r, K(0.70710678f));
+					Result(r);
+					return;
+				}
+				case Op::Min:
+				case Op::Max:
+				{
+					const int m = Temp();
+					const int r = Temp();
+					Cmp(m, R(0), A(1), m_Instruction->op == Op::Min ? LT : GT);
+					Select(r, m, A(0), R(1));
+					Result(r);
+					return;
+				}
+				case Op::Pow:
+				{
+					if (m_Stage == 0)
+					{
+						const int x = ClampUnit();
+						const int e = Load(K(4.0f));
+						V(MUL, e, e, A(1));
+						V(SUB, e, e, K(2.0f));
+						Store(Area(0), x);
+						Store(Area(1), e);
+						return;
+					}
+					Result(Load(Area(0)));
+					return;
+				}
+				case Op::Bell:
+				{
+					if (m_Stage == 1)
+					{
+						Result(Load(Area(0)));
+						return;
+					}
+
+					const int x = ClampUnit();
+					const int base = Load(K(4.0f));
+					const int t = Load(K(1.0f));
+					V(MUL, base, base, x);
+					V(SUB, t, t, x);
+					V(MUL, base, base, t);
+					const int y2 = Temp();
+					const int e = Load(K(20.0f));
+					V(MUL, y2, R(1), A(1));
+					V(MUL, e, e, y2);
+					V(MUL, e, e, y2);
+					V(ADD, e, e, K(0.3f));
+					Store(Area(0), base);
+					Store(Area(1), e);
+					return;
+				}
+				case Op::Wave:
+				{
+					if (m_Stage == 0)
+					{
+						const int t = Load(K(6.0f * 3.1415927f));
+						V(MUL, t, t, A(0));
+						V(MUL, t, t, A(1));
+						Store(Area(0), t);
+						return;
+					}
+
+					const int r = Load(Area(0));
+					V(MUL, r, r, K(0.5f));
+					V(ADD, r, r, K(0.5f));
+					Result(r);
+					return;
+				}
+				case Op::WaveDamp:
+				{
+					if (m_Stage == 0)
+					{
+						const int t = Load(K(3.0f * 3.1415927f));
+						const int s = Temp();
+						V(MUL, t, t, A(0));
+						V(ADD, s, R(1), K(1.0f / 6.0f));
+						V(MUL, t, t, s);
+						Store(Area(0), t);
+						V(XOR, s, R(0), KBits(0x80000000U));
+						V(MUL, s, s, A(0));
+						Store(Area(1), s);
+						return;
+					}
+
+					const int r = Load(Area(0));
+					V(MUL, r, r, Area(1));
+					V(MUL, r, r, r);
+					Result(r);
+					return;
+				}
+
+				case Op::Lerp:
+				{
+					const int r = Load(K(1.0f));
+					const int t = Temp();
+					V(SUB, r, r, A(2));
+					V(MUL, r, r, A(0));
+					V(MUL, t, R(2), A(1));
+					V(ADD, r, r, t);
+					Result(r);
+					return;
+				}
+				case Op::SmoothLerp:
+				{
+					const int z2 = Temp();
+					const int z3 = Temp();
+					const int s = Temp();
+					V(MUL, z2, R(2), A(2));
+					V(MUL, z3, z2, A(2));
+					V(ADD, s, z2, z2);
+					V(ADD, s, s, z2);
+					V(SUB, s, s, z3);
+					V(SUB, s, s, z3);
+					V(SUB, z2, R(1), A(0));
+					V(MUL, s, s, z2);
+					V(ADD, s, s, A(0));
+					Result(s);
+					return;
+				}
+				case Op::Mlerp:
+				{
+					if (m_Stage == 0)
+					{
+						const int m = Temp();
+						const int x = Temp();
+						const int y = Temp();
+						Cmp(m, R(0), K(0.0001f), LT);
+						Select(x, m, K(0.0001f), R(0));
+						Cmp(m, R(1), K(0.0001f), LT);
+						Select(y, m, K(0.0001f), R(1));
+						V(DIV, y, y, x);
+						Store(Area(2), x);
+						Store(Area(0), y);
+						Store(Area(1), R(2));
+						return;
+					}
+
+					const int r = Load(Area(2));
+					V(MUL, r, r, Area(0));
+					Result(r);
+					return;
+				}
+				case Op::Clamp:
+				{
+					const int m = Temp();
+					const int min = Temp();
+					const int max = Temp();
+					const int r = Temp();
+					Cmp(m, R(0), A(1), GT);
+					Select(min, m, A(1), R(0));
+					Select(max, m, A(0), R(1));
+					Cmp(m, R(2), Reg(max), GT);
+					Select(r, m, Reg(max), R(2));
+					Cmp(m, R(2), Reg(min), LT);
+					Select(r, m, Reg(min), r);
+					Result(r);
+					return;
+				}
+
+				case Op::Dist:
+				{
+					const int dx = Temp();
+					const int dy = Temp();
+					V(SUB, dx, R(0), A(2));
+					V(SUB, dy, R(1), A(3));
+					V(MUL, dx, dx, dx);
+					V(MUL, dy, dy, dy);
+					V(ADD, dx, dx, dy);
+					Sqrt(dx, Reg(dx));
+					V(MUL, dx, dx, K(0.70710678f));
+					Result(dx);
+					return;
+				}
+				case Op::DistLine:
+				{
+					if (m_Stage == 0)
+					{
+						const int angle = Temp();
+						V(MUL, angle, R(2), K(3.1415927f));
+						Store(Area(0), angle);
+						return;
+					}
+
+					const int m = Load(Area(0));
+					const int below = Temp();
+					Cmp(below, R(2), K(0.499f), LT);
+
+					// Intercept of both slanted cases
+					const int n = Load(K(1.0f));
+					const int t = Temp();
+					const int u = Temp();
+					V(SUB, n, n, A(3));
+					V(ADD, t, m, K(1.0f));
+					V(MUL, n, n, t);
+					V(SUB, n, n, m);
+					V(MUL, t, m, A(3));
+					V(SUB, u, R(3), t);
+					Select(n, below, Reg(n), u);
+
+					// Closest point on the line
+					V(MUL, t, R(1), m);
+					V(ADD, t, R(0), t);
+					V(MUL, u, m, n);
+					V(SUB, t, t, u);
+					V(MUL, u, m, m);
+					V(ADD, u, u, K(1.0f));
+					V(DIV, t, t, u);
+
+					V(SUB, u, t, A(0));
+					V(MUL, t, m, t);
+					V(ADD, t, t, n);
+					V(SUB, t, t, A(1));
+					V(MUL, u, u, u);
+					V(MUL, t, t, t);
+					V(ADD, u, u, t);
+					Sqrt(u, Reg(u));
+					V(MUL, u, u, K(0.70710678f));
+
+					// Nearly vertical lines
+					V(SUB, t, R(3), A(0));
+					V(AND, t, t, KBits(0x7FFFFFFFU));
+					V(MUL, t, t, K(0.70710678f));
+
+					Cmp(m, R(2), K(0.501f), GT);
+					V(OR, below, below, m);
+					Select(t, below, Reg(u), t);
+					Result(t);
+					return;
+				}
+
+				default:
+				{
+					const int r = Temp();
+					V(XOR, r, r, r);
+					Result(r);
+					return;
+				}
+			}
+		}
+
+		// Write the three channels, after applying the masks to each of them
+		void EmitOutput()
+		{
+			for (uint32_t g = 0U; g < GROUP_COUNT; g++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					int r = Load(ValueOperand(m_Program.channels[c] * GROUP_COUNT + g));
+
+					for (const MaskStep& step : m_Program.mask)
+					{
+						switch (step.op)
+						{
+							case Op::Inv3:
+							{
+								const int t = Load(K(1.0f));
+								V(SUB, t, t, r);
+								r = t;
+								break;
+							}
+							case Op::Add3:
+							{
+								const int res = Temp();
+								const int m = Temp();
+								V(ADD, res, r, ValueOperand(step.arg * GROUP_COUNT + g));
+								Cmp(m, res, K(1.0f), GE);
+								const int t = Load(K(0.0f));
+								Select(t, m, K(1.0f), t);
+								const int u = Load(K(2.0f));
+								V(SUB, u, u, res);
+								V(SUB, u, u, res);
+								V(MUL, u, t, u);
+								V(ADD, res, res, u);
+								r = res;
+								break;
+							}
+							case Op::Sub3:
+							{
+								const int res = Temp();
+								const int m = Temp();
+								V(SUB, res, r, ValueOperand(step.arg * GROUP_COUNT + g));
+								Cmp(m, res, K(0.0f), GE);
+								const int t = Load(K(0.0f));
+								Select(t, m, K(1.0f), t);
+								const int u = Temp();
+								V(ADD, u, res, res);
+								V(MUL, u, t, u);
+								V(XOR, res, res, KBits(0x80000000U));
+								V(ADD, res, res, u);
+								r = res;
+								break;
+							}
+							default:
+								break;
+						}
+
+						// Only the current channel value is still needed
+						for (int reg = 0; reg < REGISTER_COUNT; reg++)
+						{
+							if (reg == r)
+								continue;
+							if (m_Owner[reg] == TEMPORARY)
+								m_Owner[reg] = -1;
+							m_Locked[reg] = false;
+						}
+					}
+
+					Store(Mem(R12, int32_t(32 * (uint32_t(c) * GROUP_COUNT + g))), r);
+					m_Owner[r] = -1;
+					m_Locked[r] = false;
+				}
+			}
+		}
+
+		#pragma endregion
+	};
+
+	#pragma endregion
+}
+
+X64Kernel::X64Kernel(const Expression& expression)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	if (DetectSimdLevel() < SimdLevel::AVX2)
+	{
+		m_Error = "The x64 backend needs a CPU with AVX2";
+		return;
+	}
+
+	const Program program = BuildProgram(expression);
+	CodeGenerator generator(program);
+	const std::vector<uint8_t> code = generator.Generate();
+	m_CodeSize = code.size();
+
+	// Write the code to a new page, then make it executable but not writable
+#ifdef _WIN32
+	m_MemorySize = code.size();
+	m_Memory = VirtualAlloc(nullptr, m_MemorySize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (!m_Memory)
+	{
+		m_Error = "Could not allocate executable memory";
+		return;
+	}
+	std::memcpy(m_Memory, code.data(), code.size());
+	DWORD oldProtection;
+	VirtualProtect(m_Memory, m_MemorySize, PAGE_EXECUTE_READ, &oldProtection);
+	FlushInstructionCache(GetCurrentProcess(), m_Memory, m_MemorySize);
+#else
+	m_MemorySize = code.size();
+	m_Memory = mmap(nullptr, m_MemorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (m_Memory == MAP_FAILED)
+	{
+		m_Memory = nullptr;
+		m_Error = "Could not allocate executable memory";
+		return;
+	}
+	std::memcpy(m_Memory, code.data(), code.size());
+	mprotect(m_Memory, m_MemorySize, PROT_READ | PROT_EXEC);
+#endif
+
+	m_Function = reinterpret_cast<Function>(m_Memory);
+
+	auto end = std::chrono::high_resolution_clock::now();
+	m_CompileMicroseconds = std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+X64Kernel::~X64Kernel()
+{
+	if (!m_Memory)
+		return;
+
+#ifdef _WIN32
+	VirtualFree(m_Memory, 0, MEM_RELEASE);
+#else
+	munmap(m_Memory, m_MemorySize);
+#endif
+}
+
+#else
+
+X64Kernel::X64Kernel(const Expression& expression)
+{
+	m_Error = "The x64 backend is only available on x86-64";
+}
+
+X64Kernel::~X64Kernel()
+{
+}
+
+#endif // SIMD_X64
+
+void X64Kernel::EvaluateRow(const void* context, int width, int height, int row, int x0, int count, float sinTime, float cosTime, float* rgb)
+{
+	const X64Kernel& kernel = *static_cast<const X64Kernel*>(context);
+
+	alignas(32) float inputs[4 * PixelCount];
+	alignas(32) float out[3 * PixelCount];
+
+	// Same coordinates as the block functions
+	const float y = 1.0f - (float(row) + 0.5f) / float(height);
+	for (int i = 0; i < PixelCount; i++)
+	{
+		inputs[PixelCount + i] = y;
+		inputs[2 * PixelCount + i] = sinTime;
+		inputs[3 * PixelCount + i] = cosTime;
+	}
+
+	for (int px0 = 0; px0 < count; px0 += PixelCount)
+	{
+		for (int i = 0; i < PixelCount; i++)
+			inputs[i] = (float(x0 + px0 + i) + 0.5f) / float(width);
+
+		kernel.m_Function(inputs, out);
+
+		const int callCount = count - px0 < PixelCount ? count - px0 : PixelCount;
+		for (int i = 0; i < callCount; i++)
+		{
+			rgb[3 * (px0 + i) + 0] = out[i];
+			rgb[3 * (px0 + i) + 1] = out[PixelCount + i];
+			rgb[3 * (px0 + i) + 2] = out[2 * PixelCount + i];
+		}
+	}
+}
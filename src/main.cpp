@@ -5,24 +5,120 @@
 #include <iostream>
 #include <chrono>
 #include <cmath>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <future>
 
 #include "Shader.h"
 #include "Graphics.h"
+#include "FrameCache.h"
+#include "SeedPipeline.h"
+#include "TierStats.h"
 
-int main()
+int main(int argc, char** argv)
 {
 	// Get time at the beginning of the program to use as an initial seed
 	auto now = std::chrono::high_resolution_clock::now();
 	uint64_t timeStart = std::chrono::time_point_cast<std::chrono::microseconds>(now).time_since_epoch().count();
 
-	// Generate the first shader using time as seed
-	uint64_t currentSeed = timeStart;
-	std::string pixelShader = GenerateShaderCode(currentSeed);
-	
+	// Seeds ahead of the current one are generated and compiled on background threads, so that spacebar shows the next one right away
+	// --prefetch 0 generates each seed only when spacebar is pressed
+	int prefetch = 2;
+	int prefetchThreads = 1;
+	// --max-cost C generates seeds whose estimated cost per pixel is over C again, like in PollockRender
+	float maxCost = 0.0f;
+	const char* loopPath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--prefetch") == 0 && i + 1 < argc)
+			prefetch = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--prefetch-threads") == 0 && i + 1 < argc)
+			prefetchThreads = std::atoi(argv[++i]);
+		else if (std::strcmp(argv[i], "--max-cost") == 0 && i + 1 < argc)
+			maxCost = float(std::atof(argv[++i]));
+		else
+			loopPath = argv[i];
+	}
+
+	// A frame cache written by PollockRender --loop can be given on the command line, to play back its frames instead of drawing a shader
+	// Playback blends the keyframes around the current time, so even the most complex seeds run at full frame rate
+	std::unique_ptr<FrameCache> loop;
+	std::vector<uint8_t> loopFrame;
+	if (loopPath)
+	{
+		loop = std::make_unique<FrameCache>(loopPath);
+		if (!loop->IsValid())
+		{
+			std::cout << loop->GetError() << std::endl;
+			return 1;
+		}
+		loopFrame.resize(loop->FrameSize());
+		std::cout << "Playing " << loop->GetKey().frameCount << " frames of seed " << loop->GetKey().seed << std::endl;
+	}
+
 	// Create window and initialize graphics API
-	Graphics graphics(1600, 900, pixelShader.c_str(), int(pixelShader.length()));
-	
+	Graphics graphics(loop ? loop->GetKey().width : 1600, loop ? loop->GetKey().height : 900, SplitShaderCode());
+
+	// Shaders are split in two passes, so that each frame only evaluates the part that depends on time
+	// With tiered compilation, each seed is first drawn with unoptimized shaders (tier 0), which compile quickly,
+	// and the optimized ones (tier 1) replace them between two frames once they are compiled in the background
+	const bool tiered = graphics.HasOptimizedTier();
+
+	// Seeds follow each other from the time at the start, and the pipeline must stop before the graphics it compiles with
+	auto prepare = [&graphics, tiered, maxCost](uint64_t seed) { return graphics.CompilePixelShaders(GenerateSplitShaderCode(seed, maxCost), !tiered); };
+	std::unique_ptr<SeedPipeline<CompiledShaders>> pipeline;
+	if (prefetch > 0)
+		pipeline = std::make_unique<SeedPipeline<CompiledShaders>>(timeStart, SeedPipeline<CompiledShaders>::Unlimited, prefetch, prefetchThreads, prepare);
+
+	// Optimized shaders of the current seed, and those of earlier seeds that were skipped before they were done
+	std::future<CompiledShaders> optimized;
+	std::vector<std::future<CompiledShaders>> abandoned;
+
+	// Time of each tier of the current seed, from the moment it was requested
+	int tier = 0;
+	TierStats tierStats[2];
+	auto requestTime = std::chrono::high_resolution_clock::now();
+	auto printTierStats = [&]()
+	{
+		static const char* const tierNames[2] = { "unoptimized", "optimized" };
+		for (int t = 0; t < 2; t++)
+			if (tierStats[t].frames > 0)
+				std::cout << "  Tier " << t << " (" << tierNames[t] << "): first pixel after " << tierStats[t].firstPixelMilliseconds << " ms, "
+					<< tierStats[t].frames << " frames, " << tierStats[t].AverageFrameMilliseconds() << " ms per frame" << std::endl;
+	};
+
+	// Seed of the shaders shown last, so that the first one is the time at the start
+	uint64_t currentSeed = timeStart - 1;
+	auto frameStart = std::chrono::high_resolution_clock::now();
+	auto showNextSeed = [&]()
+	{
+		CompiledShaders shaders = pipeline ? pipeline->Next(currentSeed) : prepare(++currentSeed);
+		graphics.CreatePixelShaders(shaders);
+
+		printTierStats();
+		PrintShaderSeed(shaders.code);
+		tier = 0;
+		tierStats[0] = TierStats();
+		tierStats[1] = TierStats();
+
+		// Waiting for the optimized shaders of the previous seed would stall this frame
+		if (optimized.valid())
+			abandoned.push_back(std::move(optimized));
+		if (tiered)
+			optimized = std::async(std::launch::async, [&graphics, code = shaders.code]() { return graphics.CompilePixelShaders(code, true); });
+
+		// The time spent switching counts towards the first pixel, but not towards the first frame
+		frameStart = std::chrono::high_resolution_clock::now();
+	};
+
+	// Generate the first shader using time as seed
+	if (!loop)
+		showNextSeed();
+
 	bool pressedKey = false;
+	bool nextRequested = false;
 
 	while (graphics.UpdateInputs())
 	{
@@ -36,16 +132,40 @@ int main()
 		{
 			if (!pressedKey)
 			{
-				// Generate, compile and bind a new pixel shader
-				// Complex shaders might take a few seconds to compile
-				currentSeed = currentTime;
-				std::string newShader = GenerateShaderCode(currentSeed);
-				graphics.CreatePixelShader(newShader.c_str(), int(newShader.length()));
+				nextRequested = true;
+				requestTime = std::chrono::high_resolution_clock::now();
 			}
 			pressedKey = true;
 		}
 		else pressedKey = false;
 
+		// Bind the next pixel shader once it is ready, drawing the current one until then
+		// Without prefetching, complex shaders might take a few seconds to compile
+		// This also ends the playback of a frame cache
+		if (nextRequested && (!pipeline || pipeline->IsNextReady()))
+		{
+			loop.reset();
+			showNextSeed();
+			nextRequested = false;
+		}
+
+		// Swap in the optimized shaders between two frames
+		if (optimized.valid() && optimized.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			graphics.CreatePixelShaders(optimized.get());
+			tier = 1;
+		}
+		std::erase_if(abandoned, [](const std::future<CompiledShaders>& compile) { return compile.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+
+		if (loop)
+		{
+			loop->SampleFrame(elapsedTime, true, loopFrame.data());
+			graphics.PresentFrame(loopFrame.data());
+			graphics.SwapBuffers();
+			frameStart = std::chrono::high_resolution_clock::now();
+			continue;
+		}
+
 		// Calculate sin and cos of time to pass as constant buffers to the shader
 		float sinTime = 0.5f + 0.5f * std::sinf(0.5f * elapsedTime);
 		float cosTime = 0.5f + 0.5f * std::cosf(0.5f * elapsedTime);
@@ -54,8 +174,14 @@ int main()
 		graphics.UpdateConstantBuffer(sinTime, cosTime, 0.0f, 0.0f);
 		graphics.DrawViewportQuad();
 		graphics.SwapBuffers();
+
+		auto frameEnd = std::chrono::high_resolution_clock::now();
+		tierStats[tier].AddFrame(std::chrono::duration<double, std::milli>(frameEnd - requestTime).count(),
+			std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+		frameStart = frameEnd;
 	}
 
+	printTierStats();
 	return 0;
 }
 